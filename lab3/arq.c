@@ -0,0 +1,205 @@
+/******************************************************************************************************************
+ * File name: arq.c
+ * Description : Go-back-N sender and receiver described in arq.h. The functions do not use any peripheral, so they can
+ * also be built on a host computer.
+ * References: [1]Andrew S. Tanenbaum, Computer Networks, 4th edition, section 3.4.2 A Protocol Using Go Back N
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+#include "arq.h"
+
+/***************************************************************************************************************************
+ * Function name : ArqSenderInit()
+ * Inputs : psSender, ui8WindowSize, ui32TimeoutTicks, pfnTransmit
+ * Outputs : none
+ * Description : This function empties the window of psSender. ui8WindowSize is limited to ARQ_MAX_WINDOW. A window of 1
+ * gives stop-and-wait.
+ ***************************************************************************************************************************/
+
+void ArqSenderInit(tArqSender *psSender, uint8_t ui8WindowSize, uint32_t ui32TimeoutTicks, tArqTransmit pfnTransmit)
+{
+    psSender->ui8WindowSize = (ui8WindowSize == 0) ? 1 :
+                              (ui8WindowSize > ARQ_MAX_WINDOW) ? ARQ_MAX_WINDOW : ui8WindowSize;
+    psSender->ui8Base = 0;
+    psSender->ui8Queued = 0;
+    psSender->ui8Sent = 0;
+    psSender->ui8EverSent = 0;
+    psSender->ui32TimeoutTicks = ui32TimeoutTicks;
+    psSender->ui32TimerStart = 0;
+    psSender->ui8Resent = 0;
+    psSender->pfnTransmit = pfnTransmit;
+    psSender->ui32FramesAcked = 0;
+    psSender->ui32Retransmissions = 0;
+    psSender->ui32Timeouts = 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : ArqSend()
+ * Inputs : psSender, psFrame, ui32Now
+ * Outputs : true if the frame was added to the window, false if the window is full
+ * Description : This function gives psFrame the next sequence number, copies it to the window and sends it if the
+ * transmitter has room. The caller may reuse psFrame afterwards.
+ ***************************************************************************************************************************/
+
+bool ArqSend(tArqSender *psSender, const tFrame *psFrame, uint32_t ui32Now)
+{
+    uint8_t ui8Sequence;
+    tFrame *psSlot;
+
+    if(psSender->ui8Queued >= psSender->ui8WindowSize)
+    {
+        return false;
+    }
+
+    ui8Sequence = (psSender->ui8Base + psSender->ui8Queued) & FRAME_SEQUENCE_MASK;
+    psSlot = &psSender->psWindow[ui8Sequence & (ARQ_MAX_WINDOW - 1)];
+    *psSlot = *psFrame;
+    psSlot->ui8Sequence = ui8Sequence;
+    psSender->ui8Queued++;
+
+    ArqService(psSender, ui32Now);
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : ArqService()
+ * Inputs : psSender, ui32Now
+ * Outputs : none
+ * Description : This function is called regularly by the sender. If the oldest frame has not been acknowledged within the
+ * timeout, all frames of the window are marked as not sent (go back N). Then the frames that have not been sent are sent
+ * in order until the transmitter has no more room. The timer starts when the oldest frame of the window is sent.
+ ***************************************************************************************************************************/
+
+void ArqService(tArqSender *psSender, uint32_t ui32Now)
+{
+    const tFrame *psFrame;
+    uint8_t ui8Slot;
+
+    if(psSender->ui8Sent != 0 && ui32Now - psSender->ui32TimerStart >= psSender->ui32TimeoutTicks)
+    {
+        psSender->ui32Timeouts++;
+        psSender->ui8Sent = 0;
+    }
+
+    while(psSender->ui8Sent < psSender->ui8Queued)
+    {
+        ui8Slot = (psSender->ui8Base + psSender->ui8Sent) & (ARQ_MAX_WINDOW - 1);
+        psFrame = &psSender->psWindow[ui8Slot];
+        if(!psSender->pfnTransmit(psFrame))
+        {
+            break;
+        }
+        if(psSender->ui8Sent == 0)
+        {
+            psSender->ui32TimerStart = ui32Now;
+        }
+        if(psSender->ui8Sent < psSender->ui8EverSent)
+        {
+            psSender->ui32Retransmissions++;
+            psSender->ui8Resent |= 1 << ui8Slot;
+        }
+        else
+        {
+            psSender->pui32SendTime[ui8Slot] = ui32Now;
+            psSender->ui8Resent &= ~(1 << ui8Slot);
+        }
+        psSender->ui8Sent++;
+        if(psSender->ui8EverSent < psSender->ui8Sent)
+        {
+            psSender->ui8EverSent = psSender->ui8Sent;
+        }
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : ArqAckReceived()
+ * Inputs : psSender, ui8Sequence, ui32Now, pui32RoundTrip
+ * Outputs : number of frames removed from the window
+ * Description : This function handles an acknowledgement of all frames up to sequence number ui8Sequence. The frames are
+ * removed from the window and the timer restarts for the next frame. An acknowledgement of a frame that has not been sent,
+ * or of a frame that has already been acknowledged, is ignored. If pui32RoundTrip is not 0, *pui32RoundTrip is set to the
+ * time since the first transmission of frame ui8Sequence, or to 0 if the frame has been sent more than once or the
+ * acknowledgement is ignored.
+ ***************************************************************************************************************************/
+
+uint32_t ArqAckReceived(tArqSender *psSender, uint8_t ui8Sequence, uint32_t ui32Now, uint32_t *pui32RoundTrip)
+{
+    uint8_t ui8Acked = (ui8Sequence + 1 - psSender->ui8Base) & FRAME_SEQUENCE_MASK;
+    uint8_t ui8Slot = ui8Sequence & (ARQ_MAX_WINDOW - 1);
+
+    if(pui32RoundTrip != 0)
+    {
+        *pui32RoundTrip = 0;
+    }
+    if(ui8Acked == 0 || ui8Acked > psSender->ui8EverSent)
+    {
+        return 0;
+    }
+    if(pui32RoundTrip != 0 && (psSender->ui8Resent & (1 << ui8Slot)) == 0)
+    {
+        *pui32RoundTrip = ui32Now - psSender->pui32SendTime[ui8Slot];
+    }
+
+    psSender->ui8Base = (psSender->ui8Base + ui8Acked) & FRAME_SEQUENCE_MASK;
+    psSender->ui8Queued -= ui8Acked;
+    psSender->ui8EverSent -= ui8Acked;
+    psSender->ui8Sent = (psSender->ui8Sent > ui8Acked) ? psSender->ui8Sent - ui8Acked : 0;
+    psSender->ui32TimerStart = ui32Now;
+    psSender->ui32FramesAcked += ui8Acked;
+    return ui8Acked;
+}
+
+/***************************************************************************************************************************
+ * Function name : ArqReceiverInit()
+ * Inputs : psReceiver
+ * Outputs : none
+ * Description : This function sets up psReceiver to expect sequence number 0 first.
+ ***************************************************************************************************************************/
+
+void ArqReceiverInit(tArqReceiver *psReceiver)
+{
+    psReceiver->ui8Expected = 0;
+    psReceiver->ui32FramesDelivered = 0;
+    psReceiver->ui32Duplicates = 0;
+    psReceiver->ui32OutOfOrder = 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : ArqReceive()
+ * Inputs : psReceiver, psFrame, psAck
+ * Outputs : true if psFrame is the next frame in order and has to be delivered
+ * Description : This function checks the sequence number of a received frame. Frames that have been received before
+ * (sequence numbers up to half the sequence space behind the expected one) and frames that follow a lost frame are
+ * dropped. In every case psAck is set to the acknowledgement of the last frame received in order, which the caller sends
+ * back, so that a lost acknowledgement is repeated by the next one. The acknowledgement carries the address of psFrame,
+ * which is the address of the receiving node.
+ ***************************************************************************************************************************/
+
+bool ArqReceive(tArqReceiver *psReceiver, const tFrame *psFrame, tFrame *psAck)
+{
+    uint8_t ui8Distance = (psFrame->ui8Sequence - psReceiver->ui8Expected) & FRAME_SEQUENCE_MASK;
+    bool bDeliver = false;
+
+    if(ui8Distance == 0)
+    {
+        psReceiver->ui8Expected = (psReceiver->ui8Expected + 1) & FRAME_SEQUENCE_MASK;
+        psReceiver->ui32FramesDelivered++;
+        bDeliver = true;
+    }
+    else if(ui8Distance > FRAME_SEQUENCE_MASK/2)
+    {
+        psReceiver->ui32Duplicates++;
+    }
+    else
+    {
+        psReceiver->ui32OutOfOrder++;
+    }
+
+    psAck->ui8Type = FRAME_TYPE_ACK;
+    psAck->ui8Sequence = (psReceiver->ui8Expected - 1) & FRAME_SEQUENCE_MASK;
+    psAck->ui8Address = psFrame->ui8Address;
+    psAck->ui8Length = 0;
+    return bDeliver;
+}
@@ -0,0 +1,71 @@
+/******************************************************************************************************************
+ * File name: arq.h
+ * Description : Sliding window retransmission (go-back-N ARQ) on top of the frames of frame.h.
+ *
+ * The sender numbers the frames it sends with the 4 bit sequence number of the frame header and keeps up to
+ * ui8WindowSize frames that have not been acknowledged yet. The receiver accepts only the frame with the next expected
+ * sequence number and answers every frame it gets with an acknowledgement frame carrying the sequence number of the last
+ * frame it accepted in order, so one acknowledgement confirms all frames up to that one (cumulative acknowledgement).
+ * Frames that arrive twice or after a lost frame are dropped by the receiver. If the oldest unacknowledged frame is not
+ * acknowledged within ui32TimeoutTicks, the sender sends it and all frames after it again.
+ *
+ * The window must be smaller than the 16 sequence numbers, so that an old acknowledgement is never taken for a new one.
+ * The functions do not use any peripheral. Frames are sent through the pfnTransmit function given to ArqSenderInit(),
+ * and the time is passed in ticks by the caller. The sender also measures the round trip time from the first
+ * transmission of a frame to its acknowledgement, for frames that have not been sent again (Karn's algorithm).
+ *********************************************************************************************************************/
+
+#ifndef ARQ_H_
+#define ARQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+
+/*Largest window of the sender. Must be a power of two that divides FRAME_SEQUENCE_MASK + 1, so that the window slot
+ * of a frame is the low bits of its sequence number*/
+#define ARQ_MAX_WINDOW          8
+
+/*Function that queues an encoded frame for transmission. Returns false if there is no room for the frame*/
+typedef bool (*tArqTransmit)(const tFrame *psFrame);
+
+/*State of the sender. The frames in the window are, from the oldest, ui8Sent frames that have been sent since the last
+ * acknowledgement or timeout and ui8Queued - ui8Sent frames that still have to be sent. ui8EverSent counts the frames in
+ * the window that have been sent at least once, to tell retransmissions apart. pui32SendTime holds the time of the first
+ * transmission of the frame in every window slot, and bit n of ui8Resent is set when the frame in slot n has been sent
+ * again*/
+typedef struct
+{
+    tFrame psWindow[ARQ_MAX_WINDOW];
+    uint8_t ui8WindowSize;
+    uint8_t ui8Base;
+    uint8_t ui8Queued;
+    uint8_t ui8Sent;
+    uint8_t ui8EverSent;
+    uint32_t ui32TimeoutTicks;
+    uint32_t ui32TimerStart;
+    uint32_t pui32SendTime[ARQ_MAX_WINDOW];
+    uint8_t ui8Resent;
+    tArqTransmit pfnTransmit;
+    uint32_t ui32FramesAcked;
+    uint32_t ui32Retransmissions;
+    uint32_t ui32Timeouts;
+} tArqSender;
+
+/*State of the receiver*/
+typedef struct
+{
+    uint8_t ui8Expected;
+    uint32_t ui32FramesDelivered;
+    uint32_t ui32Duplicates;
+    uint32_t ui32OutOfOrder;
+} tArqReceiver;
+
+void ArqSenderInit(tArqSender *psSender, uint8_t ui8WindowSize, uint32_t ui32TimeoutTicks, tArqTransmit pfnTransmit);
+bool ArqSend(tArqSender *psSender, const tFrame *psFrame, uint32_t ui32Now);
+void ArqService(tArqSender *psSender, uint32_t ui32Now);
+uint32_t ArqAckReceived(tArqSender *psSender, uint8_t ui8Sequence, uint32_t ui32Now, uint32_t *pui32RoundTrip);
+void ArqReceiverInit(tArqReceiver *psReceiver);
+bool ArqReceive(tArqReceiver *psReceiver, const tFrame *psFrame, tFrame *psAck);
+
+#endif /* ARQ_H_ */
@@ -0,0 +1,355 @@
+/******************************************************************************************************************
+ * File name: frame.c
+ * Description : Encoder and decoder of the framed binary protocol described in frame.h. The functions do not use any
+ * peripheral, so they can also be built on a host computer.
+ * References: [1]Stuart Cheshire and Mary Baker, Consistent Overhead Byte Stuffing, IEEE/ACM Transactions on
+ *                Networking, Vol. 7, No. 2, April 1999
+ *             [2]CRC-8 with polynomial 0x07 as used in the ATM header error control, ITU-T I.432.1
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+
+/*Value XORed with the CRC, as in the ATM header error control[2]*/
+#define CRC8_OUTPUT_XOR     0x55
+
+/*CRC-8 of every byte value for the polynomial x^8 + x^2 + x + 1 (0x07)[2]. The CRC of a message is found one byte at a
+ * time with crc = pui8CRC8Table[crc ^ byte]*/
+static const uint8_t pui8CRC8Table[256] =
+{
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3
+};
+
+/***************************************************************************************************************************
+ * Function name : FrameCRC8()
+ * Inputs : pui8Data, ui32Length
+ * Outputs : CRC-8 of the ui32Length bytes at pui8Data
+ * Description : The CRC is XORed with CRC8_OUTPUT_XOR like the ATM header error control[2]. Without it the CRC of a message
+ * followed by its CRC is 0, so a frame that gains a 0x00 byte at the end, which is what a corrupted delimiter turns into
+ * after COBS decoding, would still pass the check.
+ ***************************************************************************************************************************/
+
+uint8_t FrameCRC8(const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint8_t ui8CRC = 0;
+
+    while(ui32Length--)
+    {
+        ui8CRC = pui8CRC8Table[ui8CRC ^ *pui8Data++];
+    }
+    return ui8CRC ^ CRC8_OUTPUT_XOR;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameEncode()
+ * Inputs : psFrame, pui8Encoded
+ * Outputs : number of bytes written to pui8Encoded, at most FRAME_MAX_ENCODED
+ * Description : This function builds the header, payload and CRC of psFrame and COBS encodes them[1] into pui8Encoded,
+ * followed by the delimiter. COBS replaces every 0x00 byte by the distance to the next 0x00 byte, and the first byte of the
+ * output holds the distance to the first 0x00 byte. Frames are shorter than 254 bytes, so no further code bytes are needed.
+ ***************************************************************************************************************************/
+
+uint32_t FrameEncode(const tFrame *psFrame, uint8_t *pui8Encoded)
+{
+    uint8_t pui8Raw[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    uint32_t ui32RawLength, ui32Index, ui32Out, ui32Code;
+    uint8_t ui8Length = (psFrame->ui8Length > FRAME_MAX_PAYLOAD) ? FRAME_MAX_PAYLOAD : psFrame->ui8Length;
+
+    /*header, address, payload and CRC*/
+    pui8Raw[0] = (psFrame->ui8Type << 4) | (psFrame->ui8Sequence & FRAME_SEQUENCE_MASK);
+    pui8Raw[1] = psFrame->ui8Address;
+    for(ui32Index = 0; ui32Index < ui8Length; ui32Index++)
+    {
+        pui8Raw[ui32Index + 2] = psFrame->pui8Payload[ui32Index];
+    }
+    ui32RawLength = ui8Length + 2;
+    pui8Raw[ui32RawLength] = FrameCRC8(pui8Raw, ui32RawLength);
+    ui32RawLength++;
+
+    /*COBS: ui32Code is the position of the code byte of the current block*/
+    ui32Code = 0;
+    ui32Out = 1;
+    for(ui32Index = 0; ui32Index < ui32RawLength; ui32Index++)
+    {
+        if(pui8Raw[ui32Index] == 0)
+        {
+            pui8Encoded[ui32Code] = ui32Out - ui32Code;
+            ui32Code = ui32Out++;
+        }
+        else
+        {
+            pui8Encoded[ui32Out++] = pui8Raw[ui32Index];
+        }
+    }
+    pui8Encoded[ui32Code] = ui32Out - ui32Code;
+    pui8Encoded[ui32Out++] = FRAME_DELIMITER;
+
+    return ui32Out;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameDecodeByte()
+ * Inputs : psDecoder, ui8Byte, psFrame
+ * Outputs : true if ui8Byte completed a valid frame, which is then stored in psFrame
+ * Description : This function feeds one received byte to the decoder. Bytes are collected until the delimiter. Then the
+ * COBS encoding is removed, and the frame is accepted if it has a header, an address and a CRC and the CRC matches.
+ ***************************************************************************************************************************/
+
+bool FrameDecodeByte(tFrameDecoder *psDecoder, uint8_t ui8Byte, tFrame *psFrame)
+{
+    uint8_t pui8Raw[FRAME_MAX_ENCODED];
+    uint32_t ui32Index, ui32Raw, ui32Next, ui32Length;
+
+    if(ui8Byte != FRAME_DELIMITER)
+    {
+        if(psDecoder->ui32Length < FRAME_MAX_ENCODED)
+            psDecoder->pui8Buffer[psDecoder->ui32Length++] = ui8Byte;
+        else
+            psDecoder->bOverflow = true;
+        return false;
+    }
+
+    /*A delimiter. Take the collected bytes and start the next frame*/
+    ui32Length = psDecoder->ui32Length;
+    psDecoder->ui32Length = 0;
+    if(ui32Length == 0)
+    {
+        return false;
+    }
+    if(psDecoder->bOverflow)
+    {
+        psDecoder->bOverflow = false;
+        psDecoder->ui32FramingErrors++;
+        return false;
+    }
+
+    /*COBS decoding. ui32Next is the position of the next code byte*/
+    ui32Raw = 0;
+    ui32Next = 0;
+    for(ui32Index = 0; ui32Index < ui32Length; ui32Index++)
+    {
+        if(ui32Index == ui32Next)
+        {
+            if(ui32Index != 0)
+                pui8Raw[ui32Raw++] = 0;
+            ui32Next = ui32Index + psDecoder->pui8Buffer[ui32Index];
+        }
+        else
+        {
+            pui8Raw[ui32Raw++] = psDecoder->pui8Buffer[ui32Index];
+        }
+    }
+    if(ui32Next != ui32Length || ui32Raw < FRAME_OVERHEAD || ui32Raw - FRAME_OVERHEAD > FRAME_MAX_PAYLOAD)
+    {
+        psDecoder->ui32FramingErrors++;
+        return false;
+    }
+    if(FrameCRC8(pui8Raw, ui32Raw - 1) != pui8Raw[ui32Raw - 1])
+    {
+        psDecoder->ui32CRCErrors++;
+        return false;
+    }
+
+    psFrame->ui8Type = pui8Raw[0] >> 4;
+    psFrame->ui8Sequence = pui8Raw[0] & FRAME_SEQUENCE_MASK;
+    psFrame->ui8Address = pui8Raw[1];
+    psFrame->ui8Length = ui32Raw - FRAME_OVERHEAD;
+    for(ui32Index = 0; ui32Index < psFrame->ui8Length; ui32Index++)
+    {
+        psFrame->pui8Payload[ui32Index] = pui8Raw[ui32Index + 2];
+    }
+    psDecoder->ui32FramesDecoded++;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameSetSample()
+ * Inputs : psFrame, ui8Sequence, ui16Sample
+ * Outputs : none
+ * Description : This function fills psFrame with a sample frame carrying the 12 bit ui16Sample. The address is set to
+ * FRAME_ADDRESS_SENDER, and the caller sets the node the frame is for.
+ ***************************************************************************************************************************/
+
+void FrameSetSample(tFrame *psFrame, uint8_t ui8Sequence, uint16_t ui16Sample)
+{
+    psFrame->ui8Type = FRAME_TYPE_SAMPLE;
+    psFrame->ui8Sequence = ui8Sequence & FRAME_SEQUENCE_MASK;
+    psFrame->ui8Address = FRAME_ADDRESS_SENDER;
+    psFrame->ui8Length = 2;
+    psFrame->pui8Payload[0] = (ui16Sample >> 8) & 0x0F;
+    psFrame->pui8Payload[1] = ui16Sample & 0xFF;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameGetSample()
+ * Inputs : psFrame
+ * Outputs : the 12 bit sample carried by the sample frame psFrame
+ ***************************************************************************************************************************/
+
+uint16_t FrameGetSample(const tFrame *psFrame)
+{
+    return ((psFrame->pui8Payload[0] & 0x0F) << 8) | psFrame->pui8Payload[1];
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameSetBatch()
+ * Inputs : psFrame, ui8Sequence, pui16Samples, ui32Count
+ * Outputs : false if ui32Count is 0 or larger than FRAME_MAX_BATCH
+ * Description : This function fills psFrame with a batch frame carrying the ui32Count 12 bit samples at pui16Samples. The
+ * first sample is stored like in a sample frame, and every further sample as the zig-zag encoded difference to the sample
+ * before it in 1 or 2 bytes (frame.h). The address is set to FRAME_ADDRESS_SENDER, and the caller sets the node the frame is
+ * for.
+ ***************************************************************************************************************************/
+
+bool FrameSetBatch(tFrame *psFrame, uint8_t ui8Sequence, const uint16_t *pui16Samples, uint32_t ui32Count)
+{
+    uint32_t ui32Index, ui32Length, ui32ZigZag;
+    int32_t i32Delta;
+
+    if(ui32Count == 0 || ui32Count > FRAME_MAX_BATCH)
+    {
+        return false;
+    }
+
+    psFrame->ui8Type = FRAME_TYPE_BATCH;
+    psFrame->ui8Sequence = ui8Sequence & FRAME_SEQUENCE_MASK;
+    psFrame->ui8Address = FRAME_ADDRESS_SENDER;
+    psFrame->pui8Payload[0] = (pui16Samples[0] >> 8) & 0x0F;
+    psFrame->pui8Payload[1] = pui16Samples[0] & 0xFF;
+    ui32Length = 2;
+
+    for(ui32Index = 1; ui32Index < ui32Count; ui32Index++)
+    {
+        i32Delta = (int32_t)(pui16Samples[ui32Index] & 0x0FFF) - (int32_t)(pui16Samples[ui32Index - 1] & 0x0FFF);
+        ui32ZigZag = ((uint32_t)i32Delta << 1) ^ (uint32_t)(i32Delta >> 31);
+        if(ui32ZigZag < 0x80)
+        {
+            psFrame->pui8Payload[ui32Length++] = ui32ZigZag;
+        }
+        else
+        {
+            psFrame->pui8Payload[ui32Length++] = (ui32ZigZag & 0x7F) | 0x80;
+            psFrame->pui8Payload[ui32Length++] = ui32ZigZag >> 7;
+        }
+    }
+    psFrame->ui8Length = ui32Length;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameGetBatch()
+ * Inputs : psFrame, pui16Samples
+ * Outputs : number of samples stored at pui16Samples, 0 if the batch frame is malformed
+ * Description : This function expands the batch frame psFrame into pui16Samples, which must have room for FRAME_MAX_BATCH
+ * samples.
+ ***************************************************************************************************************************/
+
+uint32_t FrameGetBatch(const tFrame *psFrame, uint16_t *pui16Samples)
+{
+    uint32_t ui32Index = 2, ui32Count = 1, ui32ZigZag;
+    int32_t i32Sample;
+
+    if(psFrame->ui8Length < 2)
+    {
+        return 0;
+    }
+    i32Sample = ((psFrame->pui8Payload[0] & 0x0F) << 8) | psFrame->pui8Payload[1];
+    pui16Samples[0] = i32Sample;
+
+    while(ui32Index < psFrame->ui8Length)
+    {
+        ui32ZigZag = psFrame->pui8Payload[ui32Index++];
+        if(ui32ZigZag & 0x80)
+        {
+            if(ui32Index >= psFrame->ui8Length)
+            {
+                return 0;
+            }
+            ui32ZigZag = (ui32ZigZag & 0x7F) | (psFrame->pui8Payload[ui32Index++] << 7);
+        }
+        i32Sample += (int32_t)(ui32ZigZag >> 1) ^ -(int32_t)(ui32ZigZag & 1);
+        if(i32Sample < 0 || i32Sample > 0x0FFF || ui32Count >= FRAME_MAX_BATCH)
+        {
+            return 0;
+        }
+        pui16Samples[ui32Count++] = i32Sample;
+    }
+    return ui32Count;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameSetLink()
+ * Inputs : psFrame, ui8Command, ui32Parameter
+ * Outputs : none
+ * Description : This function fills psFrame with a link frame carrying the FRAME_LINK_ command ui8Command and its parameter,
+ * sent by the sender.
+ ***************************************************************************************************************************/
+
+void FrameSetLink(tFrame *psFrame, uint8_t ui8Command, uint32_t ui32Parameter)
+{
+    psFrame->ui8Type = FRAME_TYPE_LINK;
+    psFrame->ui8Sequence = 0;
+    psFrame->ui8Address = FRAME_ADDRESS_SENDER;
+    psFrame->ui8Length = FRAME_LINK_LENGTH;
+    psFrame->pui8Payload[0] = ui8Command;
+    psFrame->pui8Payload[1] = ui32Parameter & 0xFF;
+    psFrame->pui8Payload[2] = (ui32Parameter >> 8) & 0xFF;
+    psFrame->pui8Payload[3] = (ui32Parameter >> 16) & 0xFF;
+    psFrame->pui8Payload[4] = ui32Parameter >> 24;
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameGetLinkParameter()
+ * Inputs : psFrame
+ * Outputs : the parameter of the link frame psFrame, 0 if the frame is too short to carry one
+ ***************************************************************************************************************************/
+
+uint32_t FrameGetLinkParameter(const tFrame *psFrame)
+{
+    if(psFrame->ui8Length < FRAME_LINK_LENGTH)
+    {
+        return 0;
+    }
+    return psFrame->pui8Payload[1] | (psFrame->pui8Payload[2] << 8) | (psFrame->pui8Payload[3] << 16) |
+           ((uint32_t)psFrame->pui8Payload[4] << 24);
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameRoute()
+ * Inputs : psFrame, ui8Node
+ * Outputs : what the display node with address ui8Node does with psFrame
+ * Description : Sample, batch and stats frames addressed to the node are delivered to it and link frames are handled by every
+ * node. All other frames, including the acknowledgements of the nodes before it, are passed on. A node that has no address
+ * yet (FRAME_ADDRESS_SENDER) passes on every frame but the link frames.
+ ***************************************************************************************************************************/
+
+tFrameRoute FrameRoute(const tFrame *psFrame, uint8_t ui8Node)
+{
+    if(psFrame->ui8Type == FRAME_TYPE_LINK)
+    {
+        return FRAME_ROUTE_LINK;
+    }
+    if((psFrame->ui8Type == FRAME_TYPE_SAMPLE || psFrame->ui8Type == FRAME_TYPE_BATCH ||
+        psFrame->ui8Type == FRAME_TYPE_STATS) &&
+       ui8Node != FRAME_ADDRESS_SENDER && psFrame->ui8Address == ui8Node)
+    {
+        return FRAME_ROUTE_DELIVER;
+    }
+    return FRAME_ROUTE_FORWARD;
+}
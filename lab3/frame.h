@@ -0,0 +1,122 @@
+/******************************************************************************************************************
+ * File name: frame.h
+ * Description : Framed binary protocol used on the UART link between the sender and the receiver board.
+ *
+ * Frame before encoding:
+ *   byte 0         : header, frame type in bits 7-4 and sequence number in bits 3-0
+ *   byte 1         : address of the display node the frame is for or comes from (see below)
+ *   byte 2 .. n    : payload, 0 to FRAME_MAX_PAYLOAD bytes
+ *   byte n+1       : CRC-8 (polynomial x^8 + x^2 + x + 1, initial value 0, output XOR 0x55) of bytes 0 to n
+ * The frame is then encoded with Consistent Overhead Byte Stuffing (COBS), which removes every 0x00 byte at a cost of
+ * one byte, and terminated with FRAME_DELIMITER (0x00). A receiver that starts listening in the middle of a frame, or
+ * that loses a byte, is in sync again at the next delimiter.
+ *
+ * Frame types:
+ *   FRAME_TYPE_SAMPLE  payload is a 12 bit ADC sample in 2 bytes, bits 11-8 in byte 1 and bits 7-0 in byte 2
+ *   FRAME_TYPE_ACK     no payload, acknowledges all sample frames up to the one with the same sequence number (arq.h)
+ *   FRAME_TYPE_BATCH   up to FRAME_MAX_BATCH consecutive 12 bit samples. The first sample is sent like in a sample
+ *                      frame, and every further sample as the difference to the sample before it. The differences are
+ *                      zig-zag encoded (0, -1, 1, -2, 2 ... become 0, 1, 2, 3, 4 ...) and sent as variable length
+ *                      integers of 7 bits per byte, low bits first, with bit 7 set in every byte but the last. A
+ *                      difference between -64 and 63 takes one byte and any other difference two bytes.
+ *   FRAME_TYPE_LINK    link management, not numbered by the retransmission. Byte 0 of the payload is one of the
+ *                      FRAME_LINK_ commands and bytes 1-4 hold its parameter, low byte first
+ *   FRAME_TYPE_STATS   link statistics, not numbered by the retransmission. Without payload a query of the sender for
+ *                      the statistics of a node, otherwise part of the answer of the node (linkstats.h)
+ * A sample frame takes 7 bytes on the line, so 1645 samples per second fit in the 11520 bytes per second of a 115200
+ * baud link. A batch frame of 8 samples that change by less than 64 between samples takes 14 bytes, 1.75 bytes per
+ * sample.
+ *
+ * Addresses: the sender and one or more display nodes are connected in a ring (daisy chain). The transmit pin of the
+ * sender goes to the receive pin of node 1, node 1 transmits to node 2 and so on, and the last node transmits to the
+ * sender. With one node this is the usual two wire connection. The sender has address FRAME_ADDRESS_SENDER and the nodes
+ * number themselves from 1 during the link set up. Sample, batch and stats query frames carry the node they are for,
+ * and acknowledgements and stats answers the node that sends them. Link frames carry the address of the last node that
+ * passed them on. A node delivers the sample, batch and stats frames addressed to it, handles every link frame and
+ * passes on all other frames unchanged (FrameRoute()), so every frame reaches the sender again after at most one trip around the ring.
+ *********************************************************************************************************************/
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Byte that terminates every encoded frame*/
+#define FRAME_DELIMITER         0x00
+
+/*Largest payload of a frame, size of the header and the CRC, and largest encoded frame including the COBS overhead
+ * byte and the delimiter*/
+#define FRAME_MAX_PAYLOAD       32
+#define FRAME_OVERHEAD          3
+#define FRAME_MAX_ENCODED       (FRAME_MAX_PAYLOAD + FRAME_OVERHEAD + 2)
+
+/*Frame types*/
+#define FRAME_TYPE_SAMPLE       0x1
+#define FRAME_TYPE_ACK          0x2
+#define FRAME_TYPE_BATCH        0x3
+#define FRAME_TYPE_LINK         0x4
+#define FRAME_TYPE_STATS        0x5
+
+/*Commands of link frames and their parameters. All link frames are sent by the sender and come back to it around the
+ * ring*/
+#define FRAME_LINK_REQUEST      1   /*baud rate proposed by the sender, sent at the start rate and lowered by the nodes*/
+#define FRAME_LINK_ACCEPT       2   /*baud rate all nodes have accepted, every node switches after passing it on*/
+#define FRAME_LINK_CONFIRM      3   /*baud rate, sent by the sender at the new rate*/
+#define FRAME_LINK_KEEPALIVE    4   /*none, sent by the sender when idle*/
+#define FRAME_LINK_TEST         5   /*number of the test frame, followed by filler bytes*/
+#define FRAME_LINK_TEST_END     6   /*number of test frames sent*/
+#define FRAME_LINK_LENGTH       5
+
+/*Largest number of samples in a batch frame. The first sample takes 2 bytes and every further sample at most 2*/
+#define FRAME_MAX_BATCH         (FRAME_MAX_PAYLOAD/2)
+
+/*Sequence numbers count from 0 to FRAME_SEQUENCE_MASK and wrap around*/
+#define FRAME_SEQUENCE_MASK     0x0F
+
+/*Address of the sender. Display nodes have the addresses 1 to FRAME_ADDRESS_MAX_NODE*/
+#define FRAME_ADDRESS_SENDER    0
+#define FRAME_ADDRESS_MAX_NODE  254
+
+/*What a display node does with a received frame*/
+typedef enum
+{
+    FRAME_ROUTE_FORWARD,    /*pass it on to the next node*/
+    FRAME_ROUTE_DELIVER,    /*the frame is for this node*/
+    FRAME_ROUTE_LINK        /*link frame, handled by every node and then passed on*/
+} tFrameRoute;
+
+/*A decoded frame*/
+typedef struct
+{
+    uint8_t ui8Type;
+    uint8_t ui8Sequence;
+    uint8_t ui8Address;
+    uint8_t ui8Length;
+    uint8_t pui8Payload[FRAME_MAX_PAYLOAD];
+} tFrame;
+
+/*State of the frame decoder. Bytes are collected in pui8Buffer until a delimiter arrives. Frames that are too long, too
+ * short or fail the CRC check are dropped and counted*/
+typedef struct
+{
+    uint8_t pui8Buffer[FRAME_MAX_ENCODED];
+    uint32_t ui32Length;
+    bool bOverflow;
+    uint32_t ui32FramesDecoded;
+    uint32_t ui32CRCErrors;
+    uint32_t ui32FramingErrors;
+} tFrameDecoder;
+
+uint8_t FrameCRC8(const uint8_t *pui8Data, uint32_t ui32Length);
+uint32_t FrameEncode(const tFrame *psFrame, uint8_t *pui8Encoded);
+bool FrameDecodeByte(tFrameDecoder *psDecoder, uint8_t ui8Byte, tFrame *psFrame);
+void FrameSetSample(tFrame *psFrame, uint8_t ui8Sequence, uint16_t ui16Sample);
+uint16_t FrameGetSample(const tFrame *psFrame);
+bool FrameSetBatch(tFrame *psFrame, uint8_t ui8Sequence, const uint16_t *pui16Samples, uint32_t ui32Count);
+uint32_t FrameGetBatch(const tFrame *psFrame, uint16_t *pui16Samples);
+void FrameSetLink(tFrame *psFrame, uint8_t ui8Command, uint32_t ui32Parameter);
+uint32_t FrameGetLinkParameter(const tFrame *psFrame);
+tFrameRoute FrameRoute(const tFrame *psFrame, uint8_t ui8Node);
+
+#endif /* FRAME_H_ */
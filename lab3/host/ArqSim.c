@@ -0,0 +1,265 @@
+/*********************************************************************************************************************
+ * File name : ArqSim.c
+ * Description : Host simulation of the lab 3 link with the go-back-N retransmission of ../arq.c over a lossy wire. The
+ * sender always has a new batch of samples when its window has room, so the simulation measures what the link can
+ * carry. The samples are a potentiometer sweep with a few codes of noise, sent in batch frames of the given size. Both
+ * directions are modeled like UART4 in main.c: frames are queued in a transmit ring of RING_BUFFER_SIZE bytes plus the
+ * 16 byte FIFO, one byte leaves every 10 bit periods and every byte is passed to the frame decoder of the other board
+ * when it arrives. Every frame, sample or acknowledgement, is corrupted with the given probability by flipping one
+ * random bit. The receiver checks that the samples are delivered in order, without gaps and without repetitions.
+ *
+ * For every loss rate the goodput (samples delivered per second) is printed for stop-and-wait (window 1) and for the
+ * window of main.c. The efficiency is the goodput of the window relative to the samples per second that fit on the line
+ * without retransmissions.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Ilab3 lab3/host/ArqSim.c lab3/arq.c lab3/frame.c -o arq_sim
+ *   ./arq_sim [baud [seconds [batch]]]
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "frame.h"
+#include "arq.h"
+
+/*Settings of main.c*/
+#define TICK_RATE_HZ        1000
+#define RING_BUFFER_SIZE    64
+#define ARQ_WINDOW_SIZE     8
+#define ARQ_TIMEOUT_MS      10
+#define SAMPLE_BATCH_SIZE   8
+
+/*Bytes that can wait for the line in one direction: transmit ring and transmit FIFO*/
+#define WIRE_BYTES          (RING_BUFFER_SIZE + 16)
+
+/*One direction of the link*/
+typedef struct
+{
+    uint8_t data[WIRE_BYTES];
+    uint32_t head, tail;
+    uint32_t framesSent;
+    uint32_t framesCorrupted;
+} tWire;
+
+/*Results of one run*/
+typedef struct
+{
+    uint32_t delivered;
+    uint32_t bytesSent;
+    uint32_t errors;
+    uint32_t retransmissions;
+    uint32_t timeouts;
+    uint32_t framesCorrupted;
+} tResult;
+
+static tWire toReceiver, toSender;
+static double lossRate;
+
+/*xorshift32 pseudo random generator, so that runs are repeatable*/
+static uint32_t randomState = 2463534242u;
+
+static uint32_t Random(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+/***************************************************************************************************************************
+ * Function name : WireTransmit()
+ * Inputs : wire, frame
+ * Outputs : true if the frame was queued, false if the transmit ring has no room for it
+ * Description : This function encodes frame like SendFrame() in main.c and queues it on wire, corrupting it with the
+ * probability lossRate.
+ ***************************************************************************************************************************/
+
+static bool WireTransmit(tWire *wire, const tFrame *frame)
+{
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    uint32_t length = FrameEncode(frame, encoded), i;
+
+    if(WIRE_BYTES - (wire->head - wire->tail) < length)
+    {
+        return false;
+    }
+    if(Random() < lossRate*4294967296.0)
+    {
+        uint32_t bit = Random() % (length*8);
+        encoded[bit/8] ^= 1 << (bit%8);
+        wire->framesCorrupted++;
+    }
+    for(i = 0; i < length; i++)
+    {
+        wire->data[wire->head++ % WIRE_BYTES] = encoded[i];
+    }
+    wire->framesSent++;
+    return true;
+}
+
+static bool SenderTransmit(const tFrame *frame)
+{
+    return WireTransmit(&toReceiver, frame);
+}
+
+static bool ReceiverTransmit(const tFrame *frame)
+{
+    return WireTransmit(&toSender, frame);
+}
+
+/***************************************************************************************************************************
+ * Function name : WireReceive()
+ * Inputs : wire, byte
+ * Outputs : true if a byte left the wire, which is then stored in *byte
+ ***************************************************************************************************************************/
+
+static bool WireReceive(tWire *wire, uint8_t *byte)
+{
+    if(wire->head == wire->tail)
+    {
+        return false;
+    }
+    *byte = wire->data[wire->tail++ % WIRE_BYTES];
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : SignalSample()
+ * Inputs : n
+ * Outputs : sample n of the potentiometer signal
+ * Description : The signal sweeps the full range up and down in 8190 samples, with up to 3 codes of noise taken from a
+ * hash of n, so that the receiver can compute the sample it expects.
+ ***************************************************************************************************************************/
+
+static uint16_t SignalSample(uint32_t n)
+{
+    uint32_t hash = n*2654435761u;
+    int32_t sample = (n*2) % 8190, noise = (int32_t)((hash >> 16) % 7) - 3;
+
+    if(sample > 4095)
+        sample = 8190 - sample;
+    sample += noise;
+    return (sample < 0) ? 0 : (sample > 4095) ? 4095 : sample;
+}
+
+/***************************************************************************************************************************
+ * Function name : Run()
+ * Inputs : baud, seconds, window, batch, result
+ * Outputs : none
+ * Description : This function simulates the link for seconds seconds with a sender window of window frames and batch
+ * samples per frame.
+ ***************************************************************************************************************************/
+
+static void Run(uint32_t baud, double seconds, uint8_t window, uint32_t batch, tResult *result)
+{
+    tArqSender sender;
+    tArqReceiver receiver;
+    tFrameDecoder senderDecoder, receiverDecoder;
+    tFrame frame, ack;
+    uint64_t byteTimes = (uint64_t)(seconds*baud/10), t;
+    uint32_t nextSample = 0, expectedSample = 0, now, count, i;
+    uint16_t samples[FRAME_MAX_BATCH];
+    uint8_t byte;
+
+    memset(&toReceiver, 0, sizeof(toReceiver));
+    memset(&toSender, 0, sizeof(toSender));
+    memset(&senderDecoder, 0, sizeof(senderDecoder));
+    memset(&receiverDecoder, 0, sizeof(receiverDecoder));
+    memset(result, 0, sizeof(*result));
+    ArqSenderInit(&sender, window, ARQ_TIMEOUT_MS*TICK_RATE_HZ/1000, SenderTransmit);
+    ArqReceiverInit(&receiver);
+
+    for(t = 0; t < byteTimes; t++)
+    {
+        /*SysTick count of the sender*/
+        now = (uint32_t)(t*10*TICK_RATE_HZ/baud);
+
+        /*the sender fills its window with new batches and services retransmissions*/
+        while(1)
+        {
+            for(i = 0; i < batch; i++)
+            {
+                samples[i] = SignalSample(nextSample + i);
+            }
+            FrameSetBatch(&frame, 0, samples, batch);
+            if(!ArqSend(&sender, &frame, now))
+                break;
+            nextSample += batch;
+        }
+        ArqService(&sender, now);
+
+        /*one byte arrives at the receiver, which delivers and acknowledges like ReceiverBoard()*/
+        if(WireReceive(&toReceiver, &byte) && FrameDecodeByte(&receiverDecoder, byte, &frame) &&
+           frame.ui8Type == FRAME_TYPE_BATCH)
+        {
+            if(ArqReceive(&receiver, &frame, &ack))
+            {
+                count = FrameGetBatch(&frame, samples);
+                if(count != batch)
+                    result->errors++;
+                for(i = 0; i < count; i++)
+                {
+                    if(samples[i] != SignalSample(expectedSample + i))
+                        result->errors++;
+                }
+                expectedSample += count;
+                result->delivered += count;
+            }
+            ReceiverTransmit(&ack);
+        }
+
+        /*one byte arrives at the sender*/
+        if(WireReceive(&toSender, &byte) && FrameDecodeByte(&senderDecoder, byte, &frame) &&
+           frame.ui8Type == FRAME_TYPE_ACK)
+        {
+            ArqAckReceived(&sender, frame.ui8Sequence, now, NULL);
+        }
+    }
+
+    result->retransmissions = sender.ui32Retransmissions;
+    result->timeouts = sender.ui32Timeouts;
+    result->framesCorrupted = toReceiver.framesCorrupted + toSender.framesCorrupted;
+    result->bytesSent = toReceiver.head;
+}
+
+int main(int argc, char *argv[])
+{
+    static const double lossRates[] = {0.0, 0.001, 0.01, 0.02, 0.05, 0.1, 0.2, 0.3};
+    uint32_t baud = (argc > 1) ? strtoul(argv[1], NULL, 0) : 115200;
+    double seconds = (argc > 2) ? atof(argv[2]) : 20.0;
+    uint32_t batch = (argc > 3) ? strtoul(argv[3], NULL, 0) : SAMPLE_BATCH_SIZE;
+    double lineRate;
+    tResult stopAndWait, windowed;
+    uint32_t i, errors = 0;
+
+    if(batch < 1 || batch > FRAME_MAX_BATCH)
+    {
+        fprintf(stderr, "batch must be 1 to %d\n", FRAME_MAX_BATCH);
+        return 2;
+    }
+
+    /*bytes per sample on the line without losses*/
+    lossRate = 0;
+    Run(baud, seconds, ARQ_WINDOW_SIZE, batch, &windowed);
+    lineRate = baud/10.0/((double)windowed.bytesSent/windowed.delivered);
+
+    printf("%u baud, %.0f s, batch %u, window %d, timeout %d ms, %.2f bytes/sample, line limit %.0f samples/s\n", baud,
+           seconds, batch, ARQ_WINDOW_SIZE, ARQ_TIMEOUT_MS, (double)windowed.bytesSent/windowed.delivered, lineRate);
+    printf(" loss   stop-and-wait samples/s    window %d samples/s   efficiency  retransmitted  timeouts\n",
+           ARQ_WINDOW_SIZE);
+    for(i = 0; i < sizeof(lossRates)/sizeof(lossRates[0]); i++)
+    {
+        lossRate = lossRates[i];
+        Run(baud, seconds, 1, batch, &stopAndWait);
+        Run(baud, seconds, ARQ_WINDOW_SIZE, batch, &windowed);
+        printf("%5.1f%%  %24.0f  %20.0f  %10.1f%%  %13u  %8u\n", lossRate*100, stopAndWait.delivered/seconds,
+               windowed.delivered/seconds, 100.0*windowed.delivered/seconds/lineRate, windowed.retransmissions,
+               windowed.timeouts);
+        errors += stopAndWait.errors + windowed.errors;
+    }
+    printf("samples delivered out of order or repeated: %u\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,305 @@
+/*********************************************************************************************************************
+ * File name : ChainSim.c
+ * Description : Host simulation of a ring (daisy chain) of lab 3 boards: the sender and 1 to CHAIN_MAX_NODES display
+ * nodes, connected like in main.c. Every connection is modeled like UART4: frames are queued in a transmit ring of
+ * RING_BUFFER_SIZE bytes plus the 16 byte FIFO and one byte leaves every 10 bit periods. A node passes on every frame
+ * that FrameRoute() (../frame.c) does not deliver to it NODE_DELAY_US after its last byte has arrived, which covers the
+ * main loop, the decoding and the encoding on the board. The link set up is not simulated; the nodes have their
+ * addresses and the rate from the start.
+ *
+ * The sender makes a batch of SAMPLE_BATCH_SIZE samples every SAMPLE_BATCH_SIZE ms, the case of a potentiometer that
+ * never rests, and sends it to every node with the go-back-N retransmission of ../arq.c, one window per node. For every
+ * node the time from the batch being made to its delivery at the node (latency) and to the acknowledgement arriving back
+ * at the sender (round trip) is measured. The latency to node k grows by one hop, one frame time plus NODE_DELAY_US, per
+ * node before it, and the round trip is one trip around the ring for every node. The nodes check that the samples arrive
+ * in order, without gaps and without repetitions.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Ilab3 lab3/host/ChainSim.c lab3/arq.c lab3/frame.c -o chain_sim
+ *   ./chain_sim [baud [seconds]]
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "frame.h"
+#include "arq.h"
+
+/*Settings of main.c*/
+#define TICK_RATE_HZ        1000
+#define RING_BUFFER_SIZE    256
+#define ARQ_WINDOW_SIZE     8
+#define ARQ_TIMEOUT_MS      10
+#define ARQ_HOP_TIMEOUT_MS  3
+#define SAMPLE_BATCH_SIZE   8
+#define CHAIN_MAX_NODES     8
+
+/*Time a node needs to pass on a frame after its last byte has arrived*/
+#define NODE_DELAY_US       10
+
+/*Bytes that can wait for the line on one connection: transmit ring and transmit FIFO*/
+#define WIRE_BYTES          (RING_BUFFER_SIZE + 16)
+
+/*Frames a node can hold between receiving and passing them on*/
+#define NODE_QUEUE          32
+
+/*Longest simulation, in batches*/
+#define MAX_BATCHES         100000
+
+/*One connection, from board i to board i + 1. Board 0 is the sender, and the last node sends to the sender*/
+typedef struct
+{
+    uint8_t data[WIRE_BYTES];
+    uint32_t head, tail;
+} tWire;
+
+/*State of a display node*/
+typedef struct
+{
+    tFrameDecoder decoder;
+    tArqReceiver receiver;
+    tFrame queue[NODE_QUEUE];
+    uint64_t queueReady[NODE_QUEUE];
+    uint32_t queueHead, queueTail;
+    uint32_t delivered;
+    uint32_t errors;
+    uint32_t overflows;
+    double latencySum, latencyMax;
+} tNode;
+
+/*Results for one node*/
+typedef struct
+{
+    double latency, latencyMax, roundTrip, roundTripMax;
+    uint32_t delivered;
+} tNodeResult;
+
+static tWire wires[CHAIN_MAX_NODES + 1];
+static tNode nodes[CHAIN_MAX_NODES];
+static tArqSender senders[CHAIN_MAX_NODES];
+static uint64_t batchTime[MAX_BATCHES];
+
+static bool WireTransmit(tWire *wire, const tFrame *frame)
+{
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    uint32_t length = FrameEncode(frame, encoded), i;
+
+    if(WIRE_BYTES - (wire->head - wire->tail) < length)
+    {
+        return false;
+    }
+    for(i = 0; i < length; i++)
+    {
+        wire->data[wire->head++ % WIRE_BYTES] = encoded[i];
+    }
+    return true;
+}
+
+static bool WireReceive(tWire *wire, uint8_t *byte)
+{
+    if(wire->head == wire->tail)
+    {
+        return false;
+    }
+    *byte = wire->data[wire->tail++ % WIRE_BYTES];
+    return true;
+}
+
+/*The sender transmits all windows on the connection to node 1*/
+static bool SenderTransmit(const tFrame *frame)
+{
+    return WireTransmit(&wires[0], frame);
+}
+
+/*Sample n of the potentiometer, a sweep up and down with a few codes of noise, as in ArqSim.c*/
+static uint16_t SignalSample(uint32_t n)
+{
+    uint32_t hash = n*2654435761u;
+    int32_t sample = (n*2) % 8190, noise = (int32_t)((hash >> 16) % 7) - 3;
+
+    if(sample > 4095)
+        sample = 8190 - sample;
+    sample += noise;
+    return (sample < 0) ? 0 : (sample > 4095) ? 4095 : sample;
+}
+
+/***************************************************************************************************************************
+ * Function name : Run()
+ * Inputs : baud, seconds, nodeCount, results
+ * Outputs : number of samples delivered out of order or wrong
+ * Description : This function simulates a ring of nodeCount nodes for seconds seconds and stores the latency and round
+ * trip of every node in results. Time advances in byte times.
+ ***************************************************************************************************************************/
+
+static uint32_t Run(uint32_t baud, double seconds, uint32_t nodeCount, tNodeResult *results)
+{
+    uint64_t byteTimes = (uint64_t)(seconds*baud/10), t, delay = (NODE_DELAY_US*(uint64_t)baud + 9999999)/10000000;
+    uint32_t batches = 0, acked[CHAIN_MAX_NODES], now, i, k, count, errors = 0;
+    double roundTripSum[CHAIN_MAX_NODES], roundTripMax[CHAIN_MAX_NODES], value;
+    uint16_t samples[FRAME_MAX_BATCH];
+    tFrame frame, ack;
+    tFrameDecoder senderDecoder;
+    uint8_t byte;
+
+    memset(wires, 0, sizeof(wires));
+    memset(nodes, 0, sizeof(nodes));
+    memset(&senderDecoder, 0, sizeof(senderDecoder));
+    memset(acked, 0, sizeof(acked));
+    memset(roundTripSum, 0, sizeof(roundTripSum));
+    memset(roundTripMax, 0, sizeof(roundTripMax));
+    for(k = 0; k < nodeCount; k++)
+    {
+        ArqSenderInit(&senders[k], ARQ_WINDOW_SIZE,
+                      (ARQ_TIMEOUT_MS + (nodeCount - 1)*ARQ_HOP_TIMEOUT_MS)*TICK_RATE_HZ/1000, SenderTransmit);
+        ArqReceiverInit(&nodes[k].receiver);
+    }
+
+    for(t = 0; t < byteTimes; t++)
+    {
+        /*SysTick count of the sender*/
+        now = (uint32_t)(t*10*TICK_RATE_HZ/baud);
+
+        /*a new batch for every node every SAMPLE_BATCH_SIZE ms, unless a window is full (SendToReceiver() in main.c)*/
+        if(t*10*1000/baud >= (uint64_t)(batches + 1)*SAMPLE_BATCH_SIZE && batches < MAX_BATCHES)
+        {
+            for(k = 0; k < nodeCount && senders[k].ui8Queued < senders[k].ui8WindowSize; k++)
+            {
+            }
+            if(k == nodeCount)
+            {
+                for(i = 0; i < SAMPLE_BATCH_SIZE; i++)
+                {
+                    samples[i] = SignalSample(batches*SAMPLE_BATCH_SIZE + i);
+                }
+                FrameSetBatch(&frame, 0, samples, SAMPLE_BATCH_SIZE);
+                batchTime[batches++] = t;
+                for(k = 0; k < nodeCount; k++)
+                {
+                    frame.ui8Address = k + 1;
+                    ArqSend(&senders[k], &frame, now);
+                }
+            }
+        }
+        for(k = 0; k < nodeCount; k++)
+        {
+            ArqService(&senders[k], now);
+        }
+
+        /*one byte arrives at every node. Frames for the node are delivered and acknowledged, the others are queued to be
+         * passed on*/
+        for(k = 0; k < nodeCount; k++)
+        {
+            tNode *node = &nodes[k];
+
+            if(!WireReceive(&wires[k], &byte) || !FrameDecodeByte(&node->decoder, byte, &frame))
+            {
+                continue;
+            }
+            if(FrameRoute(&frame, k + 1) == FRAME_ROUTE_DELIVER)
+            {
+                if(ArqReceive(&node->receiver, &frame, &ack))
+                {
+                    count = FrameGetBatch(&frame, samples);
+                    for(i = 0; i < count; i++)
+                    {
+                        if(samples[i] != SignalSample(node->delivered*SAMPLE_BATCH_SIZE + i))
+                            errors++;
+                    }
+                    value = (double)(t - batchTime[node->delivered])*10e6/baud;
+                    node->latencySum += value;
+                    if(value > node->latencyMax)
+                        node->latencyMax = value;
+                    node->delivered++;
+                }
+                frame = ack;
+            }
+            if(node->queueHead - node->queueTail < NODE_QUEUE)
+            {
+                node->queue[node->queueHead % NODE_QUEUE] = frame;
+                node->queueReady[node->queueHead % NODE_QUEUE] = t + delay;
+                node->queueHead++;
+            }
+            else
+            {
+                node->overflows++;
+            }
+        }
+
+        /*every node passes on the frames it has finished*/
+        for(k = 0; k < nodeCount; k++)
+        {
+            tNode *node = &nodes[k];
+
+            while(node->queueHead != node->queueTail && node->queueReady[node->queueTail % NODE_QUEUE] <= t)
+            {
+                if(!WireTransmit(&wires[k + 1], &node->queue[node->queueTail % NODE_QUEUE]))
+                {
+                    node->overflows++;
+                }
+                node->queueTail++;
+            }
+        }
+
+        /*one byte arrives back at the sender*/
+        if(WireReceive(&wires[nodeCount], &byte) && FrameDecodeByte(&senderDecoder, byte, &frame) &&
+           frame.ui8Type == FRAME_TYPE_ACK && frame.ui8Address >= 1 && frame.ui8Address <= nodeCount)
+        {
+            k = frame.ui8Address - 1;
+            count = ArqAckReceived(&senders[k], frame.ui8Sequence, now, NULL);
+            if(count != 0)
+            {
+                acked[k] += count;
+                value = (double)(t - batchTime[acked[k] - 1])*10e6/baud;
+                roundTripSum[k] += value;
+                if(value > roundTripMax[k])
+                    roundTripMax[k] = value;
+            }
+        }
+    }
+
+    for(k = 0; k < nodeCount; k++)
+    {
+        results[k].delivered = nodes[k].delivered;
+        results[k].latency = nodes[k].delivered ? nodes[k].latencySum/nodes[k].delivered : 0;
+        results[k].latencyMax = nodes[k].latencyMax;
+        results[k].roundTrip = acked[k] ? roundTripSum[k]/acked[k] : 0;
+        results[k].roundTripMax = roundTripMax[k];
+        if(nodes[k].delivered + 2*ARQ_WINDOW_SIZE < batches || nodes[k].overflows != 0)
+            errors++;
+    }
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint32_t nodeCounts[] = {1, 2, 3, 4, 6, 8};
+    uint32_t baud = (argc > 1) ? strtoul(argv[1], NULL, 0) : 115200;
+    double seconds = (argc > 2) ? atof(argv[2]) : 10.0;
+    tNodeResult results[CHAIN_MAX_NODES];
+    uint32_t i, k, n, errors = 0;
+
+    printf("%u baud, %.0f s, a batch of %d samples to every node every %d ms, node delay %d us\n", baud, seconds,
+           SAMPLE_BATCH_SIZE, SAMPLE_BATCH_SIZE, NODE_DELAY_US);
+    printf(" nodes  latency node 1  latency last node  per hop  round trip   max round trip  batches/node\n");
+    for(i = 0; i < sizeof(nodeCounts)/sizeof(nodeCounts[0]); i++)
+    {
+        n = nodeCounts[i];
+        errors += Run(baud, seconds, n, results);
+        printf(" %5u  %11.0fus  %14.0fus  %5.0fus  %8.0fus  %13.0fus  %12u\n", n, results[0].latency,
+               results[n - 1].latency, (n > 1) ? (results[n - 1].latency - results[0].latency)/(n - 1) : 0.0,
+               results[n - 1].roundTrip, results[n - 1].roundTripMax, results[n - 1].delivered);
+    }
+
+    n = CHAIN_MAX_NODES;
+    errors += Run(baud, seconds, n, results);
+    printf("\n%u nodes, latency of every hop\n node  latency   hop      max latency  round trip\n", n);
+    for(k = 0; k < n; k++)
+    {
+        printf(" %4u  %6.0fus  %5.0fus  %9.0fus  %8.0fus\n", k + 1, results[k].latency,
+               results[k].latency - (k ? results[k - 1].latency : 0.0), results[k].latencyMax, results[k].roundTrip);
+    }
+    printf("samples delivered out of order, wrong or lost: %u\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,284 @@
+/*********************************************************************************************************************
+ * File name : FrameBench.c
+ * Description : Host benchmark of the lab 3 frame encoder and decoder (../frame.c). It measures the number of sample
+ * frames per second that FrameEncode() and FrameDecodeByte() handle on the host, and checks the corruption detection:
+ * encoded sample frames are corrupted by flipping random bits, and the frames that the decoder still accepts with a
+ * wrong type, sequence number, address or sample are counted as undetected errors. Batch frames are measured with a
+ * recorded-like potentiometer signal, a slow sweep with a few codes of noise, and with random samples, the worst case:
+ * the bytes per sample on the line and the samples per second a link can carry are printed for several batch sizes and
+ * baud rates.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Ilab3 lab3/host/FrameBench.c lab3/frame.c -o frame_bench
+ *   ./frame_bench [frames]
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "frame.h"
+
+/*Number of frames of every test if not given on the command line*/
+#define DEFAULT_FRAMES      2000000
+
+/*Baud rate of the lab 3 link. A byte takes 10 bit periods on the line*/
+#define LINK_BAUD_RATE      115200
+
+/*Encoded frames are built once and reused, so the encode loop and the decode loop measure only the codec*/
+#define STREAM_FRAMES       4096
+
+static uint8_t streamBuffer[STREAM_FRAMES*FRAME_MAX_ENCODED];
+static uint32_t streamLength;
+
+/*Batch sizes and baud rates of the batch report*/
+static const uint32_t batchSizes[] = {1, 2, 4, 8, 16};
+static const uint32_t baudRates[] = {115200, 921600, 5000000};
+
+/*Value returned by the benchmark loops so that the compiler cannot remove them*/
+static volatile uint32_t sink;
+
+/*xorshift32 pseudo random generator, so that runs are repeatable*/
+static uint32_t randomState = 2463534242u;
+
+static uint32_t Random(void)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+/***************************************************************************************************************************
+ * Function name : Seconds()
+ * Inputs : none
+ * Outputs : monotonic time in seconds
+ ***************************************************************************************************************************/
+
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+/***************************************************************************************************************************
+ * Function name : BenchEncode()
+ * Inputs : frames
+ * Outputs : none
+ * Description : This function encodes frames sample frames with all 4096 sample values and prints the rate. The encoded
+ * frames of the first pass are kept in streamBuffer for BenchDecode().
+ ***************************************************************************************************************************/
+
+static void BenchEncode(uint32_t frames)
+{
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    tFrame frame;
+    uint32_t i, bytes = 0, length;
+    double start, elapsed;
+
+    streamLength = 0;
+    for(i = 0; i < STREAM_FRAMES; i++)
+    {
+        FrameSetSample(&frame, i, i & 0x0FFF);
+        streamLength += FrameEncode(&frame, &streamBuffer[streamLength]);
+    }
+
+    start = Seconds();
+    for(i = 0; i < frames; i++)
+    {
+        FrameSetSample(&frame, i, i & 0x0FFF);
+        length = FrameEncode(&frame, encoded);
+        bytes += length + encoded[length - 2];
+    }
+    elapsed = Seconds() - start;
+    sink = bytes;
+
+    printf("encode: %u frames in %.3f s, %.2f Mframes/s, %.1f ns/frame\n", frames, elapsed, frames/elapsed/1e6,
+           elapsed*1e9/frames);
+}
+
+/***************************************************************************************************************************
+ * Function name : BenchDecode()
+ * Inputs : frames
+ * Outputs : false if a frame was decoded wrongly
+ * Description : This function feeds the encoded frames of BenchEncode() to the decoder until frames frames have been
+ * decoded, checks every decoded sample and prints the rate.
+ ***************************************************************************************************************************/
+
+static bool BenchDecode(uint32_t frames)
+{
+    tFrameDecoder decoder;
+    tFrame frame;
+    uint32_t decoded = 0, position = 0, bytes = 0, errors = 0;
+    double start, elapsed;
+
+    memset(&decoder, 0, sizeof(decoder));
+    start = Seconds();
+    while(decoded < frames)
+    {
+        if(FrameDecodeByte(&decoder, streamBuffer[position], &frame))
+        {
+            if(frame.ui8Type != FRAME_TYPE_SAMPLE || FrameGetSample(&frame) != (decoded % STREAM_FRAMES))
+                errors++;
+            decoded++;
+        }
+        bytes++;
+        if(++position == streamLength)
+            position = 0;
+    }
+    elapsed = Seconds() - start;
+
+    printf("decode: %u frames in %.3f s, %.2f Mframes/s, %.1f MB/s, %.1f ns/frame, %u wrong\n", frames, elapsed,
+           frames/elapsed/1e6, bytes/elapsed/1e6, elapsed*1e9/frames, errors);
+    printf("link:   %.1f bytes/frame, %.0f samples/s at %d baud\n", (double)streamLength/STREAM_FRAMES,
+           LINK_BAUD_RATE/10.0/((double)streamLength/STREAM_FRAMES), LINK_BAUD_RATE);
+    return errors == 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : BenchCorruption()
+ * Inputs : frames, flips
+ * Outputs : none
+ * Description : This function encodes frames random sample frames, flips flips random bits in each of them, delimiter
+ * included, and feeds them to a decoder, with a delimiter after every frame so that a corrupted frame does not hide the
+ * next one. A frame that is accepted although it differs from the frame sent is an undetected error.
+ ***************************************************************************************************************************/
+
+static void BenchCorruption(uint32_t frames, uint32_t flips)
+{
+    uint8_t encoded[FRAME_MAX_ENCODED + 1];
+    tFrameDecoder decoder;
+    tFrame sent, received;
+    uint32_t i, j, length, accepted = 0, undetected = 0;
+
+    memset(&decoder, 0, sizeof(decoder));
+    for(i = 0; i < frames; i++)
+    {
+        FrameSetSample(&sent, Random(), Random());
+        sent.ui8Address = Random();
+        length = FrameEncode(&sent, encoded);
+        for(j = 0; j < flips; j++)
+        {
+            uint32_t bit = Random() % (length*8);
+            encoded[bit/8] ^= 1 << (bit%8);
+        }
+        encoded[length++] = FRAME_DELIMITER;
+        for(j = 0; j < length; j++)
+        {
+            if(FrameDecodeByte(&decoder, encoded[j], &received))
+            {
+                accepted++;
+                if(received.ui8Type != sent.ui8Type || received.ui8Sequence != sent.ui8Sequence ||
+                   received.ui8Address != sent.ui8Address || received.ui8Length != sent.ui8Length || FrameGetSample(&received) != FrameGetSample(&sent))
+                    undetected++;
+            }
+        }
+    }
+
+    printf("%u bit error%s: %u frames, %u accepted, %u undetected (%.4f%%), %u CRC errors, %u framing errors\n", flips,
+           flips == 1 ? " " : "s", frames, accepted, undetected, 100.0*undetected/frames, decoder.ui32CRCErrors,
+           decoder.ui32FramingErrors);
+}
+
+/***************************************************************************************************************************
+ * Function name : PotSample()
+ * Inputs : n
+ * Outputs : sample n of a potentiometer signal sampled at 1kHz
+ * Description : The signal sweeps the full range up and down in 4 seconds, with up to 3 codes of noise.
+ ***************************************************************************************************************************/
+
+static uint16_t PotSample(uint32_t n)
+{
+    int32_t sample = (n*2) % 8190, noise = (int32_t)(Random() % 7) - 3;
+
+    if(sample > 4095)
+        sample = 8190 - sample;
+    sample += noise;
+    return (sample < 0) ? 0 : (sample > 4095) ? 4095 : sample;
+}
+
+/***************************************************************************************************************************
+ * Function name : BenchBatch()
+ * Inputs : samples, randomSamples
+ * Outputs : false if a batch was expanded wrongly
+ * Description : This function sends samples samples of the potentiometer signal, or random samples if randomSamples is
+ * true, through FrameSetBatch(), FrameEncode(), the decoder and FrameGetBatch() for every batch size, checks the expanded
+ * samples and prints the bytes per sample, the rate of the host and the samples per second of the links.
+ ***************************************************************************************************************************/
+
+static bool BenchBatch(uint32_t samples, bool randomSamples)
+{
+    uint16_t *signal = malloc(samples*sizeof(uint16_t)), expanded[FRAME_MAX_BATCH];
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    tFrameDecoder decoder;
+    tFrame frame, received;
+    uint32_t i, j, k, length, count, bytes, errors = 0;
+    double start, elapsed;
+
+    for(i = 0; i < samples; i++)
+    {
+        signal[i] = randomSamples ? (Random() & 0x0FFF) : PotSample(i);
+    }
+
+    printf("%s, %u samples\n batch  bytes/sample  Msamples/s host", randomSamples ? "random samples" :
+           "potentiometer sweep with noise", samples);
+    for(k = 0; k < sizeof(baudRates)/sizeof(baudRates[0]); k++)
+    {
+        printf("  samples/s at %u", baudRates[k]);
+    }
+    printf("\n");
+
+    for(k = 0; k < sizeof(batchSizes)/sizeof(batchSizes[0]); k++)
+    {
+        memset(&decoder, 0, sizeof(decoder));
+        bytes = 0;
+        start = Seconds();
+        for(i = 0; i + batchSizes[k] <= samples; i += batchSizes[k])
+        {
+            FrameSetBatch(&frame, i/batchSizes[k], &signal[i], batchSizes[k]);
+            length = FrameEncode(&frame, encoded);
+            bytes += length;
+            for(j = 0; j < length; j++)
+            {
+                if(FrameDecodeByte(&decoder, encoded[j], &received))
+                {
+                    count = FrameGetBatch(&received, expanded);
+                    if(count != batchSizes[k] || memcmp(expanded, &signal[i], count*sizeof(uint16_t)) != 0)
+                        errors++;
+                }
+            }
+        }
+        elapsed = Seconds() - start;
+
+        printf("%6u  %12.2f  %15.2f", batchSizes[k], (double)bytes/i, i/elapsed/1e6);
+        for(j = 0; j < sizeof(baudRates)/sizeof(baudRates[0]); j++)
+        {
+            printf("  %*.0f", (int)strlen("samples/s at ") + (baudRates[j] >= 1000000 ? 7 : 6),
+                   baudRates[j]/10.0/((double)bytes/i));
+        }
+        printf("\n");
+    }
+    free(signal);
+    if(errors)
+        printf("batches expanded wrongly: %u\n", errors);
+    return errors == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : DEFAULT_FRAMES;
+    bool ok;
+
+    BenchEncode(frames);
+    ok = BenchDecode(frames);
+    BenchCorruption(frames/4, 1);
+    BenchCorruption(frames/4, 2);
+    BenchCorruption(frames/4, 3);
+    ok = BenchBatch(frames, false) && ok;
+    ok = BenchBatch(frames, true) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/*********************************************************************************************************************
+ * File name : QuantizerSim.c
+ * Description : Host simulation of the LED bar quantizer of lab 3 (../quantizer.c) with noisy potentiometer signals.
+ * The sender of main.c is modeled at 1000 samples per second with batches of SAMPLE_BATCH_SIZE samples. Two signals
+ * are used: the potentiometer resting on the limit between one and two LEDs (410 codes), and a slow sweep over the
+ * whole range and back every 20 seconds. Gaussian-like noise of the given standard deviation in codes is added.
+ *
+ * For every noise level the changes of the LED bar per second are counted for the plain quantizer (no hysteresis) and
+ * for LED_BAR_HYSTERESIS, and the batches per second sent to the receiver are counted for the filter that main.c used
+ * before, which sent a batch when a value moved by at least 16 codes from the value sent last, and for the filter that
+ * sends a batch only when it changes the number of LEDs lit. A receiver quantizer fed with the batches sent must show the
+ * same number of LEDs as the sender expects after every batch; mismatches are counted.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Ilab3 lab3/host/QuantizerSim.c lab3/quantizer.c -o quantizer_sim
+ *   ./quantizer_sim [seconds]
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantizer.h"
+
+/*Settings of main.c*/
+#define ADC_SAMPLE_RATE_HZ      1000
+#define SAMPLE_BATCH_SIZE       8
+#define LED_BAR_LEDS            10
+#define ADC_FULL_SCALE          4095
+#define LED_BAR_HYSTERESIS      32
+#define LED_THRESHOLD(i)        QUANTIZER_THRESHOLD(i, LED_BAR_LEDS, ADC_FULL_SCALE)
+
+/*Change threshold of the filter main.c used before the quantizer*/
+#define OLD_CHANGE_THRESHOLD    16
+
+/*Length of the simulation if not given on the command line, and period of the sweep*/
+#define DEFAULT_SECONDS         60
+#define SWEEP_PERIOD_S          20
+
+static const uint16_t pui16LEDThreshold[LED_BAR_LEDS] =
+{
+    LED_THRESHOLD(0), LED_THRESHOLD(1), LED_THRESHOLD(2), LED_THRESHOLD(3), LED_THRESHOLD(4),
+    LED_THRESHOLD(5), LED_THRESHOLD(6), LED_THRESHOLD(7), LED_THRESHOLD(8), LED_THRESHOLD(9)
+};
+
+/*Standard deviations of the noise in codes*/
+static const double noiseLevels[] = {0, 1, 2, 4, 8, 16, 32};
+
+/*Counts of one run*/
+typedef struct
+{
+    uint32_t plainTransitions;
+    uint32_t hysteresisTransitions;
+    uint32_t oldBatches;
+    uint32_t newBatches;
+    uint32_t mismatches;
+} tResult;
+
+static uint32_t randomState;
+
+/*Uniform random number in [-1, 1)*/
+static double Uniform(void)
+{
+    randomState = randomState*1664525u + 1013904223u;
+    return (randomState >> 8)/(double)(1u << 23) - 1.0;
+}
+
+/*Sample n of the signal: resting on the limit between one and two LEDs, or a triangle sweep, plus noise. The sum of four
+ * uniform numbers has a variance of 4/3 and is close to a normal distribution*/
+static uint16_t SignalSample(bool sweep, uint32_t n, double sigma)
+{
+    double value, phase;
+
+    if(sweep)
+    {
+        phase = (double)(n % (SWEEP_PERIOD_S*ADC_SAMPLE_RATE_HZ))/(SWEEP_PERIOD_S*ADC_SAMPLE_RATE_HZ);
+        value = (phase < 0.5) ? 2*phase*ADC_FULL_SCALE : (2 - 2*phase)*ADC_FULL_SCALE;
+    }
+    else
+    {
+        value = LED_THRESHOLD(1);
+    }
+    value += sigma*0.8660254*(Uniform() + Uniform() + Uniform() + Uniform());
+    value = (value < 0) ? 0 : (value > ADC_FULL_SCALE) ? ADC_FULL_SCALE : value + 0.5;
+    return (uint16_t)value;
+}
+
+/*Runs one signal for the given number of seconds*/
+static void Run(bool sweep, double sigma, uint32_t seconds, tResult *result)
+{
+    tQuantizer plain, hysteresis, sent, batchQuantizer, receiver;
+    uint16_t batch[SAMPLE_BATCH_SIZE];
+    uint32_t batchCount = 0, previousSent = 0xFFFFFFFF, change, n, i;
+    bool changed = false;
+
+    QuantizerInit(&plain, pui16LEDThreshold, LED_BAR_LEDS, 0);
+    QuantizerInit(&hysteresis, pui16LEDThreshold, LED_BAR_LEDS, LED_BAR_HYSTERESIS);
+    QuantizerInit(&sent, pui16LEDThreshold, LED_BAR_LEDS, LED_BAR_HYSTERESIS);
+    QuantizerInit(&receiver, pui16LEDThreshold, LED_BAR_LEDS, LED_BAR_HYSTERESIS);
+    randomState = 12345;
+    result->oldBatches = 0;
+    result->newBatches = 0;
+    result->mismatches = 0;
+
+    for(n = 0; n < seconds*ADC_SAMPLE_RATE_HZ; n++)
+    {
+        batch[batchCount++] = SignalSample(sweep, n, sigma);
+        QuantizerUpdate(&plain, batch[batchCount - 1]);
+        QuantizerUpdate(&hysteresis, batch[batchCount - 1]);
+
+        /*filter used before: a value moved by at least OLD_CHANGE_THRESHOLD from the value sent last*/
+        change = (batch[batchCount - 1] > previousSent) ? batch[batchCount - 1] - previousSent :
+                                                          previousSent - batch[batchCount - 1];
+        if(change >= OLD_CHANGE_THRESHOLD)
+        {
+            changed = true;
+        }
+
+        if(batchCount < SAMPLE_BATCH_SIZE)
+        {
+            continue;
+        }
+        if(changed)
+        {
+            result->oldBatches++;
+            previousSent = batch[batchCount - 1];
+        }
+
+        /*filter of main.c: the batch changes the number of LEDs the receiver shows*/
+        batchQuantizer = sent;
+        for(i = 0; i < batchCount; i++)
+        {
+            QuantizerUpdate(&batchQuantizer, batch[i]);
+        }
+        if(batchQuantizer.ui32Level != sent.ui32Level)
+        {
+            sent = batchQuantizer;
+            result->newBatches++;
+            for(i = 0; i < batchCount; i++)
+            {
+                QuantizerUpdate(&receiver, batch[i]);
+            }
+            if(receiver.ui32Level != sent.ui32Level)
+            {
+                result->mismatches++;
+            }
+        }
+        batchCount = 0;
+        changed = false;
+    }
+
+    result->plainTransitions = plain.ui32Transitions;
+    result->hysteresisTransitions = hysteresis.ui32Transitions;
+}
+
+static void PrintTable(bool sweep, uint32_t seconds)
+{
+    tResult result;
+    uint32_t i;
+
+    printf("%s, %u s, changes of the LED bar and batches sent per second\n",
+           sweep ? "Sweep 0-4095-0 every 20 s" : "Resting on the limit between 1 and 2 LEDs", seconds);
+    printf(" noise    LED changes/s          batches/s               mismatches\n");
+    printf(" codes    plain    hyst %-3u      old filter  LED filter\n", LED_BAR_HYSTERESIS);
+    for(i = 0; i < sizeof(noiseLevels)/sizeof(noiseLevels[0]); i++)
+    {
+        Run(sweep, noiseLevels[i], seconds, &result);
+        printf(" %-5.0f    %-8.2f %-12.2f %-11.2f %-11.2f %u\n", noiseLevels[i],
+               (double)result.plainTransitions/seconds, (double)result.hysteresisTransitions/seconds,
+               (double)result.oldBatches/seconds, (double)result.newBatches/seconds, result.mismatches);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t seconds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_SECONDS;
+
+    if(seconds == 0)
+    {
+        seconds = DEFAULT_SECONDS;
+    }
+
+    printf("LED thresholds:");
+    for(uint32_t i = 0; i < LED_BAR_LEDS; i++)
+    {
+        printf(" %u", pui16LEDThreshold[i]);
+    }
+    printf("\n\n");
+
+    PrintTable(false, seconds);
+    PrintTable(true, seconds);
+    return 0;
+}
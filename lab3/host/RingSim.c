@@ -0,0 +1,280 @@
+/*********************************************************************************************************************
+ * File name : RingSim.c
+ * Description : Host stress test of the ring buffers of lab 3 (../ring.c). A periodic timer signal plays the part of
+ * UART4IntHandler() and ADC0SS3IntHandler() and interrupts the main loop at arbitrary instructions, like the interrupts
+ * interrupt the main loop of main.c:
+ *  - receive ring : the signal handler puts a burst of 1 to 8 bytes (the receive FIFO trigger level and the receive
+ *    timeout) and the main loop takes them,
+ *  - transmit ring : the main loop puts bytes and the signal handler takes a burst of up to 8 bytes (the free space of
+ *    the transmit FIFO),
+ *  - sample ring : the signal handler puts one sample and the main loop takes it.
+ * All rings carry a numbered sequence. The side that takes the bytes checks that every byte arrives exactly
+ * once and in order. A full ring is not an error, the producer keeps the byte and tries again later.
+ *
+ * The main loop changes its pace every 1 to 10ms at random between three phases, so the interrupt finds the rings full,
+ * empty and anywhere in between and lands inside the put and get functions of the main loop:
+ *  - fast : the main loop takes every byte of the receive and sample rings and fills the transmit ring,
+ *  - paced : the main loop moves one byte each way and takes one sample after an empty loop of 100 to 3099 counts (about 0.1 to 3us), so
+ *    the transmit ring is mostly empty, the receive ring mostly full and the interrupt often takes the byte the main
+ *    loop has just put or puts into the place the main loop has just freed,
+ *  - stalled : the main loop does not touch the rings, like main.c while it writes the statistics line, so the receive
+ *    and sample rings run full (the bursts that do not fit are what main.c counts as rxlost) and the transmit ring runs
+ *    empty.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Ilab3 lab3/host/RingSim.c lab3/ring.c -o ring_sim
+ *   ./ring_sim [seconds]
+ * The exit code is 1 if any byte or sample is lost, duplicated or out of order.
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/time.h>
+#include "ring.h"
+
+/*Interval of the simulated UART interrupt in microseconds*/
+#define INTERRUPT_INTERVAL_US   10
+
+/*Largest burst of bytes moved by one interrupt*/
+#define INTERRUPT_BURST         8
+
+/*Shortest empty loop of the paced phase and range of its length*/
+#define PACE_MIN                100
+#define PACE_RANGE              3000
+
+/*Phases of the main loop*/
+enum
+{
+    PHASE_FAST,
+    PHASE_PACED,
+    PHASE_STALLED,
+    PHASES
+};
+
+static tRingBuffer rxRing, txRing;
+static tSampleRing sampleRing;
+
+/*Counters of the signal handler. The main loop only reads them after the timer has been stopped*/
+static volatile uint32_t rxSent, txChecked, interrupts, rxFull, txEmpty, txErrors, samplesSent, sampleFull;
+static volatile unsigned int burstSeed = 1;
+
+/*****************************************************************************************************************
+ * Function name : SequenceSample()
+ * Inputs : index
+ * Outputs : sample number index of the sequence
+ * Description : This function mixes all bits of the index into the sample, so a whole ring of lost or repeated
+ * samples is not hidden by the sample wrapping around.
+ *****************************************************************************************************************/
+
+static uint16_t SequenceSample(uint32_t index)
+{
+    index ^= index >> 16;
+    index *= 0x45D9F3Bu;
+    index ^= index >> 16;
+    return (uint16_t)index;
+}
+
+/*****************************************************************************************************************
+ * Function name : SequenceByte()
+ * Inputs : index
+ * Outputs : byte number index of the sequence
+ *****************************************************************************************************************/
+
+static uint8_t SequenceByte(uint32_t index)
+{
+    return (uint8_t)SequenceSample(index);
+}
+
+/*****************************************************************************************************************
+ * Function name : InterruptHandler()
+ * Inputs : signal
+ * Outputs : none
+ * Description : This function is the simulated UART4IntHandler() and ADC0SS3IntHandler(). It fills the receive ring
+ * from the sequence, empties the transmit ring into the check of the sequence and puts one sample.
+ *****************************************************************************************************************/
+
+static void InterruptHandler(int signal)
+{
+    int burst, count;
+    uint8_t byte;
+
+    (void)signal;
+    interrupts++;
+
+    burst = 1 + rand_r((unsigned int *)&burstSeed) % INTERRUPT_BURST;
+    for(count = 0; count < burst; count++)
+    {
+        if(!RingPut(&rxRing, SequenceByte(rxSent)))
+        {
+            rxFull++;
+            break;
+        }
+        rxSent++;
+    }
+
+    for(count = 0; count < INTERRUPT_BURST; count++)
+    {
+        if(!RingGet(&txRing, &byte))
+        {
+            txEmpty++;
+            break;
+        }
+        if(byte != SequenceByte(txChecked))
+        {
+            txErrors++;
+        }
+        txChecked++;
+    }
+
+    if(SampleRingPut(&sampleRing, SequenceSample(samplesSent)))
+    {
+        samplesSent++;
+    }
+    else
+    {
+        sampleFull++;
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : ElapsedSeconds()
+ * Inputs : start
+ * Outputs : seconds since start
+ *****************************************************************************************************************/
+
+static double ElapsedSeconds(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec)/1e9;
+}
+
+/*****************************************************************************************************************
+ * Function name : StartInterrupts()
+ * Inputs : intervalUs, 0 to stop
+ * Outputs : none
+ *****************************************************************************************************************/
+
+static void StartInterrupts(long intervalUs)
+{
+    struct itimerval timer = {{0, intervalUs}, {0, intervalUs}};
+
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+    uint32_t rxChecked = 0, rxErrors = 0, txSent = 0, samplesChecked = 0, sampleErrors = 0, pace = 0;
+    uint32_t phaseCount[PHASES] = {0};
+    struct sigaction action = {0};
+    struct timespec start;
+    double elapsed = 0.0, phaseEnd = 0.0;
+    int phase = PHASE_FAST;
+    volatile uint32_t spin;
+    uint8_t byte;
+    uint16_t sample;
+
+    action.sa_handler = InterruptHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    StartInterrupts(INTERRUPT_INTERVAL_US);
+    while(elapsed < seconds)
+    {
+        if(elapsed >= phaseEnd)
+        {
+            phase = rand() % PHASES;
+            pace = PACE_MIN + rand() % PACE_RANGE;
+            phaseEnd = elapsed + (1 + rand() % 10)/1000.0;
+            phaseCount[phase]++;
+        }
+
+        if(phase != PHASE_STALLED)
+        {
+            for(spin = 0; phase == PHASE_PACED && spin < pace; spin++)
+            {
+            }
+            while(RingGet(&rxRing, &byte))
+            {
+                if(byte != SequenceByte(rxChecked))
+                {
+                    rxErrors++;
+                }
+                rxChecked++;
+                if(phase == PHASE_PACED)
+                {
+                    break;
+                }
+            }
+            while(RingPut(&txRing, SequenceByte(txSent)))
+            {
+                txSent++;
+                if(phase == PHASE_PACED)
+                {
+                    break;
+                }
+            }
+            while(SampleRingGet(&sampleRing, &sample))
+            {
+                if(sample != SequenceSample(samplesChecked))
+                {
+                    sampleErrors++;
+                }
+                samplesChecked++;
+                if(phase == PHASE_PACED)
+                {
+                    break;
+                }
+            }
+        }
+        elapsed = ElapsedSeconds(&start);
+    }
+    StartInterrupts(0);
+
+    /*The bytes still in the rings are counted on the side that took them*/
+    while(RingGet(&rxRing, &byte))
+    {
+        if(byte != SequenceByte(rxChecked))
+        {
+            rxErrors++;
+        }
+        rxChecked++;
+    }
+    while(RingGet(&txRing, &byte))
+    {
+        if(byte != SequenceByte(txChecked))
+        {
+            txErrors++;
+        }
+        txChecked++;
+    }
+    while(SampleRingGet(&sampleRing, &sample))
+    {
+        if(sample != SequenceSample(samplesChecked))
+        {
+            sampleErrors++;
+        }
+        samplesChecked++;
+    }
+
+    printf("Interrupts          : %u in %.1f s\n", interrupts, seconds);
+    printf("Main loop phases    : fast %u, paced %u, stalled %u\n",
+           phaseCount[PHASE_FAST], phaseCount[PHASE_PACED], phaseCount[PHASE_STALLED]);
+    printf("Receive ring        : %u bytes put, %u taken, %u interrupts found it full, %u errors\n",
+           rxSent, rxChecked, rxFull, rxErrors);
+    printf("Transmit ring       : %u bytes put, %u taken, %u interrupts found it empty, %u errors\n",
+           txSent, txChecked, txEmpty, txErrors);
+    printf("Sample ring         : %u samples put, %u taken, %u interrupts found it full, %u errors\n",
+           samplesSent, samplesChecked, sampleFull, sampleErrors);
+
+    return (rxErrors != 0 || txErrors != 0 || sampleErrors != 0 || rxChecked != rxSent || txChecked != txSent ||
+            samplesChecked != samplesSent) ? 1 : 0;
+}
@@ -0,0 +1,1359 @@
+/*********************************************************************************************************************
+ * File name : tiva_host.c
+ * Description : Host replacement of the TivaWare functions used by lab 3, to run the sender and the receiver of
+ * ../main.c as two processes on a PC. The lab 3 program is compiled unchanged and linked with this file. Before main()
+ * runs, a pseudo-terminal pair is opened and two processes are started: the sender, which reads 0 on the
+ * configuration pin PE3 and owns the master side, and the receiver, which reads PE3 high and owns the slave side. A
+ * third process waits for the end of the run and prints the report.
+ *
+ * The peripherals are modeled in real time (CLOCK_MONOTONIC):
+ *  - SysTick and Timer0A run at the periods set by the program. Every timeout of Timer0A triggers ADC0 sample
+ *    sequencer 3, which takes the value of the potentiometer script for that instant.
+ *  - UART4 has 16 byte FIFOs. A byte leaves the transmit FIFO every 10 bit periods of the rate set with
+ *    UARTConfigSetExpClk() and is written to the pseudo-terminal together with that rate. The receiving side moves the
+ *    bytes into its receive FIFO at the same pace. A byte sent at another rate than the receiver uses is lost with a
+ *    framing error, and a byte that finds the receive FIFO full with an overrun error, like on the board. The receive,
+ *    receive timeout and transmit interrupts follow the FIFO levels main.c sets up (half full, 32 bit periods, 4 bytes).
+ *  - The peripherals are brought up to date and pending interrupts that are enabled and not masked run whenever a
+ *    TivaWare function is called, and every HOST_TICK_US from an interval timer signal, so that loops that wait for an
+ *    interrupt without calling TivaWare also end. The signal does nothing while a modeled function runs, and handlers
+ *    do not interrupt each other. A process that has had nothing to do for HOST_IDLE_US in a TivaWare call sleeps until
+ *    the next timer event or until bytes arrive, so both processes also run on a single processor.
+ *  - LED bar writes are recorded with their time. UART0 output (the link statistics) is written to standard error if
+ *    LAB3_UART0 is set.
+ *  - The run is stopped and fails if it takes longer than HOST_TIME_LIMIT_S (120s), or LAB3_TIME_LIMIT seconds if set.
+ *
+ * The potentiometer script is read from standard input, one segment per line, lines starting with # are ignored:
+ *   <duration in ms> <digital value>
+ * The potentiometer stays at the value for the duration of the segment. The run ends with the last segment. Noise
+ * with a standard deviation of LAB3_ADC_NOISE codes is added to every sample if that variable is set.
+ *
+ * Report: the start of every segment is a step of the potentiometer. For the steps after the link is up (the sender has
+ * received the first keepalive back) that change the number of LEDs, the latency is the time from the step to the LED
+ * bar of the receiver showing the number of LEDs of the new value. A step whose number is not shown before the next
+ * step is counted as missed. Message rates are counted by a frame decoder on the receiving side of each direction,
+ * from the time the link is up.
+ *
+ * Build (TIVAWARE is the TivaWare installation):
+ *   gcc -std=gnu99 -O2 -DPART_TM4C123GH6PM -I$TIVAWARE -Ilab3 lab3/main.c lab3/frame.c lab3/arq.c lab3/quantizer.c
+ *       lab3/linkstats.c lab3/ring.c lab3/host/tiva_host.c -o lab3_host
+ * Run:
+ *   ./lab3_host < lab3/host/pot_script.txt
+ *********************************************************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/systick.h"
+#include "driverlib/uart.h"
+#include "frame.h"
+#include "quantizer.h"
+
+/*Settings of main.c*/
+#define LED_BAR_LEDS        10
+#define ADC_FULL_SCALE      4095
+
+#define NS_PER_SECOND       1000000000ULL
+
+/*Size of the UART FIFOs and the levels main.c sets: receive interrupt at half full, transmit interrupt at 4 bytes*/
+#define FIFO_BYTES          16
+#define RX_FIFO_LEVEL       8
+#define TX_FIFO_LEVEL       4
+
+/*Every byte goes over the pseudo-terminal as a record of the rate it was sent at, low byte first, and the byte*/
+#define WIRE_RECORD_BYTES   5
+
+/*Bytes read from the pseudo-terminal and not yet moved into the receive FIFO. A process that waits for room to send
+ * reads into it, so it also holds what the other process sends in that time*/
+#define WIRE_INPUT_BYTES    65536
+
+/*Time without any event after which a process sleeps, and interval of the timer signal*/
+#define HOST_IDLE_US        20
+#define HOST_TICK_US        100
+
+/*Run time in seconds after which the first process stops the sender and the receiver, unless LAB3_TIME_LIMIT is set*/
+#define HOST_TIME_LIMIT_S   120
+
+/*Largest number of potentiometer steps and LED bar changes recorded*/
+#define MAX_STEPS           4096
+#define MAX_LED_EVENTS      65536
+
+/*Interrupts modeled by the simulation, in the order they are taken when several are pending*/
+enum
+{
+    HOST_INT_SYSTICK,
+    HOST_INT_UART4,
+    HOST_INT_ADC0SS3,
+    HOST_INT_COUNT
+};
+
+/*Counters of one direction of the link, kept by the receiving process. The Up counters start when the link is up*/
+typedef struct
+{
+    uint64_t bytes, bytesUp;
+    uint64_t frames[16], framesUp[16];
+    uint64_t errors;
+    uint32_t baud;
+} tLineCounters;
+
+/*Memory shared by the three processes*/
+typedef struct
+{
+    uint64_t startNs, endNs, linkUpNs;
+    uint32_t steps;
+    uint64_t stepNs[MAX_STEPS];
+    uint16_t stepValue[MAX_STEPS];
+    uint32_t ledEvents;
+    uint64_t ledNs[MAX_LED_EVENTS];
+    uint8_t ledCount[MAX_LED_EVENTS];
+    tLineCounters toReceiver, toSender;
+} tShared;
+
+static tShared *shared;
+static bool isReceiver;
+static int wireFd = -1;
+
+static uint32_t clockHz = 16000000;
+
+/*Interrupts. nvicEnabled follows IntEnable()/IntDisable(), masked follows IntMasterEnable()/IntMasterDisable()*/
+static void (*handlers[HOST_INT_COUNT])(void);
+static bool nvicEnabled[HOST_INT_COUNT];
+static bool masked;
+static bool inHandler;
+static volatile sig_atomic_t hostBusy;
+static uint64_t lastEventNs;
+
+/*SysTick. sysTickDue counts the ticks whose interrupt has not run yet*/
+static uint32_t sysTickPeriod = 1;
+static bool sysTickEnabled, sysTickIntEnabled;
+static uint64_t sysTickStartNs, sysTickCount;
+static uint32_t sysTickDue;
+
+/*Timer0A and ADC0 sample sequencer 3*/
+static uint32_t timerLoad;
+static bool timerEnabled, timerTrigger;
+static uint64_t timerStartNs, timerCount;
+static bool adcIntEnabled, adcPending;
+static uint32_t adcValue;
+
+/*Potentiometer script*/
+static bool scriptStarted;
+static uint64_t segmentEndNs;
+static uint32_t segmentValue;
+static double noiseCodes;
+static uint32_t noiseState = 2463534242u;
+
+/*UART4*/
+static uint32_t uartBaud = 115200;
+static uint32_t uartIntMask, uartIntStatus;
+static uint32_t uartRxErrors;
+static uint8_t rxFifo[FIFO_BYTES];
+static uint32_t rxHead, rxCount;
+static uint64_t rxNextNs, rxLastNs;
+static uint8_t wireInput[WIRE_INPUT_BYTES];
+static uint32_t wireInputLength;
+static uint8_t txFifo[FIFO_BYTES];
+static uint32_t txHead, txCount;
+static uint64_t txDoneNs;
+static tFrameDecoder monitor;
+
+/*LED bar, bits 9-8 on PA7-PA6 and bits 7-0 on PB7-PB0*/
+static uint32_t ledPattern;
+
+/*UART0 line being collected for standard error*/
+static char uart0Line[1024];
+static uint32_t uart0Length;
+
+static void HostPoll(void);
+
+/*Every modeled function that changes the state of a peripheral runs between HOST_ENTER() and HOST_LEAVE(), so that the
+ * timer signal does not change the state at the same time*/
+#define HOST_ENTER()        (hostBusy++)
+#define HOST_LEAVE()        (hostBusy--)
+
+/***************************************************************************************************************************
+ * Function name : NowNs()
+ * Inputs : none
+ * Outputs : time of CLOCK_MONOTONIC in ns, the same in all processes
+ ***************************************************************************************************************************/
+
+static uint64_t NowNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*NS_PER_SECOND + now.tv_nsec;
+}
+
+/***************************************************************************************************************************
+ * Function name : CyclesToNs()
+ * Inputs : cycles
+ * Outputs : duration of cycles clock cycles of the system clock in ns
+ ***************************************************************************************************************************/
+
+static uint64_t CyclesToNs(uint64_t cycles)
+{
+    return cycles*NS_PER_SECOND/clockHz;
+}
+
+/***************************************************************************************************************************
+ * Function name : ByteNs()
+ * Inputs : none
+ * Outputs : time of one byte on UART4 (start bit, 8 data bits, stop bit) in ns
+ ***************************************************************************************************************************/
+
+static uint64_t ByteNs(void)
+{
+    return 10*NS_PER_SECOND/uartBaud;
+}
+
+/***************************************************************************************************************************
+ * Function name : Noise()
+ * Inputs : none
+ * Outputs : a random value with a standard deviation of noiseCodes
+ * Description : The sum of 12 uniform values from 0 to 1 minus 6 is close to a normal distribution with a standard
+ * deviation of 1.
+ ***************************************************************************************************************************/
+
+static double Noise(void)
+{
+    double sum = -6.0;
+    int i;
+
+    for(i = 0; i < 12; i++)
+    {
+        noiseState ^= noiseState << 13;
+        noiseState ^= noiseState >> 17;
+        noiseState ^= noiseState << 5;
+        sum += noiseState/4294967296.0;
+    }
+    return sum*noiseCodes;
+}
+
+/***************************************************************************************************************************
+ * Function name : ScriptValue()
+ * Inputs : timeNs
+ * Outputs : value of the potentiometer at timeNs
+ * Description : This function reads the segments of the script up to timeNs and records the start of every segment as a
+ * step. At the end of the script the sender process ends the run.
+ ***************************************************************************************************************************/
+
+static uint32_t ScriptValue(uint64_t timeNs)
+{
+    char line[128];
+    unsigned duration, value;
+    int sample;
+
+    if(!scriptStarted)
+    {
+        scriptStarted = true;
+        segmentEndNs = timeNs;
+    }
+    while(timeNs >= segmentEndNs)
+    {
+        if(fgets(line, sizeof(line), stdin) == NULL)
+        {
+            shared->endNs = segmentEndNs;
+            _exit(0);
+        }
+        if(line[0] == '#' || sscanf(line, "%u %u", &duration, &value) != 2)
+        {
+            continue;
+        }
+        segmentValue = (value > ADC_FULL_SCALE) ? ADC_FULL_SCALE : value;
+        if(shared->steps < MAX_STEPS)
+        {
+            shared->stepNs[shared->steps] = segmentEndNs;
+            shared->stepValue[shared->steps] = segmentValue;
+            shared->steps++;
+        }
+        segmentEndNs += (uint64_t)duration*1000000ULL;
+    }
+
+    sample = segmentValue + (int)(Noise() + 0.5);
+    return (sample < 0) ? 0 : (sample > ADC_FULL_SCALE) ? ADC_FULL_SCALE : sample;
+}
+
+/***************************************************************************************************************************
+ * Function name : RunPendingInterrupts()
+ * Inputs : none
+ * Outputs : true if a handler has run
+ * Description : This function runs the handlers of the pending interrupts that are enabled, unless interrupts are masked
+ * or a handler is running. Handlers do not interrupt each other.
+ ***************************************************************************************************************************/
+
+static bool RunPendingInterrupts(void)
+{
+    bool ran = false, again = true;
+
+    if(masked || inHandler)
+    {
+        return false;
+    }
+    inHandler = true;
+    while(again)
+    {
+        again = false;
+        if(sysTickDue != 0 && sysTickIntEnabled && handlers[HOST_INT_SYSTICK] != NULL)
+        {
+            sysTickDue--;
+            handlers[HOST_INT_SYSTICK]();
+            again = true;
+        }
+        else if((uartIntStatus & uartIntMask) != 0 && nvicEnabled[HOST_INT_UART4] && handlers[HOST_INT_UART4] != NULL)
+        {
+            handlers[HOST_INT_UART4]();
+            again = (uartIntStatus & uartIntMask) != 0 ? false : true;
+        }
+        else if(adcPending && adcIntEnabled && nvicEnabled[HOST_INT_ADC0SS3] && handlers[HOST_INT_ADC0SS3] != NULL)
+        {
+            adcPending = false;
+            handlers[HOST_INT_ADC0SS3]();
+            again = true;
+        }
+        ran |= again;
+    }
+    inHandler = false;
+    return ran;
+}
+
+/***************************************************************************************************************************
+ * Function name : ServiceTimers()
+ * Inputs : now
+ * Outputs : true if a timer has expired
+ * Description : This function counts the SysTick periods that have passed and runs the ADC for every Timer0A timeout.
+ ***************************************************************************************************************************/
+
+static bool ServiceTimers(uint64_t now)
+{
+    bool event = false;
+
+    while(sysTickEnabled && now >= sysTickStartNs + CyclesToNs((sysTickCount + 1)*sysTickPeriod))
+    {
+        sysTickCount++;
+        sysTickDue++;
+        event = true;
+    }
+    while(timerEnabled && now >= timerStartNs + CyclesToNs((timerCount + 1)*(uint64_t)(timerLoad + 1)))
+    {
+        timerCount++;
+        if(timerTrigger && !isReceiver)
+        {
+            adcValue = ScriptValue(timerStartNs + CyclesToNs(timerCount*(uint64_t)(timerLoad + 1)));
+            adcPending = true;
+        }
+        event = true;
+    }
+    return event;
+}
+
+/***************************************************************************************************************************
+ * Function name : WriteWire()
+ * Inputs : data, length
+ * Outputs : none
+ * Description : This function writes records to the pseudo-terminal and waits while it is full. The other process may be
+ * waiting in WriteWire() for room in the other direction at the same time, so the records that arrive while waiting are
+ * read into wireInput. Otherwise both processes would wait for each other for ever.
+ ***************************************************************************************************************************/
+
+static void WriteWire(const uint8_t *data, uint32_t length)
+{
+    struct pollfd wait = {wireFd, POLLOUT, 0};
+    ssize_t written, received;
+
+    while(length > 0)
+    {
+        written = write(wireFd, data, length);
+        if(written > 0)
+        {
+            data += written;
+            length -= written;
+        }
+        else if(written < 0 && errno != EAGAIN && errno != EINTR)
+        {
+            exit(1);
+        }
+        else
+        {
+            wait.events = (wireInputLength < WIRE_INPUT_BYTES) ? (POLLIN | POLLOUT) : POLLOUT;
+            poll(&wait, 1, 10);
+            if(wireInputLength < WIRE_INPUT_BYTES)
+            {
+                received = read(wireFd, wireInput + wireInputLength, WIRE_INPUT_BYTES - wireInputLength);
+                if(received > 0)
+                {
+                    wireInputLength += received;
+                }
+            }
+        }
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : ServiceTransmit()
+ * Inputs : now
+ * Outputs : true if a byte has been sent
+ * Description : This function sends the bytes of the transmit FIFO whose 10 bit periods have passed. The transmit
+ * interrupt becomes pending when the FIFO drains to TX_FIFO_LEVEL bytes.
+ ***************************************************************************************************************************/
+
+static bool ServiceTransmit(uint64_t now)
+{
+    uint8_t records[FIFO_BYTES*WIRE_RECORD_BYTES];
+    uint32_t length = 0;
+
+    while(txCount > 0 && now >= txDoneNs)
+    {
+        records[length++] = uartBaud;
+        records[length++] = uartBaud >> 8;
+        records[length++] = uartBaud >> 16;
+        records[length++] = uartBaud >> 24;
+        records[length++] = txFifo[txHead];
+        txHead = (txHead + 1) % FIFO_BYTES;
+        txCount--;
+        if(txCount == TX_FIFO_LEVEL)
+        {
+            uartIntStatus |= UART_INT_TX;
+        }
+        if(txCount > 0)
+        {
+            txDoneNs += ByteNs();
+        }
+    }
+    if(length > 0)
+    {
+        WriteWire(records, length);
+    }
+    return length > 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : MonitorByte()
+ * Inputs : byte, baud
+ * Outputs : none
+ * Description : This function counts a byte received on UART4 and the frames it completes. The sender marks the link up
+ * when the first keepalive frame comes back.
+ ***************************************************************************************************************************/
+
+static void MonitorByte(uint8_t byte, uint32_t baud)
+{
+    tLineCounters *line = isReceiver ? &shared->toReceiver : &shared->toSender;
+    bool up = __atomic_load_n(&shared->linkUpNs, __ATOMIC_RELAXED) != 0;
+    tFrame frame;
+    uint32_t errors = monitor.ui32CRCErrors + monitor.ui32FramingErrors;
+
+    line->bytes++;
+    line->baud = baud;
+    if(up)
+    {
+        line->bytesUp++;
+    }
+    if(FrameDecodeByte(&monitor, byte, &frame))
+    {
+        line->frames[frame.ui8Type & 0x0F]++;
+        if(up)
+        {
+            line->framesUp[frame.ui8Type & 0x0F]++;
+        }
+        if(!isReceiver && !up && frame.ui8Type == FRAME_TYPE_LINK && frame.pui8Payload[0] == FRAME_LINK_KEEPALIVE)
+        {
+            __atomic_store_n(&shared->linkUpNs, NowNs(), __ATOMIC_RELAXED);
+        }
+    }
+    line->errors += monitor.ui32CRCErrors + monitor.ui32FramingErrors - errors;
+}
+
+/***************************************************************************************************************************
+ * Function name : ServiceReceive()
+ * Inputs : now
+ * Outputs : true if a byte has arrived
+ * Description : This function reads the records that have arrived on the pseudo-terminal when fewer than a FIFO full are
+ * left, and moves one byte into the receive FIFO every 10 bit periods. The receive interrupt runs as soon as the FIFO is
+ * half full, so the FIFO only overflows when the interrupt is held off. Bytes are only moved while the UART4 interrupt is enabled, so that the short
+ * sections in which main.c disables it do not turn a late poll into an overrun. The receive timeout interrupt becomes
+ * pending when bytes have waited in the FIFO for 32 bit periods.
+ ***************************************************************************************************************************/
+
+static bool ServiceReceive(uint64_t now)
+{
+    ssize_t length;
+    uint32_t position = 0, baud;
+    bool event = false;
+
+    if(wireInputLength < FIFO_BYTES*WIRE_RECORD_BYTES)
+    {
+        length = read(wireFd, wireInput + wireInputLength, WIRE_INPUT_BYTES - wireInputLength);
+        if(length > 0)
+        {
+            wireInputLength += length;
+            event = true;
+        }
+    }
+
+    if(!masked && nvicEnabled[HOST_INT_UART4] && handlers[HOST_INT_UART4] != NULL)
+    {
+        if(rxNextNs + 32*ByteNs() < now)
+        {
+            rxNextNs = now;
+        }
+        while(wireInputLength - position >= WIRE_RECORD_BYTES && rxNextNs <= now)
+        {
+            baud = wireInput[position] | (wireInput[position + 1] << 8) | (wireInput[position + 2] << 16) |
+                   ((uint32_t)wireInput[position + 3] << 24);
+            MonitorByte(wireInput[position + 4], baud);
+            if(baud != uartBaud)
+            {
+                uartRxErrors |= UART_RXERROR_FRAMING;
+            }
+            else if(rxCount == FIFO_BYTES)
+            {
+                uartRxErrors |= UART_RXERROR_OVERRUN;
+            }
+            else
+            {
+                rxFifo[(rxHead + rxCount) % FIFO_BYTES] = wireInput[position + 4];
+                rxCount++;
+            }
+            position += WIRE_RECORD_BYTES;
+            rxNextNs += ByteNs();
+            rxLastNs = now;
+            event = true;
+            if(rxCount >= RX_FIFO_LEVEL)
+            {
+                uartIntStatus |= UART_INT_RX;
+                RunPendingInterrupts();
+            }
+        }
+        memmove(wireInput, wireInput + position, wireInputLength - position);
+        wireInputLength -= position;
+    }
+
+    if(rxCount > 0 && now - rxLastNs >= 32*NS_PER_SECOND/uartBaud)
+    {
+        uartIntStatus |= UART_INT_RT;
+    }
+    return event;
+}
+
+/***************************************************************************************************************************
+ * Function name : Sleep()
+ * Inputs : now
+ * Outputs : none
+ * Description : This function sleeps until the next timer event, the next byte to be sent or received, or until bytes
+ * arrive on the pseudo-terminal.
+ ***************************************************************************************************************************/
+
+static void Sleep(uint64_t now)
+{
+    struct pollfd wait = {wireFd, POLLIN, 0};
+    uint64_t next = now + NS_PER_SECOND/100, event;
+    struct timespec timeout;
+
+    if(sysTickEnabled)
+    {
+        event = sysTickStartNs + CyclesToNs((sysTickCount + 1)*sysTickPeriod);
+        next = (event < next) ? event : next;
+    }
+    if(timerEnabled)
+    {
+        event = timerStartNs + CyclesToNs((timerCount + 1)*(uint64_t)(timerLoad + 1));
+        next = (event < next) ? event : next;
+    }
+    if(txCount > 0)
+    {
+        next = (txDoneNs < next) ? txDoneNs : next;
+    }
+    if(wireInputLength >= WIRE_RECORD_BYTES || rxCount > 0)
+    {
+        return;
+    }
+    if(next <= now)
+    {
+        return;
+    }
+    timeout.tv_sec = (next - now)/NS_PER_SECOND;
+    timeout.tv_nsec = (next - now)%NS_PER_SECOND;
+    ppoll(&wait, 1, &timeout, NULL);
+}
+
+/***************************************************************************************************************************
+ * Function name : Service()
+ * Inputs : now
+ * Outputs : true if something has happened
+ * Description : This function advances the peripherals to now and runs the pending interrupts.
+ ***************************************************************************************************************************/
+
+static bool Service(uint64_t now)
+{
+    bool event;
+
+    event = ServiceTimers(now);
+    event |= ServiceTransmit(now);
+    event |= ServiceReceive(now);
+    event |= RunPendingInterrupts();
+    if(event)
+    {
+        lastEventNs = now;
+    }
+    return event;
+}
+
+/***************************************************************************************************************************
+ * Function name : HostPoll()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function is called by the modeled TivaWare functions. It brings the peripherals up to date and
+ * sleeps if nothing has happened for HOST_IDLE_US.
+ ***************************************************************************************************************************/
+
+static void HostPoll(void)
+{
+    uint64_t now;
+
+    if(inHandler || hostBusy != 0 || wireFd < 0)
+    {
+        return;
+    }
+    HOST_ENTER();
+    now = NowNs();
+    if(!Service(now) && now - lastEventNs >= HOST_IDLE_US*1000ULL)
+    {
+        Sleep(now);
+    }
+    HOST_LEAVE();
+}
+
+/***************************************************************************************************************************
+ * Function name : HostTick()
+ * Inputs : signal
+ * Outputs : none
+ * Description : Handler of the interval timer signal. Unless a modeled function is running, it brings the peripherals up to
+ * date like the hardware would, so that interrupts also occur while the program waits in a loop that calls no TivaWare
+ * function.
+ ***************************************************************************************************************************/
+
+static void HostTick(int signal)
+{
+    int savedErrno = errno;
+
+    (void)signal;
+    if(!inHandler && hostBusy == 0)
+    {
+        HOST_ENTER();
+        Service(NowNs());
+        HOST_LEAVE();
+    }
+    errno = savedErrno;
+}
+
+/***************************************************************************************************************************
+ * Function name : Percentile()
+ * Inputs : sorted, count, percent
+ * Outputs : value below which percent percent of the count sorted values are
+ ***************************************************************************************************************************/
+
+static double Percentile(const double *sorted, uint32_t count, double percent)
+{
+    uint32_t index = (uint32_t)(percent*(count - 1)/100.0 + 0.5);
+
+    return sorted[index];
+}
+
+/***************************************************************************************************************************
+ * Function name : CompareDouble()
+ * Inputs : a, b
+ * Outputs : order of two latencies for qsort()
+ ***************************************************************************************************************************/
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/***************************************************************************************************************************
+ * Function name : LedCountAt()
+ * Inputs : timeNs
+ * Outputs : number of LEDs the receiver showed at timeNs
+ ***************************************************************************************************************************/
+
+static uint32_t LedCountAt(uint64_t timeNs)
+{
+    uint32_t count = 0, i;
+
+    for(i = 0; i < shared->ledEvents && shared->ledNs[i] <= timeNs; i++)
+    {
+        count = shared->ledCount[i];
+    }
+    return count;
+}
+
+/***************************************************************************************************************************
+ * Function name : ExpectedLeds()
+ * Inputs : value
+ * Outputs : number of LEDs for a value far from a limit, the number of limits below it
+ ***************************************************************************************************************************/
+
+static uint32_t ExpectedLeds(uint32_t value)
+{
+    uint32_t count = 0, i;
+
+    for(i = 0; i < LED_BAR_LEDS; i++)
+    {
+        if(value > QUANTIZER_THRESHOLD(i, LED_BAR_LEDS, ADC_FULL_SCALE))
+            count++;
+    }
+    return count;
+}
+
+/***************************************************************************************************************************
+ * Function name : PrintLine()
+ * Inputs : name, line, seconds
+ * Outputs : none
+ * Description : This function prints the message rates of one direction of the link.
+ ***************************************************************************************************************************/
+
+static void PrintLine(const char *name, const tLineCounters *line, double seconds)
+{
+    printf("%-25s: %.0f bytes/s (%.1f %% of %u baud), frames/s: sample %.1f, batch %.1f, ack %.1f, link %.1f, "
+           "stats %.1f, CRC and framing errors %llu\n", name, line->bytesUp/seconds,
+           100.0*line->bytesUp*10/seconds/(line->baud ? line->baud : 1), (unsigned)line->baud,
+           line->framesUp[FRAME_TYPE_SAMPLE]/seconds, line->framesUp[FRAME_TYPE_BATCH]/seconds,
+           line->framesUp[FRAME_TYPE_ACK]/seconds, line->framesUp[FRAME_TYPE_LINK]/seconds,
+           line->framesUp[FRAME_TYPE_STATS]/seconds, (unsigned long long)line->errors);
+}
+
+/***************************************************************************************************************************
+ * Function name : Report()
+ * Inputs : none
+ * Outputs : number of steps that were missed
+ * Description : This function matches the potentiometer steps with the LED bar changes and prints the latencies and the
+ * message rates.
+ ***************************************************************************************************************************/
+
+static uint32_t Report(void)
+{
+    static double latencies[MAX_STEPS];
+    uint32_t measured = 0, early = 0, unchanged = 0, missed = 0, changes = 0, i, j, before, expected;
+    uint64_t start, end;
+    double seconds, sum = 0.0;
+
+    for(i = 0; i < shared->steps; i++)
+    {
+        start = shared->stepNs[i];
+        end = (i + 1 < shared->steps) ? shared->stepNs[i + 1] : shared->endNs;
+        if(shared->linkUpNs == 0 || start < shared->linkUpNs)
+        {
+            early++;
+            continue;
+        }
+        before = LedCountAt(start);
+        expected = ExpectedLeds(shared->stepValue[i]);
+        if(expected == before)
+        {
+            unchanged++;
+            continue;
+        }
+        for(j = 0; j < shared->ledEvents && (shared->ledNs[j] <= start || shared->ledCount[j] != expected); j++)
+        {
+        }
+        if(j == shared->ledEvents || shared->ledNs[j] > end)
+        {
+            missed++;
+            continue;
+        }
+        latencies[measured] = (shared->ledNs[j] - start)/1e6;
+        sum += latencies[measured];
+        measured++;
+    }
+
+    printf("Run time                 : %.3f s\n", (shared->endNs - shared->startNs)/1e9);
+    if(shared->linkUpNs == 0)
+    {
+        printf("The link did not come up\n");
+        return 1;
+    }
+    seconds = (shared->endNs - shared->linkUpNs)/1e9;
+    printf("Link up after            : %.3f s at %u baud\n", (shared->linkUpNs - shared->startNs)/1e9,
+           (unsigned)shared->toSender.baud);
+    printf("Potentiometer steps      : %u, %u before the link was up, %u without a change of the LED bar\n",
+           (unsigned)shared->steps, (unsigned)early, (unsigned)unchanged);
+    printf("Steps shown on the LEDs  : %u, missed %u\n", (unsigned)measured, (unsigned)missed);
+    if(measured != 0)
+    {
+        qsort(latencies, measured, sizeof(latencies[0]), CompareDouble);
+        printf("Pot-to-LED latency       : min %.2f ms, mean %.2f ms, median %.2f ms, 95%% %.2f ms, max %.2f ms\n",
+               latencies[0], sum/measured, Percentile(latencies, measured, 50), Percentile(latencies, measured, 95),
+               latencies[measured - 1]);
+    }
+    for(i = 0; i < shared->ledEvents; i++)
+    {
+        changes += shared->ledNs[i] >= shared->linkUpNs;
+    }
+    printf("LED bar changes          : %u, %.1f/s\n", (unsigned)changes, changes/seconds);
+    PrintLine("Sender to receiver", &shared->toReceiver, seconds);
+    PrintLine("Receiver to sender", &shared->toSender, seconds);
+    return missed;
+}
+
+/***************************************************************************************************************************
+ * Function name : HostStart()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function runs before main(). It opens the pseudo-terminal pair and starts the sender and the
+ * receiver, which return to run main(). The first process waits until the sender has reached the end of the script,
+ * stops the receiver and prints the report. If the sender has not ended after HOST_TIME_LIMIT_S (or LAB3_TIME_LIMIT)
+ * seconds, it stops both processes and the run fails.
+ ***************************************************************************************************************************/
+
+__attribute__((constructor)) static void HostStart(void)
+{
+    const char *noise = getenv("LAB3_ADC_NOISE"), *limit = getenv("LAB3_TIME_LIMIT");
+    uint64_t deadlineNs;
+    struct itimerval tick = {{0, HOST_TICK_US}, {0, HOST_TICK_US}};
+    struct sigaction action;
+    struct termios settings;
+    int master, slave, status = 0;
+    pid_t sender, receiver;
+
+    shared = mmap(NULL, sizeof(tShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if(shared == MAP_FAILED || master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 ||
+       (slave = open(ptsname(master), O_RDWR | O_NOCTTY)) < 0)
+    {
+        perror("lab3_host");
+        exit(1);
+    }
+    tcgetattr(slave, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(slave, TCSANOW, &settings);
+    if(noise != NULL)
+    {
+        noiseCodes = atof(noise);
+    }
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = HostTick;
+    action.sa_flags = SA_RESTART;
+    shared->startNs = NowNs();
+    fflush(stdout);
+
+    sender = fork();
+    if(sender == 0)
+    {
+        close(slave);
+        wireFd = master;
+        fcntl(wireFd, F_SETFL, O_NONBLOCK);
+        sigaction(SIGALRM, &action, NULL);
+        setitimer(ITIMER_REAL, &tick, NULL);
+        return;
+    }
+    receiver = fork();
+    if(receiver == 0)
+    {
+        close(master);
+        wireFd = slave;
+        fcntl(wireFd, F_SETFL, O_NONBLOCK);
+        isReceiver = true;
+        sigaction(SIGALRM, &action, NULL);
+        setitimer(ITIMER_REAL, &tick, NULL);
+        return;
+    }
+
+    close(master);
+    close(slave);
+    deadlineNs = shared->startNs + (uint64_t)((limit != NULL) ? atof(limit) : HOST_TIME_LIMIT_S)*NS_PER_SECOND;
+    while(waitpid(sender, &status, WNOHANG) == 0)
+    {
+        if(NowNs() >= deadlineNs)
+        {
+            kill(sender, SIGKILL);
+            kill(receiver, SIGKILL);
+            waitpid(sender, NULL, 0);
+            waitpid(receiver, NULL, 0);
+            fprintf(stderr, "The run did not end within the time limit, sender and receiver stopped\n");
+            exit(1);
+        }
+        usleep(100000);
+    }
+    kill(receiver, SIGTERM);
+    waitpid(receiver, NULL, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        fprintf(stderr, "The sender stopped before the end of the script\n");
+        exit(1);
+    }
+    exit(Report() != 0);
+}
+
+/*System control*/
+
+void SysCtlClockSet(uint32_t ui32Config)
+{
+    /*SYSCTL_SYSDIV_2_5 and the other dividers of the 400MHz PLL output set bit 30 and the divider in bits 28-22*/
+    if((ui32Config & SYSCTL_USE_OSC) == SYSCTL_USE_OSC)
+        clockHz = 16000000/(((ui32Config >> 23) & 0x3F) + 1);
+    else if(ui32Config & 0x40000000)
+        clockHz = 400000000/(((ui32Config >> 22) & 0x7F) + 1);
+    else
+        clockHz = 200000000/(((ui32Config >> 23) & 0x3F) + 1);
+}
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+    (void)ui32Peripheral;
+}
+
+/*GPIO. PE3 is the configuration pin, the LED bar is on PA7-PA6 and PB7-PB0*/
+
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+    (void)ui32PinConfig;
+}
+
+int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    HostPoll();
+    if(ui32Port == GPIO_PORTE_BASE && isReceiver)
+    {
+        return ui8Pins & GPIO_PIN_3;
+    }
+    return 0;
+}
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint32_t old = ledPattern, count = 0, bits;
+
+    if(ui32Port == GPIO_PORTA_BASE)
+    {
+        ledPattern = (ledPattern & ~((ui8Pins & 0xC0) << 2)) | ((ui8Val & ui8Pins & 0xC0) << 2);
+    }
+    else if(ui32Port == GPIO_PORTB_BASE)
+    {
+        ledPattern = (ledPattern & ~ui8Pins) | (ui8Val & ui8Pins);
+    }
+    if(ledPattern != old && isReceiver && shared->ledEvents < MAX_LED_EVENTS)
+    {
+        for(bits = ledPattern; bits != 0; bits >>= 1)
+        {
+            count += bits & 1;
+        }
+        shared->ledNs[shared->ledEvents] = NowNs();
+        shared->ledCount[shared->ledEvents] = count;
+        shared->ledEvents++;
+    }
+}
+
+/*ADC0 sample sequencer 3, triggered by Timer0A*/
+
+void ADCHardwareOversampleConfigure(uint32_t ui32Base, uint32_t ui32Factor)
+{
+    (void)ui32Base;
+    (void)ui32Factor;
+}
+
+void ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t ui32Trigger, uint32_t ui32Priority)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    (void)ui32Trigger;
+    (void)ui32Priority;
+}
+
+void ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t ui32Step, uint32_t ui32Config)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    (void)ui32Step;
+    (void)ui32Config;
+}
+
+void ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+}
+
+void ADCIntRegister(uint32_t ui32Base, uint32_t ui32SequenceNum, void (*pfnHandler)(void))
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    handlers[HOST_INT_ADC0SS3] = pfnHandler;
+    nvicEnabled[HOST_INT_ADC0SS3] = true;
+}
+
+void ADCIntEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    adcIntEnabled = true;
+}
+
+void ADCIntClear(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    adcPending = false;
+}
+
+int32_t ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t *pui32Buffer)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    pui32Buffer[0] = adcValue;
+    return 1;
+}
+
+/*Timer0A*/
+
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+    (void)ui32Base;
+    (void)ui32Config;
+}
+
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    (void)ui32Base;
+    (void)ui32Timer;
+    timerLoad = ui32Value;
+}
+
+void TimerControlTrigger(uint32_t ui32Base, uint32_t ui32Timer, bool bEnable)
+{
+    (void)ui32Base;
+    (void)ui32Timer;
+    timerTrigger = bEnable;
+}
+
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    (void)ui32Base;
+    (void)ui32Timer;
+    HOST_ENTER();
+    timerEnabled = true;
+    timerStartNs = NowNs();
+    timerCount = 0;
+    HOST_LEAVE();
+}
+
+void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    (void)ui32Base;
+    (void)ui32Timer;
+    timerEnabled = false;
+}
+
+/*SysTick*/
+
+void SysTickPeriodSet(uint32_t ui32Period)
+{
+    sysTickPeriod = ui32Period;
+}
+
+void SysTickIntRegister(void (*pfnHandler)(void))
+{
+    handlers[HOST_INT_SYSTICK] = pfnHandler;
+}
+
+void SysTickIntEnable(void)
+{
+    sysTickIntEnabled = true;
+}
+
+void SysTickEnable(void)
+{
+    HOST_ENTER();
+    sysTickEnabled = true;
+    sysTickStartNs = NowNs();
+    sysTickCount = 0;
+    HOST_LEAVE();
+}
+
+uint32_t SysTickValueGet(void)
+{
+    uint64_t now, next;
+
+    HostPoll();
+    now = NowNs();
+    next = sysTickStartNs + CyclesToNs((sysTickCount + 1)*sysTickPeriod);
+    if(!sysTickEnabled || next <= now)
+    {
+        return 0;
+    }
+    return (uint32_t)((next - now)*clockHz/NS_PER_SECOND);
+}
+
+/*Interrupt controller*/
+
+bool IntMasterEnable(void)
+{
+    bool wasMasked = masked;
+
+    masked = false;
+    HostPoll();
+    return wasMasked;
+}
+
+bool IntMasterDisable(void)
+{
+    bool wasMasked = masked;
+
+    masked = true;
+    return wasMasked;
+}
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+    if(ui32Interrupt == INT_UART4)
+        nvicEnabled[HOST_INT_UART4] = true;
+    else if(ui32Interrupt == INT_ADC0SS3)
+        nvicEnabled[HOST_INT_ADC0SS3] = true;
+    HostPoll();
+}
+
+void IntDisable(uint32_t ui32Interrupt)
+{
+    if(ui32Interrupt == INT_UART4)
+        nvicEnabled[HOST_INT_UART4] = false;
+    else if(ui32Interrupt == INT_ADC0SS3)
+        nvicEnabled[HOST_INT_ADC0SS3] = false;
+}
+
+/*UART4 is the link, UART0 the statistics output*/
+
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+    (void)ui32Base;
+    (void)ui32Source;
+}
+
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk, uint32_t ui32Baud, uint32_t ui32Config)
+{
+    (void)ui32UARTClk;
+    (void)ui32Config;
+    if(ui32Base == UART4_BASE)
+    {
+        HOST_ENTER();
+        uartBaud = ui32Baud;
+        rxNextNs = 0;
+        HOST_LEAVE();
+    }
+}
+
+void UARTFIFOEnable(uint32_t ui32Base)
+{
+    (void)ui32Base;
+}
+
+void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel, uint32_t ui32RxLevel)
+{
+    (void)ui32Base;
+    (void)ui32TxLevel;
+    (void)ui32RxLevel;
+}
+
+void UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+    (void)ui32Base;
+    (void)ui32Mode;
+}
+
+void UARTEnable(uint32_t ui32Base)
+{
+    (void)ui32Base;
+}
+
+void UARTIntRegister(uint32_t ui32Base, void (*pfnHandler)(void))
+{
+    if(ui32Base == UART4_BASE)
+    {
+        handlers[HOST_INT_UART4] = pfnHandler;
+        nvicEnabled[HOST_INT_UART4] = true;
+    }
+}
+
+void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    if(ui32Base == UART4_BASE)
+    {
+        HOST_ENTER();
+        uartIntMask |= ui32IntFlags;
+        HOST_LEAVE();
+    }
+}
+
+void UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    if(ui32Base == UART4_BASE)
+    {
+        HOST_ENTER();
+        uartIntMask &= ~ui32IntFlags;
+        HOST_LEAVE();
+    }
+}
+
+uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    if(ui32Base != UART4_BASE)
+    {
+        return 0;
+    }
+    return bMasked ? (uartIntStatus & uartIntMask) : uartIntStatus;
+}
+
+void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    if(ui32Base == UART4_BASE)
+    {
+        HOST_ENTER();
+        uartIntStatus &= ~ui32IntFlags;
+        HOST_LEAVE();
+    }
+}
+
+uint32_t UARTRxErrorGet(uint32_t ui32Base)
+{
+    return (ui32Base == UART4_BASE) ? uartRxErrors : 0;
+}
+
+void UARTRxErrorClear(uint32_t ui32Base)
+{
+    if(ui32Base == UART4_BASE)
+    {
+        HOST_ENTER();
+        uartRxErrors = 0;
+        HOST_LEAVE();
+    }
+}
+
+bool UARTCharsAvail(uint32_t ui32Base)
+{
+    HostPoll();
+    return ui32Base == UART4_BASE && rxCount > 0;
+}
+
+bool UARTSpaceAvail(uint32_t ui32Base)
+{
+    HostPoll();
+    return ui32Base != UART4_BASE || txCount < FIFO_BYTES;
+}
+
+bool UARTBusy(uint32_t ui32Base)
+{
+    HostPoll();
+    return ui32Base == UART4_BASE && txCount > 0;
+}
+
+int32_t UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    int32_t byte = -1;
+
+    HOST_ENTER();
+    if(ui32Base == UART4_BASE && rxCount != 0)
+    {
+        byte = rxFifo[rxHead];
+        rxHead = (rxHead + 1) % FIFO_BYTES;
+        rxCount--;
+    }
+    HOST_LEAVE();
+    return byte;
+}
+
+bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    uint64_t now;
+    bool put = true;
+
+    HOST_ENTER();
+    if(ui32Base != UART4_BASE)
+    {
+        /*UART0: the statistics are written line by line, so the lines of the two processes do not mix*/
+        if(getenv("LAB3_UART0") != NULL && uart0Length < sizeof(uart0Line))
+        {
+            uart0Line[uart0Length++] = ucData;
+            if(ucData == '\n' || uart0Length == sizeof(uart0Line))
+            {
+                fprintf(stderr, "%s: %.*s", isReceiver ? "receiver" : "sender", (int)uart0Length, uart0Line);
+                uart0Length = 0;
+            }
+        }
+    }
+    else if(txCount == FIFO_BYTES)
+    {
+        put = false;
+    }
+    else
+    {
+        if(txCount == 0)
+        {
+            now = NowNs();
+            txDoneNs = ((txDoneNs > now) ? txDoneNs : now) + ByteNs();
+        }
+        txFifo[(txHead + txCount) % FIFO_BYTES] = ucData;
+        txCount++;
+    }
+    HOST_LEAVE();
+    return put;
+}
+
+int32_t UARTCharGet(uint32_t ui32Base)
+{
+    while(!UARTCharsAvail(ui32Base))
+    {
+    }
+    return UARTCharGetNonBlocking(ui32Base);
+}
+
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    while(!UARTSpaceAvail(ui32Base))
+    {
+    }
+    UARTCharPutNonBlocking(ui32Base, ucData);
+}
@@ -0,0 +1,251 @@
+/******************************************************************************************************************
+ * File name: linkstats.c
+ * Description : Link statistics described in linkstats.h. The functions do not use any peripheral, so they can also be
+ * built on a host computer.
+ * References: [1]Phil Karn and Craig Partridge, Improving Round-Trip Time Estimates in Reliable Transport Protocols,
+ *                ACM SIGCOMM 1987
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+#include "linkstats.h"
+
+static void LinkStatsAppendText(char *pcText, uint32_t *pui32Length, uint32_t ui32Size, const char *pcString);
+static void LinkStatsAppendNumber(char *pcText, uint32_t *pui32Length, uint32_t ui32Size, uint32_t ui32Value);
+
+/*Names of the counters in the text of LinkStatsFormat(), in the order of tLinkStats from ui32Milliseconds to
+ * ui32RoundTripMax*/
+static const char * const ppcLinkStatsNames[] =
+{
+    " ms ", " baud ", " sent ", " received ", " crc ", " framing ", " retransmitted ", " timeouts ", " overruns ",
+    " line ", " rxlost ", " txfull ", " rtt ", " min ", " max "
+};
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsInit()
+ * Inputs : psStats
+ * Outputs : none
+ * Description : This function clears all counters and the histogram of psStats.
+ ***************************************************************************************************************************/
+
+void LinkStatsInit(tLinkStats *psStats)
+{
+    uint32_t *pui32Words = (uint32_t *)psStats;
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < LINK_STATS_WORDS; ui32Index++)
+    {
+        pui32Words[ui32Index] = 0;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsBucket()
+ * Inputs : ui32Microseconds
+ * Outputs : index of the histogram bucket of the round trip time ui32Microseconds
+ * Description : The index is the position of the highest bit set, which is the base 2 logarithm rounded down, limited to
+ * the last bucket.
+ ***************************************************************************************************************************/
+
+uint32_t LinkStatsBucket(uint32_t ui32Microseconds)
+{
+    uint32_t ui32Bucket = 0;
+
+    while(ui32Microseconds > 1 && ui32Bucket < LINK_STATS_BUCKETS - 1)
+    {
+        ui32Microseconds >>= 1;
+        ui32Bucket++;
+    }
+    return ui32Bucket;
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsRoundTrip()
+ * Inputs : psStats, ui32Microseconds
+ * Outputs : none
+ * Description : This function counts a measured round trip time in the histogram of psStats and updates the shortest and
+ * longest time.
+ ***************************************************************************************************************************/
+
+void LinkStatsRoundTrip(tLinkStats *psStats, uint32_t ui32Microseconds)
+{
+    if(psStats->ui32RoundTrips == 0 || ui32Microseconds < psStats->ui32RoundTripMin)
+    {
+        psStats->ui32RoundTripMin = ui32Microseconds;
+    }
+    if(ui32Microseconds > psStats->ui32RoundTripMax)
+    {
+        psStats->ui32RoundTripMax = ui32Microseconds;
+    }
+    psStats->ui32RoundTrips++;
+    psStats->pui32RoundTrip[LinkStatsBucket(ui32Microseconds)]++;
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsSetQuery()
+ * Inputs : psFrame, ui8Node
+ * Outputs : none
+ * Description : This function sets psFrame to a query of the statistics of the node with address ui8Node.
+ ***************************************************************************************************************************/
+
+void LinkStatsSetQuery(tFrame *psFrame, uint8_t ui8Node)
+{
+    psFrame->ui8Type = FRAME_TYPE_STATS;
+    psFrame->ui8Sequence = 0;
+    psFrame->ui8Address = ui8Node;
+    psFrame->ui8Length = 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsSetFrame()
+ * Inputs : psFrame, psStats, ui8Node, ui32First
+ * Outputs : index of the first word of the next frame, 0 after the last frame
+ * Description : This function sets psFrame to the answer of node ui8Node that carries the words of psStats from index
+ * ui32First on. The answer to a query is sent with ui32First = 0 and then with the returned index until it is 0.
+ ***************************************************************************************************************************/
+
+uint32_t LinkStatsSetFrame(tFrame *psFrame, const tLinkStats *psStats, uint8_t ui8Node, uint32_t ui32First)
+{
+    const uint32_t *pui32Words = (const uint32_t *)psStats;
+    uint32_t ui32Index, ui32Last;
+    uint8_t *pui8Payload = psFrame->pui8Payload;
+
+    ui32Last = ui32First + LINK_STATS_WORDS_PER_FRAME;
+    if(ui32Last > LINK_STATS_WORDS)
+    {
+        ui32Last = LINK_STATS_WORDS;
+    }
+
+    psFrame->ui8Type = FRAME_TYPE_STATS;
+    psFrame->ui8Sequence = 0;
+    psFrame->ui8Address = ui8Node;
+    *pui8Payload++ = ui32First;
+    for(ui32Index = ui32First; ui32Index < ui32Last; ui32Index++)
+    {
+        *pui8Payload++ = pui32Words[ui32Index];
+        *pui8Payload++ = pui32Words[ui32Index] >> 8;
+        *pui8Payload++ = pui32Words[ui32Index] >> 16;
+        *pui8Payload++ = pui32Words[ui32Index] >> 24;
+    }
+    psFrame->ui8Length = 1 + (ui32Last - ui32First)*4;
+
+    return (ui32Last < LINK_STATS_WORDS) ? ui32Last : 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsGetFrame()
+ * Inputs : psStats, psFrame
+ * Outputs : true if psFrame carries the last word of the statistics
+ * Description : This function copies the words of an answer psFrame to psStats. Words beyond the end of tLinkStats are
+ * ignored. When the last word has arrived psStats holds the statistics of the node, or of two answers if a frame of the
+ * last answer has been lost.
+ ***************************************************************************************************************************/
+
+bool LinkStatsGetFrame(tLinkStats *psStats, const tFrame *psFrame)
+{
+    uint32_t *pui32Words = (uint32_t *)psStats;
+    const uint8_t *pui8Payload = &psFrame->pui8Payload[1];
+    uint32_t ui32Index, ui32Last;
+
+    if(psFrame->ui8Length < 5)
+    {
+        return false;
+    }
+    ui32Index = psFrame->pui8Payload[0];
+    ui32Last = ui32Index + (psFrame->ui8Length - 1)/4;
+
+    for(; ui32Index < ui32Last && ui32Index < LINK_STATS_WORDS; ui32Index++)
+    {
+        pui32Words[ui32Index] = (uint32_t)pui8Payload[0] | ((uint32_t)pui8Payload[1] << 8) |
+                                ((uint32_t)pui8Payload[2] << 16) | ((uint32_t)pui8Payload[3] << 24);
+        pui8Payload += 4;
+    }
+    return ui32Last >= LINK_STATS_WORDS;
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsFormat()
+ * Inputs : psStats, ui32Node, pcText, ui32Size
+ * Outputs : length of the text without the terminating 0
+ * Description : This function writes the statistics of node ui32Node (0 for the sender) as one line of text ending in
+ * "\r\n" to pcText, which has room for ui32Size characters including the terminating 0. The counters are followed by the
+ * buckets of the histogram that are not empty, each as the shortest time of the bucket in us and the number of times,
+ * for example
+ * node 1 ms 5000 baud 5000000 sent 4120 received 4118 ... rtt 4100 min 130 max 610 | 128:3900 256:190 512:10
+ * A text longer than ui32Size is cut off. LINK_STATS_TEXT_MAX is enough for any statistics.
+ ***************************************************************************************************************************/
+
+uint32_t LinkStatsFormat(const tLinkStats *psStats, uint32_t ui32Node, char *pcText, uint32_t ui32Size)
+{
+    const uint32_t *pui32Words = (const uint32_t *)psStats;
+    uint32_t ui32Length = 0, ui32Index;
+
+    if(ui32Size == 0)
+    {
+        return 0;
+    }
+
+    LinkStatsAppendText(pcText, &ui32Length, ui32Size, "node ");
+    LinkStatsAppendNumber(pcText, &ui32Length, ui32Size, ui32Node);
+    for(ui32Index = 0; ui32Index < sizeof(ppcLinkStatsNames)/sizeof(ppcLinkStatsNames[0]); ui32Index++)
+    {
+        LinkStatsAppendText(pcText, &ui32Length, ui32Size, ppcLinkStatsNames[ui32Index]);
+        LinkStatsAppendNumber(pcText, &ui32Length, ui32Size, pui32Words[ui32Index]);
+    }
+
+    LinkStatsAppendText(pcText, &ui32Length, ui32Size, " |");
+    for(ui32Index = 0; ui32Index < LINK_STATS_BUCKETS; ui32Index++)
+    {
+        if(psStats->pui32RoundTrip[ui32Index] != 0)
+        {
+            LinkStatsAppendText(pcText, &ui32Length, ui32Size, " ");
+            LinkStatsAppendNumber(pcText, &ui32Length, ui32Size, (ui32Index == 0) ? 0 : (1UL << ui32Index));
+            LinkStatsAppendText(pcText, &ui32Length, ui32Size, ":");
+            LinkStatsAppendNumber(pcText, &ui32Length, ui32Size, psStats->pui32RoundTrip[ui32Index]);
+        }
+    }
+    LinkStatsAppendText(pcText, &ui32Length, ui32Size, "\r\n");
+
+    pcText[ui32Length] = 0;
+    return ui32Length;
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsAppendText()
+ * Inputs : pcText, pui32Length, ui32Size, pcString
+ * Outputs : none
+ * Description : This function appends pcString to the *pui32Length characters of pcText as far as there is room for it
+ * and a terminating 0.
+ ***************************************************************************************************************************/
+
+static void LinkStatsAppendText(char *pcText, uint32_t *pui32Length, uint32_t ui32Size, const char *pcString)
+{
+    while(*pcString != 0 && *pui32Length + 1 < ui32Size)
+    {
+        pcText[(*pui32Length)++] = *pcString++;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkStatsAppendNumber()
+ * Inputs : pcText, pui32Length, ui32Size, ui32Value
+ * Outputs : none
+ * Description : This function appends ui32Value in decimal digits to pcText like LinkStatsAppendText().
+ ***************************************************************************************************************************/
+
+static void LinkStatsAppendNumber(char *pcText, uint32_t *pui32Length, uint32_t ui32Size, uint32_t ui32Value)
+{
+    /*digits of the value from the last one, at most 10 digits and the terminating 0*/
+    char pcDigits[11];
+    uint32_t ui32Digit = sizeof(pcDigits) - 1;
+
+    pcDigits[ui32Digit] = 0;
+    do
+    {
+        pcDigits[--ui32Digit] = '0' + ui32Value%10;
+        ui32Value /= 10;
+    } while(ui32Value != 0);
+
+    LinkStatsAppendText(pcText, pui32Length, ui32Size, &pcDigits[ui32Digit]);
+}
@@ -0,0 +1,66 @@
+/******************************************************************************************************************
+ * File name: linkstats.h
+ * Description : Health counters of the UART link and a histogram of the acknowledgement round trip times.
+ *
+ * Every board keeps one tLinkStats. The counters count from start up and wrap around at 2^32. The round trip time is
+ * the time from the first transmission of a sample or batch frame to the acknowledgement that confirms it, measured by
+ * the sender in microseconds. Frames that have been sent more than once are not measured, because the acknowledgement
+ * cannot be matched to one of the transmissions (Karn's algorithm). The times are counted in LINK_STATS_BUCKETS buckets
+ * of powers of two: bucket 0 holds 0 and 1us, bucket i the times from 2^i to 2^(i+1) - 1us, and the last bucket all
+ * longer times. The histogram takes a fixed 64 bytes and never needs a division.
+ *
+ * The statistics of a display node are read by the sender with a stats frame (FRAME_TYPE_STATS, frame.h) without
+ * payload addressed to the node. The node answers with stats frames carrying its address, each with up to
+ * LINK_STATS_WORDS_PER_FRAME words of its tLinkStats: byte 0 of the payload is the index of the first word and the words
+ * follow, low byte first. LinkStatsFormat() turns the statistics of a board into one line of text. The functions do not
+ * use any peripheral, so they can also be built on a host computer.
+ *********************************************************************************************************************/
+
+#ifndef LINKSTATS_H_
+#define LINKSTATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+
+/*Number of round trip time buckets. The last one holds the times of 2^15us = 33ms and more*/
+#define LINK_STATS_BUCKETS          16
+
+/*Statistics of one board. Only uint32_t members, so the structure is also an array of LINK_STATS_WORDS words*/
+typedef struct
+{
+    uint32_t ui32Milliseconds;      /*time since start up when the statistics were taken*/
+    uint32_t ui32Baud;              /*rate of the link*/
+    uint32_t ui32FramesSent;        /*frames queued for transmission, including the ones passed on, without self test*/
+    uint32_t ui32FramesReceived;    /*valid frames received*/
+    uint32_t ui32CRCErrors;         /*frames dropped by the CRC check*/
+    uint32_t ui32FramingErrors;     /*frames dropped because they were too long, too short or badly encoded*/
+    uint32_t ui32Retransmissions;   /*sample and batch frames sent again, sender only*/
+    uint32_t ui32Timeouts;          /*retransmission timeouts, sender only*/
+    uint32_t ui32Overruns;          /*receive interrupts that found a UART receive FIFO overrun, one or more bytes lost*/
+    uint32_t ui32LineErrors;        /*receive interrupts that found a framing, parity or break error*/
+    uint32_t ui32RxRingOverflows;   /*bytes lost because the receive ring was full*/
+    uint32_t ui32TxRingFull;        /*frames that did not fit in the transmit ring*/
+    uint32_t ui32RoundTrips;        /*round trip times measured, sender only*/
+    uint32_t ui32RoundTripMin;      /*shortest and longest round trip time in us*/
+    uint32_t ui32RoundTripMax;
+    uint32_t pui32RoundTrip[LINK_STATS_BUCKETS];
+} tLinkStats;
+
+/*Number of words of tLinkStats, the words one stats frame carries and the frames a node needs for its statistics*/
+#define LINK_STATS_WORDS            (sizeof(tLinkStats)/sizeof(uint32_t))
+#define LINK_STATS_WORDS_PER_FRAME  ((FRAME_MAX_PAYLOAD - 1)/4)
+#define LINK_STATS_FRAMES           ((LINK_STATS_WORDS + LINK_STATS_WORDS_PER_FRAME - 1)/LINK_STATS_WORDS_PER_FRAME)
+
+/*Longest line of text of LinkStatsFormat(), including the terminating 0*/
+#define LINK_STATS_TEXT_MAX         640
+
+void LinkStatsInit(tLinkStats *psStats);
+uint32_t LinkStatsBucket(uint32_t ui32Microseconds);
+void LinkStatsRoundTrip(tLinkStats *psStats, uint32_t ui32Microseconds);
+void LinkStatsSetQuery(tFrame *psFrame, uint8_t ui8Node);
+uint32_t LinkStatsSetFrame(tFrame *psFrame, const tLinkStats *psStats, uint8_t ui8Node, uint32_t ui32First);
+bool LinkStatsGetFrame(tLinkStats *psStats, const tFrame *psFrame);
+uint32_t LinkStatsFormat(const tLinkStats *psStats, uint32_t ui32Node, char *pcText, uint32_t ui32Size);
+
+#endif /* LINKSTATS_H_ */
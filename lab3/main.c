@@ -15,11 +15,45 @@
  * program is written to run on both sender and receiver. The program identifies the board using a configuration
  * pin, PE3. If PE3 is connected to VCC, that board acts as receiver else it acts as sender. The sender reads the
  * input voltage value from the potentiometer through port pin PE5 and the 12-bit ADC(ADC0) converts the input
- * analog voltage to a 12 bit digital value. The digital value is stored in a variable and is compared against
- * 11 characters which represent different voltage levels read from the potentiometer. The character corresponding
- * to the converted digital value is send to the receiver via UART(UART4). The receiver compares the received
- * character with the predefined set of characters and lights the LED bar to represent the analog voltage read from 
- * sender. Also the receiver sends back an acknowledgement to sender and sender turns on the blue LED for one second.
+ * analog voltage to a 12 bit digital value. The values are collected in batches of SAMPLE_BATCH_SIZE consecutive
+ * values. When the batch changes the number of LEDs the receiver shows, which follows the values with a hysteresis of
+ * LED_BAR_HYSTERESIS (quantizer.h) so that noise around the limit between two LEDs is ignored, the batch is sent to the
+ * receiver via UART(UART4) in a batch frame (frame.h), which carries the full 12 bit values as
+ * one value and the differences between the following ones, a sequence number and a CRC-8, and is delimited so that
+ * the receiver finds the start of the next frame after a lost or corrupted byte. The receiver decodes the frames,
+ * drops the corrupted ones, expands the batch and lights the LED bar to represent the latest analog voltage read from
+ * sender. Also the receiver sends back an acknowledgement frame to sender and
+ * sender turns on the blue LED for one second. Up to ARQ_WINDOW_SIZE sample frames may be on their way without an
+ * acknowledgement (arq.h). The receiver acknowledges the last frame received in order, drops repeated frames and frames
+ * after a lost one, and the sender sends the frames again that have not been acknowledged within ARQ_TIMEOUT_MS.
+ * Timer0 triggers a conversion of the potentiometer ADC_SAMPLE_RATE_HZ times per second, the ADC averages
+ * ADC_OVERSAMPLE conversions in hardware and its interrupt handler stores the value in a sample ring, so the sampling
+ * instant does not depend on what the main loop is doing and the CPU never waits for the ADC. SysTick is the time base
+ * of the link and turns the blue LED off again, and a change of the potentiometer reaches the LED bar within a few
+ * milliseconds.
+ * Several receivers, the display nodes, can show the potentiometer of one sender. The boards are connected in a ring
+ * (daisy chain): the sender transmits to node 1, every node transmits to the next one and the last node transmits back
+ * to the sender, so one receiver is the usual two wire connection. Every frame carries the address of a node (frame.h).
+ * A node delivers the batch frames addressed to it and passes on all other frames, and its acknowledgements travel on
+ * around the ring to the sender. The sender numbers and retransmits the frames of every node separately, so every node
+ * acknowledges its own frames. A frame is passed on as soon as it has been received, so the delay to a node grows by
+ * one frame time per node before it.
+ * All boards run from the PLL at 80MHz and clock UART4 from the system clock. They start at LINK_START_BAUD. The sender
+ * proposes the highest rate of pui32LinkBaudRates up to LINK_BAUD_MAX in a request that travels around the ring, where
+ * every node takes the next address and lowers the rate to its own LINK_BAUD_MAX. When the request comes back the sender
+ * knows the number of nodes and the rate all of them accept, and sends an accept frame around the ring, which every node
+ * passes on before it switches. The sender checks the new rate with a confirm frame and a throughput self test of
+ * LINK_SELF_TEST_MS, both of which must come back around the ring. If the confirmation does not come back or the self
+ * test loses frames, all boards go back to LINK_START_BAUD and the sender proposes the next lower rate. A board that
+ * receives nothing at the new rate for LINK_IDLE_TIMEOUT_MS also goes back to LINK_START_BAUD, so the link is set up
+ * again when one of the boards is reset.
+ * Every board counts the frames it sends and receives, the corrupted frames, the bytes lost in the UART and the
+ * retransmissions, and the sender measures the round trip time of the acknowledgements in a histogram (linkstats.h).
+ * Every LINK_STATS_DUMP_MS, or when a character is received from the PC, each board writes its statistics as a line of
+ * text to UART0, the virtual COM port of the debugger. The sender also asks every node for its statistics with a stats
+ * frame and writes their answers too, so a terminal on the sender shows the whole ring.
+ * The UART interrupt handler never waits. Received bytes are stored in a receive ring buffer and bytes to be sent are
+ * taken from a transmit ring buffer, and the main loop of each board reads and writes the rings.
  *  References: [1]Embedded System Design using TM4C LaunchPadTM Development Kit,SSQU015(Canvas file)
  *              [2]Tiva C Series TM4C123G LaunchPad Evaluation Board User's Guide
  *              [3]Tiva TM4C123GH6PM Microcontroller datasheet
@@ -38,24 +72,211 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/uart.h"
 #include "driverlib/interrupt.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
 #include "inc/hw_ints.h"
+#include "frame.h"
+#include "arq.h"
+#include "quantizer.h"
+#include "linkstats.h"
+#include "ring.h"
 
+/*SysTick rate, which is the time base of the link, and the time the blue LED stays on after an acknowledgement*/
+#define TICK_RATE_HZ        1000
+#define LED_ON_TIME_MS      1000
+
+/*Rate at which Timer0 triggers the conversion of the potentiometer and number of conversions the ADC averages in
+ * hardware for every sample (1, 2, 4 ... 64). A conversion takes 1us, so 64 conversions allow up to 15kHz*/
+#define ADC_SAMPLE_RATE_HZ      1000
+#define ADC_OVERSAMPLE          64
+
+/*Number of LEDs of the LED bar, largest ADC value and hysteresis of the number of LEDs lit, in ADC codes. The number
+ * only changes when the value is more than LED_BAR_HYSTERESIS beyond the limit between two LEDs, so noise and small
+ * movements of the potentiometer around a limit neither make the LED bar flicker nor are sent to the receiver. 32 codes
+ * are 26mV, 8% of the step between two LEDs, and about four standard deviations of the noise that host/QuantizerSim.c
+ * shows to be filtered completely*/
+#define LED_BAR_LEDS            10
+#define ADC_FULL_SCALE          4095
+#define LED_BAR_HYSTERESIS      32
+
+/*Upper limit of the digital values for i LEDs lit, the LED_BAR_LEDS equal intervals of the ADC range rounded*/
+#define LED_THRESHOLD(i)        QUANTIZER_THRESHOLD(i, LED_BAR_LEDS, ADC_FULL_SCALE)
+
+/*Number of consecutive samples sent together in one batch frame, at most FRAME_MAX_BATCH. A batch of 8 samples that
+ * change by less than 64 codes between samples takes 14 bytes on the line instead of 56 for 8 sample frames, but the
+ * first sample of a batch reaches the receiver SAMPLE_BATCH_SIZE - 1 sample periods later. 1 sends every sample on its
+ * own*/
+#define SAMPLE_BATCH_SIZE       8
+
+/*Number of sample frames the sender may send to one node before it needs an acknowledgement, and the time after which
+ * the frames that have not been acknowledged are sent again, for one node and added for every further node of the
+ * ring. Eight sample frames take 4.9ms at 115200 baud, and with a batch frame for every node a frame takes 2.5ms longer
+ * around the ring for every further node (host/ChainSim.c)*/
+#define ARQ_WINDOW_SIZE         8
+#define ARQ_TIMEOUT_MS          10
+#define ARQ_HOP_TIMEOUT_MS      3
+
+/*Largest number of display nodes the sender serves. Nodes after the first CHAIN_MAX_NODES pass the frames on but show
+ * nothing. Every node takes the memory of one window at the sender*/
+#define CHAIN_MAX_NODES         8
+
+/*System clock, 400MHz PLL/2/2.5. UART4 is clocked from it, and rates up to a sixteenth of it (5Mbaud) use the normal
+ * 16x oversampling. TivaWare switches to 8x oversampling (high speed mode) for rates up to 10Mbaud*/
+#define SYSTEM_CLOCK_HZ     80000000
+
+/*UART4 rate at start up and largest rate this board proposes or accepts. LINK_BAUD_MAX = LINK_START_BAUD keeps the link
+ * at the start rate*/
+#define LINK_START_BAUD     115200
+#define LINK_BAUD_MAX       5000000
+
+/*Link set up times. Link frames are repeated every LINK_RETRY_MS until they are answered. The sender gives up on a rate
+ * when the confirmation or the self test result has not arrived LINK_SWITCH_TIMEOUT_MS after the switch, and sends a
+ * keepalive frame when it has sent nothing for LINK_KEEPALIVE_MS. A board goes back to the start rate when it has received
+ * no valid frame for LINK_IDLE_TIMEOUT_MS*/
+#define LINK_RETRY_MS           20
+#define LINK_SWITCH_TIMEOUT_MS  200
+#define LINK_KEEPALIVE_MS       100
+#define LINK_IDLE_TIMEOUT_MS    500
+
+/*Duration of the throughput self test at a new rate (0 skips it) and the share of the test frames, in percent, that must
+ * arrive for the rate to be kept*/
+#define LINK_SELF_TEST_MS           1000
+#define LINK_SELF_TEST_MIN_PERCENT  99
+
+/*Interval at which every board writes its link statistics to UART0 (PA0/PA1) at STATS_BAUD_RATE, 8 data bits, 1 stop
+ * bit, no parity, and size of the buffer for the text, which must be a power of two. A line takes up to 56ms at 115200
+ * baud. The answer of a node to a query takes about 160 bytes on the link, 1.4% of a 115200 baud link once a second*/
+#define LINK_STATS_DUMP_MS      1000
+#define STATS_BAUD_RATE         115200
+#define STATS_TEXT_BUFFER_SIZE  1024
+
+/*State of the link at the sender*/
+typedef enum
+{
+    LINK_DOWN,          /*at LINK_START_BAUD, proposing a rate*/
+    LINK_ACCEPTING,     /*at LINK_START_BAUD, waiting for the acceptance to come back around the ring*/
+    LINK_SWITCHING,     /*at the new rate, waiting for the confirmation*/
+    LINK_TESTING,       /*at the new rate, running the self test*/
+    LINK_UP             /*at the new rate, sending samples*/
+} tLinkState;
+
+void ClockInit(void);
 void GPIOInit(void);
 void ADCInit(void);
 void UARTInit(void);
-void ConversionFunction(void);
+void ConversionFunction(uint16_t);
+void ADC0SS3IntHandler(void);
 void UARTIntHandler(void);
+void SysTickInit(void);
+void SysTickIntHandler(void);
 void SenderBoard(void);
 void ReceiverBoard(void);
-void SendToReceiver(uint8_t);
-void LightLEDBar(uint8_t);
+bool SendToReceiver(const uint16_t *, uint32_t);
+void LightLEDBar(uint32_t);
+bool SendFrame(const tFrame *);
+bool UARTSendByte(uint8_t);
+void UARTSetBaudRate(uint32_t);
+void LinkSend(uint8_t, uint32_t);
+void LinkFallBack(bool);
+void SenderLinkFrame(const tFrame *);
+void SenderLinkService(void);
+void ReceiverLinkFrame(const tFrame *);
+uint32_t MicrosecondsGet(void);
+void StatsInit(void);
+void StatsCollect(void);
+void StatsAnswer(void);
+void StatsService(void);
 
 /*variable that stores the configuration of pin PE3 to check whether the board is sender or receiver*/
 volatile uint32_t ui32ConfigPinStatus;
 
-/*variable that stores the character corresponding to the result of previous conversion. ui8ValueToReceiverPrevious is
- * set to an initial value 'z' (This value can be anything other than the values used for encoding at the sender.)*/
-volatile uint8_t ui8ValueToReceiverPrevious = 'z';
+/*limits between the numbers of LEDs lit, computed by the compiler. See LightLEDBar() for the values*/
+const uint16_t pui16LEDThreshold[LED_BAR_LEDS] =
+{
+    LED_THRESHOLD(0), LED_THRESHOLD(1), LED_THRESHOLD(2), LED_THRESHOLD(3), LED_THRESHOLD(4),
+    LED_THRESHOLD(5), LED_THRESHOLD(6), LED_THRESHOLD(7), LED_THRESHOLD(8), LED_THRESHOLD(9)
+};
+
+/*number of LEDs lit at the receiver. The sender keeps the number the receiver shows after the batches sent so far, which
+ * is the same because both quantizers see the same values in the same order*/
+tQuantizer sLEDQuantizer;
+
+/*samples of the batch being collected, their number and the number of batches that were not sent because the window of
+ * the sender was full*/
+uint16_t pui16SampleBatch[SAMPLE_BATCH_SIZE];
+uint32_t ui32BatchCount;
+uint32_t ui32BatchesDropped;
+
+/*retransmission state of the sender for every node, and of the receiver*/
+tArqSender psArqSender[CHAIN_MAX_NODES];
+tArqReceiver sArqReceiver;
+
+/*number of display nodes the sender serves, found by the link set up, and address of this board when it is a node,
+ * FRAME_ADDRESS_SENDER until the first link request has arrived. Frames a node has passed on and frames it could not pass
+ * on because its transmit ring was full*/
+uint32_t ui32ChainNodes;
+uint8_t ui8NodeAddress = FRAME_ADDRESS_SENDER;
+uint32_t ui32FramesForwarded;
+uint32_t ui32ForwardOverflowCount;
+
+/*decoder of the frames received on UART4. A board is either sender or receiver, so one decoder is enough*/
+tFrameDecoder sFrameDecoder;
+
+/*UART4 receive ring, written by UARTIntHandler and read by the main loop, and transmit ring, written by the main loop and
+ * read by UARTIntHandler*/
+tRingBuffer sUARTRxRing, sUARTTxRing;
+
+/*number of received bytes that were lost because the receive ring was full*/
+volatile uint32_t ui32RxOverflowCount;
+
+/*ADC samples waiting for the main loop, and number of samples that were lost because the ring was full*/
+tSampleRing sSampleRing;
+volatile uint32_t ui32SampleOverflowCount;
+
+/*number of SysTick interrupts since start up and the number of ticks the blue LED stays on*/
+volatile uint32_t ui32TickCount;
+volatile uint32_t ui32LEDTicksLeft;
+
+/*rates the sender proposes, from the highest. The last one must be LINK_START_BAUD*/
+const uint32_t pui32LinkBaudRates[] = {5000000, 2000000, 1000000, 460800, LINK_START_BAUD};
+#define LINK_BAUD_RATES     (sizeof(pui32LinkBaudRates)/sizeof(pui32LinkBaudRates[0]))
+
+/*state of the link at the sender, rate of UART4, index of the rate the sender proposes, rate all nodes have accepted,
+ * tick at which the current link step started, tick at which a link frame was repeated last and ticks at which a valid
+ * frame was received and a frame was sent last*/
+tLinkState eLinkState = LINK_DOWN;
+uint32_t ui32LinkBaud = LINK_START_BAUD;
+uint32_t ui32LinkRateIndex;
+uint32_t ui32LinkAcceptedBaud;
+uint32_t ui32LinkTimer;
+uint32_t ui32LinkRetryTick;
+uint32_t ui32LastRxTick;
+uint32_t ui32LastTxTick;
+
+/*results of the last self test, to be read with the debugger: test frames sent by the sender and received back after
+ * the trip around the ring, and bytes per second that arrived*/
+uint32_t ui32SelfTestFramesSent;
+uint32_t ui32SelfTestFramesReceived;
+uint32_t ui32SelfTestBytesPerSecond;
+
+/*link statistics of this board and the last ones received from every node. Bit n of ui32StatsPending is set while the
+ * statistics of node n (0 for this board) wait to be written to UART0. ui32StatsTick is the tick of the last dump*/
+tLinkStats sLinkStats;
+tLinkStats psNodeStats[CHAIN_MAX_NODES];
+uint32_t ui32StatsPending;
+uint32_t ui32StatsTick;
+
+/*number of UART4 receive interrupts in which the receive FIFO had overflowed, and in which bytes with a framing, parity
+ * or break error had been received*/
+volatile uint32_t ui32UARTOverrunCount;
+volatile uint32_t ui32UARTLineErrorCount;
+
+/*text of the statistics waiting for UART0. ui32StatsTextHead and ui32StatsTextTail count the characters written and
+ * sent like the indices of tRingBuffer. pcStatsLine holds the line being formatted*/
+uint8_t pui8StatsText[STATS_TEXT_BUFFER_SIZE];
+uint32_t ui32StatsTextHead;
+uint32_t ui32StatsTextTail;
+char pcStatsLine[LINK_STATS_TEXT_MAX];
 
 
 /***************************************************************************************************************************
@@ -67,16 +288,22 @@ volatile uint8_t ui8ValueToReceiverPrevious = 'z';
  * LED bar output pins : PA7, PA6, PB7, PB6, PB5, PB4, PB3, PB2, PB1, PB0(From MSB to LSB in order)
  * UART receiver and transmitter pins : PC4 and PC5
  * Blue LED output pin : PF2
- * Description : This function initializes the GPIO ports, ADC0 and UART4 modules. Also it determines the board is a sender
+ * Description : This function sets the system clock to 80MHz and initializes the GPIO ports, ADC0, UART4 and SysTick
+ * modules, the UART0 output of the link statistics and the retransmission state of both boards. Also it determines the board is a sender
  * or receiver by checking the configuration pin. If configuration pin is connected to VCC it is receiver else it is sender.
  * Reference for APIs : TivaWare Peripheral Driver Library User guide
  ***************************************************************************************************************************/
 
 void main(void)
 {
+    ClockInit();
     GPIOInit();
     ADCInit();
     UARTInit();
+    SysTickInit();
+    StatsInit();
+    ArqReceiverInit(&sArqReceiver);
+    QuantizerInit(&sLEDQuantizer, pui16LEDThreshold, LED_BAR_LEDS, LED_BAR_HYSTERESIS);
 
     while(1)
     {
@@ -94,6 +321,20 @@ void main(void)
     }
 }
 
+/***************************************************************************************************************************
+ * Function name : ClockInit()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function sets the system clock to SYSTEM_CLOCK_HZ (80MHz) from the 16MHz crystal and the PLL. The
+ * 400MHz PLL output is divided by 2 and by the system divider 2.5.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+void ClockInit(void)
+{
+        SysCtlClockSet(SYSCTL_SYSDIV_2_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ);
+}
+
 /***************************************************************************************************************************
  * Function name : GPIOInit()
  * Inputs : none
@@ -130,21 +371,60 @@ void GPIOInit(void)
  * Inputs : none
  * Outputs : none
  * ADC module used : ADC0
- * Description : This function initializes the ADC0 module. For specifications check comments below.
+ * Timer used : Timer0A
+ * Description : This function initializes the ADC0 module and Timer0, which triggers the conversions. For specifications
+ * check comments below.
  * Reference for APIs : TivaWare Peripheral Driver Library User guide
  ***************************************************************************************************************************/
 
 void ADCInit(void)
 {
-        /*Enables ADC0 module, configures PE5 as ADC input, selects the sample sequencer 3, trigger source for conversion
-         * as processor trigger, sample sequencer priority as 0, selects sample sequencer step to be configured as 0, sample
-         * channel 8(ADC_CTL_CH8) and tells the ADC that this is the last conversion(ADC_CTL_END). Enables sample sequence 3*/
+        /*Enables ADC0 module and Timer0, configures PE5 as ADC input and lets the ADC average ADC_OVERSAMPLE conversions
+         * for every sample*/
         SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+        SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
         GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_5);
-        ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_PROCESSOR, 0);
-        ADCSequenceStepConfigure(ADC0_BASE, 3, 0, ADC_CTL_CH8 | ADC_CTL_END);
+        ADCHardwareOversampleConfigure(ADC0_BASE, ADC_OVERSAMPLE);
+
+        /*Selects the sample sequencer 3, trigger source for conversion as timer trigger, sample sequencer priority as 0,
+         * selects sample sequencer step to be configured as 0, sample channel 8(ADC_CTL_CH8), raises the interrupt at the
+         * end of the conversion(ADC_CTL_IE) and tells the ADC that this is the last conversion(ADC_CTL_END). Enables sample
+         * sequence 3 and its interrupt*/
+        ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_TIMER, 0);
+        ADCSequenceStepConfigure(ADC0_BASE, 3, 0, ADC_CTL_CH8 | ADC_CTL_IE | ADC_CTL_END);
         ADCSequenceEnable(ADC0_BASE, 3);
+        ADCIntRegister(ADC0_BASE, 3, ADC0SS3IntHandler);
+        ADCIntClear(ADC0_BASE, 3);
+        ADCIntEnable(ADC0_BASE, 3);
+
+        /*Configures Timer0A as periodic timer that triggers the ADC ADC_SAMPLE_RATE_HZ times per second*/
+        TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
+        TimerLoadSet(TIMER0_BASE, TIMER_A, SYSTEM_CLOCK_HZ/ADC_SAMPLE_RATE_HZ - 1);
+        TimerControlTrigger(TIMER0_BASE, TIMER_A, true);
+        TimerEnable(TIMER0_BASE, TIMER_A);
+}
+
+/***************************************************************************************************************************
+ * Function name : ADC0SS3IntHandler()
+ * Inputs : none
+ * Outputs : none
+ * Description : This is the interrupt handler for ADC0 sample sequencer 3. It is called when the averaged conversion
+ * triggered by Timer0 is complete and stores the value in sSampleRing. A value that does not fit in the ring is counted in
+ * ui32SampleOverflowCount and dropped.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+void ADC0SS3IntHandler(void)
+{
+    /*variable to store the converted ADC value*/
+    uint32_t pui32ADCValue[1];
 
+    ADCIntClear(ADC0_BASE, 3);
+    ADCSequenceDataGet(ADC0_BASE, 3, pui32ADCValue);
+    if(!SampleRingPut(&sSampleRing, pui32ADCValue[0]))
+    {
+        ui32SampleOverflowCount++;
+    }
 }
 
 /***************************************************************************************************************************
@@ -159,51 +439,207 @@ void ADCInit(void)
 void UARTInit(void)
 {
       /*Enables UART4 module and GPIO port C, configures PC4 and PC5 as uart rx and tx pins(since pin muxing functionality is
-       * present in the processor for theses two pins), selects the clock source to UART as Precision Internal Oscillator
-       * (PIOSC) which is 16MHz, configures PC4 and PC5 as UART rx and tx, selects uart clock as 16MHz and buadrate as 115200,
-       * defines the number of data bits - 8, stop bit -1 and no parity. */
+       * present in the processor for theses two pins), selects the clock source to UART as the 80MHz system clock, configures
+       * PC4 and PC5 as UART rx and tx, selects buadrate as LINK_START_BAUD (115200), defines the number of data bits - 8,
+       * stop bit -1 and no parity. */
        SysCtlPeripheralEnable(SYSCTL_PERIPH_UART4);
        SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOC);
        GPIOPinConfigure(GPIO_PC4_U4RX);
        GPIOPinConfigure(GPIO_PC5_U4TX);
-       UARTClockSourceSet(UART4_BASE, UART_CLOCK_PIOSC);
+       UARTClockSourceSet(UART4_BASE, UART_CLOCK_SYSTEM);
        GPIOPinTypeUART(GPIO_PORTC_BASE, GPIO_PIN_4 | GPIO_PIN_5);
-       UARTConfigSetExpClk(UART4_BASE, 16000000, 115200, (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
+       UARTConfigSetExpClk(UART4_BASE, SYSTEM_CLOCK_HZ, LINK_START_BAUD, (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+               UART_CONFIG_PAR_NONE));
+
+       /*Enables the 16 byte FIFOs. The receive interrupt occurs when the receive FIFO is half full (8 bytes), so one interrupt
+        * handles up to 8 bytes, and the receive timeout interrupt handles the bytes that remain in the FIFO when no further
+        * byte arrives for 32 bit periods. The transmit interrupt occurs when the transmit FIFO has drained to 4 bytes (2/8 of
+        * 16), which leaves 350us at 115200 baud and 8us at 5Mbaud to refill it before the line goes idle*/
+       UARTFIFOEnable(UART4_BASE);
+       UARTFIFOLevelSet(UART4_BASE, UART_FIFO_TX2_8, UART_FIFO_RX4_8);
+       UARTTxIntModeSet(UART4_BASE, UART_TXINT_MODE_FIFO);
 
-       /*Enables processor interrupts, enables UART receive interrupt, Registers UART interrupt handler, Enables UART4 module*/
+       /*Enables processor interrupts, enables UART receive and receive timeout interrupts, Registers UART interrupt handler,
+        * Enables UART4 module. The transmit interrupt is enabled by UARTSendByte() while the transmit ring has data*/
        IntMasterEnable();
-       UARTIntEnable(UART4_BASE, UART_INT_RX);
+       UARTIntEnable(UART4_BASE, UART_INT_RX | UART_INT_RT);
        UARTIntRegister(UART4_BASE, UARTIntHandler);
        UARTEnable(UART4_BASE);
 
 }
 
 
+/***************************************************************************************************************************
+ * Function name : UARTSendByte()
+ * Inputs : ui8Byte
+ * Outputs : true if the byte was queued, false if the transmit ring is full
+ * UART module used : UART4
+ * Description : This function queues a byte in the transmit ring and starts the transmission. The transmit interrupt only
+ * occurs when the FIFO drains below its trigger level, so if the FIFO has room the first bytes are written to it here. The
+ * UART4 interrupt is disabled while this is done, because the interrupt handler also takes bytes from the transmit ring.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+bool UARTSendByte(uint8_t ui8Byte)
+{
+    uint8_t ui8Next;
+
+    if(!RingPut(&sUARTTxRing, ui8Byte))
+    {
+        return false;
+    }
+
+    IntDisable(INT_UART4);
+    while(UARTSpaceAvail(UART4_BASE) && RingGet(&sUARTTxRing, &ui8Next))
+    {
+        UARTCharPutNonBlocking(UART4_BASE, ui8Next);
+    }
+    if(sUARTTxRing.ui32Head != sUARTTxRing.ui32Tail)
+    {
+        UARTIntEnable(UART4_BASE, UART_INT_TX);
+    }
+    IntEnable(INT_UART4);
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : UARTSetBaudRate()
+ * Inputs : ui32Baud
+ * Outputs : none
+ * UART module used : UART4
+ * Description : This function changes the rate of UART4. It first waits until the transmit ring and the transmit FIFO are
+ * empty, so that the frames queued before leave at the old rate. This takes at most 22ms at 115200 baud for a full ring,
+ * and less than 1ms for the link frames queued when the rate is changed. A partly received frame is discarded, because
+ * its end will not be received at the old rate.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+void UARTSetBaudRate(uint32_t ui32Baud)
+{
+    while(sUARTTxRing.ui32Head != sUARTTxRing.ui32Tail || UARTBusy(UART4_BASE))
+    {
+    }
+
+    IntDisable(INT_UART4);
+    UARTConfigSetExpClk(UART4_BASE, SYSTEM_CLOCK_HZ, ui32Baud, (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+            UART_CONFIG_PAR_NONE));
+    IntEnable(INT_UART4);
+
+    ui32LinkBaud = ui32Baud;
+    sFrameDecoder.ui32Length = 0;
+    sFrameDecoder.bOverflow = false;
+    ui32LastRxTick = ui32TickCount;
+}
+
+/***************************************************************************************************************************
+ * Function name : SendFrame()
+ * Inputs : psFrame
+ * Outputs : true if the frame was queued, false if the transmit ring has no room for the whole frame
+ * Description : This function encodes psFrame and queues the encoded bytes for transmission. A frame is queued completely or
+ * not at all, so the receiver never gets part of a frame. The frames sent and the frames that did not fit are counted in
+ * sLinkStats. Neither is counted in LINK_TESTING: the self test fills the transmit ring on purpose and counts its own frames
+ * in ui32SelfTestFramesSent, so they do not inflate the frame rate of the statistics.
+ ***************************************************************************************************************************/
+
+bool SendFrame(const tFrame *psFrame)
+{
+    uint8_t pui8Encoded[FRAME_MAX_ENCODED];
+    uint32_t ui32Length, ui32Index;
+
+    ui32Length = FrameEncode(psFrame, pui8Encoded);
+    if(RING_BUFFER_SIZE - (sUARTTxRing.ui32Head - sUARTTxRing.ui32Tail) < ui32Length)
+    {
+        if(eLinkState != LINK_TESTING)
+        {
+            sLinkStats.ui32TxRingFull++;
+        }
+        return false;
+    }
+    if(eLinkState != LINK_TESTING)
+    {
+        sLinkStats.ui32FramesSent++;
+    }
+    ui32LastTxTick = ui32TickCount;
+    for(ui32Index = 0; ui32Index < ui32Length; ui32Index++)
+    {
+        UARTSendByte(pui8Encoded[ui32Index]);
+    }
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : SysTickInit()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function configures SysTick to interrupt TICK_RATE_HZ times per second. The clock is 80MHz, so the
+ * period is SYSTEM_CLOCK_HZ/TICK_RATE_HZ clock cycles.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+void SysTickInit(void)
+{
+        SysTickPeriodSet(SYSTEM_CLOCK_HZ/TICK_RATE_HZ);
+        SysTickIntRegister(SysTickIntHandler);
+        SysTickIntEnable();
+        SysTickEnable();
+}
+
+/***************************************************************************************************************************
+ * Function name : SysTickIntHandler()
+ * Inputs : none
+ * Outputs : none
+ * Blue LED output pin : PF2
+ * Description : This is the SysTick ISR. It counts the ticks and turns off the blue LED when its on time is over.
+ ***************************************************************************************************************************/
+
+void SysTickIntHandler(void)
+{
+    ui32TickCount++;
+    if(ui32LEDTicksLeft != 0)
+    {
+        ui32LEDTicksLeft--;
+        if(ui32LEDTicksLeft == 0)
+        {
+            GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_2, 0x0);
+        }
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : MicrosecondsGet()
+ * Inputs : none
+ * Outputs : microseconds since start up, wrapping around after 71 minutes
+ * Description : This function adds the clock cycles SysTick has counted down since the last tick to the tick count. The
+ * tick count is read again after the SysTick value, so a tick interrupt in between is noticed and the read is repeated.
+ * Must not be called with interrupts disabled.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+uint32_t MicrosecondsGet(void)
+{
+    uint32_t ui32Ticks, ui32Value;
+
+    do
+    {
+        ui32Ticks = ui32TickCount;
+        ui32Value = SysTickValueGet();
+    } while(ui32Ticks != ui32TickCount);
+
+    return ui32Ticks*(1000000/TICK_RATE_HZ) +
+           (SYSTEM_CLOCK_HZ/TICK_RATE_HZ - 1 - ui32Value)/(SYSTEM_CLOCK_HZ/1000000);
+}
+
 /******************************************************************************************************************************
  * Function name : ConversionFunction()
- * Inputs : none
+ * Inputs : ui16Sample
  * Outputs : none
- * Description : This function triggers the ADC conversion and the converted value is stored in pui32ADCValue[0].
- * The total range of input voltages (0 to 3.3) has been divided into 10 equal intervals and for each interval the corresponding
- * digital value is calculated using below formula. The analog and digital values obtained and are listed below.
- *
- * Analog value(V)     Digital value  |       Range                 character to be send to receiver
- * 0                0                 |       ==0                   'a'
- * 0.33             410               |       >0 and <=410          'b'
- * 0.66             819               |       >410 and <=819        'c'
- * 0.99             1229              |       >819 and <=1229       'd'
- * 1.32             1638              |       >1229 and <=1638      'e'
- * 1.65             2048              |       >1638 and <=2048      'f'
- * 1.98             2457              |       >2048 and <=2457      'g'
- * 2.31             2867              |       >2457 and <=2867      'h'
- * 2.64             3276              |       >2867 and <=3276      'i'
- * 2.97             3686              |       >3276 and <=3686      'j'
- * 3.3              4095              |       >3686 and <=4095      'k'
- * The converted digital value is compared against the above given values to find out the character to be send to the receiver. The
- * range of digital values and character to be send to receiver are listed above. This character is stored in ui8ValueToReceiverCurrent.
- * Also the previous value of the character is stored in ui8ValueToReceiverPrevious.The previous and current values are compared and
- * the current value is send to receiver only if it is different from previous value.This is to prevent the receiver getting overloaded
- * by sending small changes in POT position.
+ * Description : This function handles one converted value ui16Sample taken from the sample ring. The value is
+ * added to the batch in pui16SampleBatch. When the batch holds SAMPLE_BATCH_SIZE values, a copy of sLEDQuantizer, the number
+ * of LEDs the receiver shows, is moved over the values of the batch. If the number changes, the batch is sent to the
+ * receiver with the full 12 bit resolution of every value and the copy becomes sLEDQuantizer. Otherwise the batch is
+ * discarded. This is to prevent the receiver getting overloaded by sending small changes in POT position, including noise
+ * around the limit between two LEDs. A batch that does not fit in the window is discarded without changing sLEDQuantizer,
+ * so the next batch is compared with what the receiver shows.
  *
  * Equation to convert the analog value to digital value[8] :
  * digital value =          [Vin - Vref(-)]*[2^N - 1]
@@ -217,52 +653,28 @@ void UARTInit(void)
  *                     Embedded Systems An Introduction using the Renesas RX63N Microcontroller BY JAMES M. CONRAD
  *******************************************************************************************************************************/
 
-void ConversionFunction(void)
+void ConversionFunction(uint16_t ui16Sample)
 {
-    /*variable to store the converted ADC value*/
-    uint32_t pui32ADCValue[1];
+    /*number of LEDs the receiver would show after the batch, and index of a value of the batch*/
+    tQuantizer sQuantizer;
+    uint32_t ui32Index;
 
-    /*variable to store the character to be send to the receiver*/
-    uint8_t ui8ValueToReceiverCurrent;
-
-
-    /*Starts ADC conversion by processor triggering, if ADC is not busy get the converted value to pui32ADCValue. compares
-     * pui32ADCValue with range of digital values to find the character to be send to the receiver */
-        ADCProcessorTrigger(ADC0_BASE, 3);
-        while(ADCBusy(ADC0_BASE))
-        {
-        }
-        ADCSequenceDataGet(ADC0_BASE, 3, pui32ADCValue);
-
-       if(pui32ADCValue[0] == 0)
-           ui8ValueToReceiverCurrent = 'a';
-       if(pui32ADCValue[0] > 0 && pui32ADCValue[0] <= 410)
-           ui8ValueToReceiverCurrent = 'b';
-       if(pui32ADCValue[0] > 410 && pui32ADCValue[0] <= 819)
-           ui8ValueToReceiverCurrent = 'c';
-       if(pui32ADCValue[0] > 819 && pui32ADCValue[0] <= 1229)
-           ui8ValueToReceiverCurrent = 'd';
-       if(pui32ADCValue[0] > 1229 && pui32ADCValue[0] <= 1638)
-           ui8ValueToReceiverCurrent = 'e';
-       if(pui32ADCValue[0] > 1638 && pui32ADCValue[0] <= 2048)
-           ui8ValueToReceiverCurrent = 'f';
-       if(pui32ADCValue[0] > 2048 && pui32ADCValue[0] <= 2457)
-           ui8ValueToReceiverCurrent = 'g';
-       if(pui32ADCValue[0] > 2457 && pui32ADCValue[0] <= 2867)
-           ui8ValueToReceiverCurrent = 'h';
-       if(pui32ADCValue[0] > 2867 && pui32ADCValue[0] <= 3276)
-           ui8ValueToReceiverCurrent = 'i';
-       if(pui32ADCValue[0] > 3276 && pui32ADCValue[0] <= 3686)
-           ui8ValueToReceiverCurrent = 'j';
-       if(pui32ADCValue[0] > 3686 && pui32ADCValue[0] <= 4095)
-           ui8ValueToReceiverCurrent = 'k';
-
-       /*if the current character to be send is not equal to the previous character, send the current character to
-        * receiver */
-       if(ui8ValueToReceiverPrevious != ui8ValueToReceiverCurrent)
+       /*adds the converted value to the batch*/
+       pui16SampleBatch[ui32BatchCount++] = ui16Sample;
+
+       /*when the batch is complete, send it to receiver if it changes the LED bar and start the next batch*/
+       if(ui32BatchCount == SAMPLE_BATCH_SIZE)
        {
-               ui8ValueToReceiverPrevious = ui8ValueToReceiverCurrent;
-               SendToReceiver(ui8ValueToReceiverCurrent);
+               sQuantizer = sLEDQuantizer;
+               for(ui32Index = 0; ui32Index < ui32BatchCount; ui32Index++)
+               {
+                   QuantizerUpdate(&sQuantizer, pui16SampleBatch[ui32Index]);
+               }
+               if(sQuantizer.ui32Level != sLEDQuantizer.ui32Level && SendToReceiver(pui16SampleBatch, ui32BatchCount))
+               {
+                   sLEDQuantizer = sQuantizer;
+               }
+               ui32BatchCount = 0;
        }
 }
 
@@ -271,37 +683,60 @@ void ConversionFunction(void)
  * Inputs : none
  * Outputs : none
  * UART module used : UART4
- * Acknowledgement character used : 'A'
- * Description : This is the ISR which is serviced when the receive interrupt is generated. This handler function is
- * declared and defined in tm4c123gh6pm_startup_ccs.c file. The handler first clears the interrupt generated. Afterwards it
- * identifies the sender and receiver boards, if it is a receiver board it calls the function to light the LED bar and also
- * sends an acknowledgement character 'A' to sender. If it is a sender board it checks the acknowledgemnet character and
- * lights the blue LED.
+ * Description : This is the ISR which is serviced when the receive, receive timeout or transmit interrupt is generated.
+ * The handler function is registered by UARTInit(). The handler first clears the interrupt generated. Afterwards it moves
+ * all bytes in the receive FIFO to the receive ring and fills the transmit FIFO from the transmit ring. The handler never
+ * waits: a byte that does not fit in the receive ring is counted in ui32RxOverflowCount and dropped, and when the transmit
+ * ring is empty the transmit interrupt is disabled. Bytes lost because the receive FIFO was full and bytes received with
+ * errors are counted for the link statistics. The received bytes are handled by ReceiverBoard() and SenderBoard().
  * Reference for APIs : TivaWare Peripheral Driver Library User guide
  ***************************************************************************************************************************/
 
 void UARTIntHandler(void)
 {
-    /*variable stores the status of receive interrupt*/
+    /*variable stores the status of the interrupt*/
     uint32_t ui32Status = UARTIntStatus(UART4_BASE, true);
 
-    /*clears receive interrupt*/
+    /*variables store the byte moved between a FIFO and a ring and the receive errors*/
+    uint8_t ui8Byte;
+    uint32_t ui32Errors;
+
+    /*clears the interrupt*/
     UARTIntClear(UART4_BASE, ui32Status);
 
-    /*if configuration pin status is 1, its a receiver board else it is a sender board. In the receiver board the LightLEDBar
-     * function is called and also sends an acknowledgement  back to the sender. In the sender board if it receives an 'A' then
-     * illuminate the blue LED*/
-    if(ui32ConfigPinStatus)
-     {
-        LightLEDBar(UARTCharGet(UART4_BASE));
-        UARTCharPut(UART4_BASE, 'A');
-     }
-    else
+    /*empties the receive FIFO into the receive ring*/
+    while(UARTCharsAvail(UART4_BASE))
     {
-        if(UARTCharGet(UART4_BASE) == 'A')
+        ui8Byte = UARTCharGetNonBlocking(UART4_BASE);
+        if(!RingPut(&sUARTRxRing, ui8Byte))
         {
-            GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_2, GPIO_PIN_2);
+            ui32RxOverflowCount++;
+        }
+    }
+
+    /*counts the receive errors that occurred since the last interrupt. The error flags stay set until they are cleared*/
+    ui32Errors = UARTRxErrorGet(UART4_BASE);
+    if(ui32Errors != 0)
+    {
+        if(ui32Errors & UART_RXERROR_OVERRUN)
+        {
+            ui32UARTOverrunCount++;
         }
+        if(ui32Errors & (UART_RXERROR_FRAMING | UART_RXERROR_PARITY | UART_RXERROR_BREAK))
+        {
+            ui32UARTLineErrorCount++;
+        }
+        UARTRxErrorClear(UART4_BASE);
+    }
+
+    /*fills the transmit FIFO from the transmit ring*/
+    while(UARTSpaceAvail(UART4_BASE) && RingGet(&sUARTTxRing, &ui8Byte))
+    {
+        UARTCharPutNonBlocking(UART4_BASE, ui8Byte);
+    }
+    if(sUARTTxRing.ui32Head == sUARTTxRing.ui32Tail)
+    {
+        UARTIntDisable(UART4_BASE, UART_INT_TX);
     }
 }
 
@@ -309,144 +744,685 @@ void UARTIntHandler(void)
  * Function name : SenderBoard()
  * Inputs : none
  * Outputs : none
- * Description : This function executes one second delay after the ISR turns on the blue LED. Then it turns off the blue LED.
- * After that it calls the ADC conversion function.
+ * Description : This function decodes the frames that come back around the ring and passes the link frames to
+ * SenderLinkFrame() and the acknowledgements to the retransmission of the node that sent them. Frames addressed to nodes
+ * that do not exist come back unchanged and are dropped. For every acknowledgement frame that confirms new sample frames it
+ * counts the round trip time and turns on the blue LED for LED_ON_TIME_MS. The answers of the nodes to the stats queries
+ * are collected in psNodeStats. SysTickIntHandler() turns the blue LED off again, so the sender never waits.
+ * Then SenderLinkService() sets up the link. The samples that ADC0SS3IntHandler() has stored in the sample ring since the last
+ * pass are passed to the conversion function when the link is up and dropped otherwise, and ArqService() sends the frames of
+ * the windows of all nodes that have not been sent or have timed out. The retransmission runs on the microsecond time of
+ * MicrosecondsGet(). Last StatsService() writes the statistics to UART0.
  * Reference for APIs : TivaWare Peripheral Driver Library User guide
  ***************************************************************************************************************************/
 
 void SenderBoard(void)
 {
-    /*One second delay: clock is configured as 16MHz. The SysCtlDelay(delay) function will create a delay for one second.
-     * the formula to calculate the delay is, delay = DelayTimeInSeconds/((1/16000000)*3). Here DelayTimeInSeconds = 1 second */
-    SysCtlDelay(16000000/3);
+    /*variables store the byte and the frame received from the ring, a sample taken from the sample ring and the index of
+     * a node*/
+    uint8_t ui8Received;
+    tFrame sFrame;
+    uint16_t ui16Sample;
+    uint32_t ui32Node, ui32RoundTrip;
+
+    /*handles link frames, and if an acknowledgement has been received then illuminate the blue LED and (re)start its on
+     * time*/
+    while(RingGet(&sUARTRxRing, &ui8Received))
+    {
+        if(!FrameDecodeByte(&sFrameDecoder, ui8Received, &sFrame))
+        {
+            continue;
+        }
+        ui32LastRxTick = ui32TickCount;
+        if(sFrame.ui8Type == FRAME_TYPE_LINK)
+        {
+            SenderLinkFrame(&sFrame);
+        }
+        else if(eLinkState == LINK_UP && sFrame.ui8Type == FRAME_TYPE_ACK && sFrame.ui8Address >= 1 &&
+                sFrame.ui8Address <= ui32ChainNodes &&
+                ArqAckReceived(&psArqSender[sFrame.ui8Address - 1], sFrame.ui8Sequence, MicrosecondsGet(),
+                               &ui32RoundTrip) != 0)
+        {
+            if(ui32RoundTrip != 0)
+            {
+                LinkStatsRoundTrip(&sLinkStats, ui32RoundTrip);
+            }
+            ui32LEDTicksLeft = LED_ON_TIME_MS*TICK_RATE_HZ/1000;
+            GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_2, GPIO_PIN_2);
+        }
+        else if(sFrame.ui8Type == FRAME_TYPE_STATS && sFrame.ui8Address >= 1 && sFrame.ui8Address <= ui32ChainNodes &&
+                LinkStatsGetFrame(&psNodeStats[sFrame.ui8Address - 1], &sFrame))
+        {
+            ui32StatsPending |= 1 << sFrame.ui8Address;
+        }
+    }
+
+    SenderLinkService();
+    StatsService();
+
+    /*Takes the samples converted since the last pass. Samples taken while the link is not up are dropped*/
+    while(SampleRingGet(&sSampleRing, &ui16Sample))
+    {
+        if(eLinkState == LINK_UP)
+        {
+            ConversionFunction(ui16Sample);
+        }
+    }
+    if(eLinkState != LINK_UP)
+    {
+        return;
+    }
+
+    /*sends the frames that did not fit in the transmit ring before and repeats the frames that timed out*/
+    for(ui32Node = 0; ui32Node < ui32ChainNodes; ui32Node++)
+    {
+        ArqService(&psArqSender[ui32Node], MicrosecondsGet());
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkSend()
+ * Inputs : ui8Command, ui32Parameter
+ * Outputs : none
+ * Description : This function sends a link frame with the FRAME_LINK_ command ui8Command and its parameter. Link frames are
+ * not numbered by the retransmission. A link frame that does not fit in the transmit ring is dropped, and is repeated by the
+ * link set up like a lost one.
+ ***************************************************************************************************************************/
+
+void LinkSend(uint8_t ui8Command, uint32_t ui32Parameter)
+{
+    tFrame sFrame;
+
+    FrameSetLink(&sFrame, ui8Command, ui32Parameter);
+    SendFrame(&sFrame);
+}
+
+/***************************************************************************************************************************
+ * Function name : LinkFallBack()
+ * Inputs : bNextRate
+ * Outputs : none
+ * Description : This function switches UART4 back to LINK_START_BAUD. The sender proposes the next lower rate if bNextRate is
+ * true, because the current one has failed, and the highest rate again otherwise.
+ ***************************************************************************************************************************/
+
+void LinkFallBack(bool bNextRate)
+{
+    if(ui32LinkBaud != LINK_START_BAUD)
+    {
+        UARTSetBaudRate(LINK_START_BAUD);
+    }
+    if(!bNextRate)
+    {
+        ui32LinkRateIndex = 0;
+    }
+    else if(ui32LinkRateIndex < LINK_BAUD_RATES - 1)
+    {
+        ui32LinkRateIndex++;
+    }
+    eLinkState = LINK_DOWN;
+    ui32LinkRetryTick = ui32TickCount - LINK_RETRY_MS*TICK_RATE_HZ/1000;
+}
+
+/***************************************************************************************************************************
+ * Function name : SenderLinkFrame()
+ * Inputs : psFrame
+ * Outputs : none
+ * Description : This function handles a link frame that has come back to the sender around the ring.
+ * FRAME_LINK_REQUEST      : every node has taken an address, so the address of the frame is the number of nodes, and the
+ *                           rate in the frame is accepted by all of them. The sender sends the acceptance of that rate.
+ * FRAME_LINK_ACCEPT       : every node has switched to the rate in the frame. The sender switches too and sends a
+ *                           confirmation at the new rate.
+ * FRAME_LINK_CONFIRM      : the new rate works all around the ring. The self test starts, or the link is up.
+ * FRAME_LINK_TEST         : a test frame is counted.
+ * FRAME_LINK_TEST_END     : all test frames have arrived or have been lost. The rate is kept if enough test frames have
+ *                           arrived, otherwise the next lower rate is tried.
+ * When the link comes up the retransmission of every node starts from sequence number 0 on all boards. Keepalive frames
+ * that come back while the link is up leave it running.
+ ***************************************************************************************************************************/
+
+void SenderLinkFrame(const tFrame *psFrame)
+{
+    uint32_t ui32Parameter = FrameGetLinkParameter(psFrame), ui32Node;
+    bool bRateValid = (ui32Parameter >= LINK_START_BAUD && ui32Parameter <= LINK_BAUD_MAX);
+    tLinkState eOldState = eLinkState;
+
+    switch(psFrame->pui8Payload[0])
+    {
+    case FRAME_LINK_REQUEST:
+        if(eLinkState == LINK_DOWN && bRateValid && psFrame->ui8Address != FRAME_ADDRESS_SENDER)
+        {
+            ui32ChainNodes = (psFrame->ui8Address > CHAIN_MAX_NODES) ? CHAIN_MAX_NODES : psFrame->ui8Address;
+            eLinkState = LINK_ACCEPTING;
+            ui32LinkTimer = ui32TickCount;
+            ui32LinkRetryTick = ui32TickCount;
+            ui32LinkAcceptedBaud = ui32Parameter;
+            LinkSend(FRAME_LINK_ACCEPT, ui32Parameter);
+        }
+        break;
+
+    case FRAME_LINK_ACCEPT:
+        if(eLinkState == LINK_ACCEPTING && ui32Parameter == ui32LinkAcceptedBaud)
+        {
+            if(ui32Parameter != LINK_START_BAUD)
+            {
+                UARTSetBaudRate(ui32Parameter);
+            }
+            eLinkState = LINK_SWITCHING;
+            ui32LinkTimer = ui32TickCount;
+            ui32LinkRetryTick = ui32TickCount;
+            LinkSend(FRAME_LINK_CONFIRM, ui32Parameter);
+        }
+        break;
+
+    case FRAME_LINK_CONFIRM:
+        if(eLinkState == LINK_SWITCHING)
+        {
+            eLinkState = (LINK_SELF_TEST_MS > 0) ? LINK_TESTING : LINK_UP;
+            ui32LinkTimer = ui32TickCount;
+            ui32SelfTestFramesSent = 0;
+            ui32SelfTestFramesReceived = 0;
+        }
+        break;
+
+    case FRAME_LINK_TEST:
+        if(eLinkState == LINK_TESTING)
+        {
+            ui32SelfTestFramesReceived++;
+        }
+        break;
+
+    case FRAME_LINK_TEST_END:
+        if(eLinkState == LINK_TESTING && ui32Parameter == ui32SelfTestFramesSent &&
+           ui32TickCount - ui32LinkTimer >= LINK_SELF_TEST_MS*TICK_RATE_HZ/1000)
+        {
+            ui32SelfTestBytesPerSecond = ui32SelfTestFramesReceived*FRAME_MAX_ENCODED*1000/LINK_SELF_TEST_MS;
+            if(ui32SelfTestFramesReceived*100 < ui32SelfTestFramesSent*LINK_SELF_TEST_MIN_PERCENT)
+            {
+                LinkFallBack(true);
+            }
+            else
+            {
+                eLinkState = LINK_UP;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if(eLinkState == LINK_UP && eOldState != LINK_UP)
+    {
+        for(ui32Node = 0; ui32Node < ui32ChainNodes; ui32Node++)
+        {
+            ArqSenderInit(&psArqSender[ui32Node], ARQ_WINDOW_SIZE,
+                          (ARQ_TIMEOUT_MS + (ui32ChainNodes - 1)*ARQ_HOP_TIMEOUT_MS)*1000, SendFrame);
+        }
+        ui32BatchCount = 0;
+        QuantizerInit(&sLEDQuantizer, pui16LEDThreshold, LED_BAR_LEDS, LED_BAR_HYSTERESIS);
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : SenderLinkService()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function is called from the main loop of the sender and runs the time driven part of the link set up.
+ * LINK_DOWN       : a request for the rate pui32LinkBaudRates[ui32LinkRateIndex] is sent every LINK_RETRY_MS.
+ * LINK_ACCEPTING  : the acceptance is repeated every LINK_RETRY_MS. If it does not come back, some nodes may have switched
+ *                   already, so the next lower rate is tried after the nodes have fallen back.
+ * LINK_SWITCHING  : the confirmation is repeated every LINK_RETRY_MS. Without an answer the next lower rate is tried.
+ * LINK_TESTING    : for LINK_SELF_TEST_MS the transmit ring is kept full with test frames of the largest size. Then the
+ *                   number of test frames sent is repeated every LINK_RETRY_MS until it comes back after the last test
+ *                   frame.
+ * LINK_UP         : a keepalive is sent when nothing has been sent for LINK_KEEPALIVE_MS. When nothing has come back
+ *                   for LINK_IDLE_TIMEOUT_MS the link is set up again from the highest rate.
+ ***************************************************************************************************************************/
+
+void SenderLinkService(void)
+{
+    uint32_t ui32Now = ui32TickCount, ui32Index, ui32Rate;
+    bool bRetry = (ui32Now - ui32LinkRetryTick >= LINK_RETRY_MS*TICK_RATE_HZ/1000);
+    tFrame sFrame;
+
+    switch(eLinkState)
+    {
+    case LINK_DOWN:
+        if(bRetry)
+        {
+            ui32LinkRetryTick = ui32Now;
+            ui32Rate = pui32LinkBaudRates[ui32LinkRateIndex];
+            while(ui32Rate > LINK_BAUD_MAX && ui32LinkRateIndex < LINK_BAUD_RATES - 1)
+            {
+                ui32Rate = pui32LinkBaudRates[++ui32LinkRateIndex];
+            }
+            LinkSend(FRAME_LINK_REQUEST, ui32Rate);
+        }
+        break;
+
+    case LINK_ACCEPTING:
+        if(ui32Now - ui32LinkTimer >= LINK_SWITCH_TIMEOUT_MS*TICK_RATE_HZ/1000)
+        {
+            LinkFallBack(true);
+        }
+        else if(bRetry)
+        {
+            ui32LinkRetryTick = ui32Now;
+            LinkSend(FRAME_LINK_ACCEPT, ui32LinkAcceptedBaud);
+        }
+        break;
 
-    /*Turns off the blue LED and call conversion function*/
-    GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_2, 0x0);
-    ConversionFunction();
+    case LINK_SWITCHING:
+        if(ui32Now - ui32LinkTimer >= LINK_SWITCH_TIMEOUT_MS*TICK_RATE_HZ/1000)
+        {
+            LinkFallBack(true);
+        }
+        else if(bRetry)
+        {
+            ui32LinkRetryTick = ui32Now;
+            LinkSend(FRAME_LINK_CONFIRM, ui32LinkBaud);
+        }
+        break;
+
+    case LINK_TESTING:
+        if(ui32Now - ui32LinkTimer < LINK_SELF_TEST_MS*TICK_RATE_HZ/1000)
+        {
+            /*test frames carry their number and a filler that also contains 0x00 bytes*/
+            while(1)
+            {
+                FrameSetLink(&sFrame, FRAME_LINK_TEST, ui32SelfTestFramesSent);
+                for(ui32Index = FRAME_LINK_LENGTH; ui32Index < FRAME_MAX_PAYLOAD; ui32Index++)
+                {
+                    sFrame.pui8Payload[ui32Index] = ui32Index*37 + ui32SelfTestFramesSent;
+                }
+                sFrame.ui8Length = FRAME_MAX_PAYLOAD;
+                if(!SendFrame(&sFrame))
+                {
+                    break;
+                }
+                ui32SelfTestFramesSent++;
+            }
+        }
+        else if(ui32Now - ui32LinkTimer >= (LINK_SELF_TEST_MS + LINK_SWITCH_TIMEOUT_MS)*TICK_RATE_HZ/1000)
+        {
+            LinkFallBack(true);
+        }
+        else if(bRetry)
+        {
+            ui32LinkRetryTick = ui32Now;
+            LinkSend(FRAME_LINK_TEST_END, ui32SelfTestFramesSent);
+        }
+        break;
 
+    case LINK_UP:
+        if(ui32Now - ui32LastRxTick >= LINK_IDLE_TIMEOUT_MS*TICK_RATE_HZ/1000)
+        {
+            LinkFallBack(false);
+        }
+        else if(ui32Now - ui32LastTxTick >= LINK_KEEPALIVE_MS*TICK_RATE_HZ/1000)
+        {
+            LinkSend(FRAME_LINK_KEEPALIVE, 0);
+        }
+        break;
+    }
 }
 
 /***************************************************************************************************************************
  * Function name : ReceiverBoard()
  * Inputs : none
  * Outputs : none
- * Description : This function continues in a while loop until the receive interrupt is generated. After servicing the ISR
- * it continues in the while loop
+ * Description : This function continues in a while loop. The bytes that the ISR has stored in the receive ring are passed
+ * to the frame decoder, and FrameRoute() decides what happens with every valid frame. A sample or batch frame addressed to
+ * this node is answered with an acknowledgement of the last frame received in order. A frame that is the next one in order
+ * is expanded, its samples move the number of LEDs lit in sLEDQuantizer and the number is shown on the LED bar. A sample
+ * frame has the layout of a batch frame with one sample, so FrameGetBatch() expands both. Link frames are handled by
+ * ReceiverLinkFrame(), a stats query addressed to this node is answered by StatsAnswer(), and all other frames are passed
+ * on to the next node unchanged. Corrupted frames are dropped by the
+ * decoder, so they are neither acknowledged nor passed on. If no valid frame has arrived for LINK_IDLE_TIMEOUT_MS at a rate
+ * other than LINK_START_BAUD, the receiver goes back to LINK_START_BAUD to wait for a new request of the sender. The
+ * receiver does not sample, so Timer0 is stopped and no ADC interrupts occur. StatsService() writes the statistics of the
+ * node to UART0.
  ***************************************************************************************************************************/
 
 void ReceiverBoard(void)
 {
+    /*variables store the byte and the frame received, the acknowledgement frame and the expanded batch*/
+    uint8_t ui8Received;
+    tFrame sFrame, sAck;
+    uint16_t pui16Samples[FRAME_MAX_BATCH];
+    uint32_t ui32Count, ui32Index;
+
+    TimerDisable(TIMER0_BASE, TIMER_A);
+
     while(1)
     {
+        if(RingGet(&sUARTRxRing, &ui8Received) && FrameDecodeByte(&sFrameDecoder, ui8Received, &sFrame))
+        {
+            ui32LastRxTick = ui32TickCount;
+            switch(FrameRoute(&sFrame, ui8NodeAddress))
+            {
+            case FRAME_ROUTE_DELIVER:
+                if(sFrame.ui8Type == FRAME_TYPE_STATS)
+                {
+                    if(sFrame.ui8Length == 0)
+                    {
+                        StatsAnswer();
+                    }
+                    break;
+                }
+                if(ArqReceive(&sArqReceiver, &sFrame, &sAck))
+                {
+                    ui32Count = FrameGetBatch(&sFrame, pui16Samples);
+                    for(ui32Index = 0; ui32Index < ui32Count; ui32Index++)
+                    {
+                        QuantizerUpdate(&sLEDQuantizer, pui16Samples[ui32Index]);
+                    }
+                    LightLEDBar(sLEDQuantizer.ui32Level);
+                }
+                SendFrame(&sAck);
+                break;
+
+            case FRAME_ROUTE_LINK:
+                ReceiverLinkFrame(&sFrame);
+                break;
+
+            default:
+                if(SendFrame(&sFrame))
+                    ui32FramesForwarded++;
+                else
+                    ui32ForwardOverflowCount++;
+                break;
+            }
+        }
+
+        if(ui32LinkBaud != LINK_START_BAUD && ui32TickCount - ui32LastRxTick >= LINK_IDLE_TIMEOUT_MS*TICK_RATE_HZ/1000)
+        {
+            UARTSetBaudRate(LINK_START_BAUD);
+        }
+
+        StatsService();
     }
 }
 
 /***************************************************************************************************************************
- * Function name : SendToReceiver()
- * Inputs : ui8ValueToReceiverCurrent
+ * Function name : ReceiverLinkFrame()
+ * Inputs : psFrame
  * Outputs : none
- * Description : This function sends ui8ValueToReceiverCurrent character to receiver board.
- * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ * Description : This function handles a link frame received by a node and passes it on to the next node with the address
+ * of this node.
+ * FRAME_LINK_REQUEST   : the node takes the address after the one of the node before it and lowers the proposed rate to
+ *                        its LINK_BAUD_MAX.
+ * FRAME_LINK_ACCEPT    : the node switches to the accepted rate as soon as the frame has been passed on.
+ * FRAME_LINK_CONFIRM   : the retransmission and the LED bar start again.
+ * Keepalive and test frames are only passed on, so that they come back to the sender.
+ ***************************************************************************************************************************/
+
+void ReceiverLinkFrame(const tFrame *psFrame)
+{
+    uint32_t ui32Parameter = FrameGetLinkParameter(psFrame);
+    uint8_t ui8Command = psFrame->pui8Payload[0];
+    tFrame sForward = *psFrame;
+
+    if(ui32Parameter > LINK_BAUD_MAX)
+    {
+        ui32Parameter = LINK_BAUD_MAX;
+    }
+    if(ui32Parameter < LINK_START_BAUD)
+    {
+        ui32Parameter = LINK_START_BAUD;
+    }
+
+    switch(ui8Command)
+    {
+    case FRAME_LINK_REQUEST:
+        if(psFrame->ui8Address < FRAME_ADDRESS_MAX_NODE)
+        {
+            ui8NodeAddress = psFrame->ui8Address + 1;
+        }
+        FrameSetLink(&sForward, FRAME_LINK_REQUEST, ui32Parameter);
+        break;
+
+    case FRAME_LINK_CONFIRM:
+        ArqReceiverInit(&sArqReceiver);
+        QuantizerInit(&sLEDQuantizer, pui16LEDThreshold, LED_BAR_LEDS, LED_BAR_HYSTERESIS);
+        LightLEDBar(0);
+        break;
+
+    default:
+        break;
+    }
+
+    sForward.ui8Address = ui8NodeAddress;
+    SendFrame(&sForward);
+    if(ui8Command == FRAME_LINK_ACCEPT && ui32Parameter != ui32LinkBaud)
+    {
+        UARTSetBaudRate(ui32Parameter);
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : SendToReceiver()
+ * Inputs : pui16Samples, ui32Count
+ * Outputs : true if the batch was added to the windows of all nodes, false if it was dropped
+ * Description : This function adds a batch frame with the ui32Count 12 bit samples at pui16Samples to the window of every
+ * node, which gives it the next sequence number of that node and sends it. If the window of one node is full, the batch is
+ * dropped for all nodes and counted in ui32BatchesDropped, so that all nodes show the same number of LEDs.
  ***************************************************************************************************************************/
 
-void SendToReceiver(uint8_t ui8ValueToReceiverCurrent)
+bool SendToReceiver(const uint16_t *pui16Samples, uint32_t ui32Count)
 {
-    /*sends the encoded character to receiver*/
-    UARTCharPut(UART4_BASE, ui8ValueToReceiverCurrent);
+    /*variables store the batch frame and the index of a node*/
+    tFrame sFrame;
+    uint32_t ui32Node;
+
+    for(ui32Node = 0; ui32Node < ui32ChainNodes; ui32Node++)
+    {
+        if(psArqSender[ui32Node].ui8Queued >= psArqSender[ui32Node].ui8WindowSize)
+        {
+            ui32BatchesDropped++;
+            return false;
+        }
+    }
+
+    /*queues the batch frame to be sent to every node*/
+    FrameSetBatch(&sFrame, 0, pui16Samples, ui32Count);
+    for(ui32Node = 0; ui32Node < ui32ChainNodes; ui32Node++)
+    {
+        sFrame.ui8Address = ui32Node + 1;
+        ArqSend(&psArqSender[ui32Node], &sFrame, MicrosecondsGet());
+    }
+    return true;
 }
 
 /**************************************************************************************************************************
  * Function name : LightLEDBar()
- * Inputs : ui8CharacterReceived
+ * Inputs : ui32Count
  * Outputs : none
- * Description : This function is called from the interrupt handler of receiver board to light the LED bar by analyzing the
- * character received. The character received and the no of LEDs to be lit are listed below.
- * Character received       No of LEDs to be lit in LED bar     Corresponding port values for port A and port B respectively
- * 'a'                      0                                   0x0, 0x0
- * 'b'                      1                                   0x0, 0x1
- * 'c'                      2                                   0x0, 0x3
- * 'd'                      3                                   0x0, 0x7
- * 'e'                      4                                   0x0, 0xF
- * 'f'                      5                                   0x0, 0x1F
- * 'g'                      6                                   0x0, 0x3F
- * 'h'                      7                                   0x0, 0x7F
- * 'i'                      8                                   0x0, 0xFF
- * 'j'                      9                                   0x40, 0xFF
- * 'k'                      10                                  0xC0, 0xFF
+ * Description : This function is called from the main loop of receiver board to light ui32Count LEDs of the LED bar. The
+ * total range of input voltages (0 to 3.3) has been divided into 10 equal intervals, and sLEDQuantizer finds the number of
+ * LEDs to be lit, the number of interval limits in pui16LEDThreshold below the 12 bit values received. A value has to pass
+ * a limit by more than LED_BAR_HYSTERESIS codes to change the number, so the ranges below apply to a value that moves
+ * towards the limit from far away. The LEDs are lit from PB0 upwards, so the port values are the low bits of (1 << count) - 1, bits 7-0 on port B and bits 9-8 on PA6 and PA7.
+ *
+ * Analog value(V)     Digital value  |       Range                 No of LEDs   Port values for port A and port B
+ * 0                0                 |       ==0                   0            0x0, 0x0
+ * 0.33             410               |       >0 and <=410          1            0x0, 0x1
+ * 0.66             819               |       >410 and <=819        2            0x0, 0x3
+ * 0.99             1229              |       >819 and <=1229       3            0x0, 0x7
+ * 1.32             1638              |       >1229 and <=1638      4            0x0, 0xF
+ * 1.65             2048              |       >1638 and <=2048      5            0x0, 0x1F
+ * 1.98             2457              |       >2048 and <=2457      6            0x0, 0x3F
+ * 2.31             2867              |       >2457 and <=2867      7            0x0, 0x7F
+ * 2.64             3276              |       >2867 and <=3276      8            0x0, 0xFF
+ * 2.97             3686              |       >3276 and <=3686      9            0x40, 0xFF
+ * 3.3              4095              |       >3686 and <=4095      10           0xC0, 0xFF
  * Reference for APIs :TivaWare Peripheral Driver Library User guide
  **************************************************************************************************************************/
 
-void LightLEDBar(uint8_t ui8CharacterReceived)
+void LightLEDBar(uint32_t ui32Count)
+{
+    /*variable stores the LED bar pattern*/
+    uint32_t ui32Pattern;
+
+    ui32Pattern = (1 << ui32Count) - 1;
+
+    GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), (ui32Pattern >> 2) & 0xC0);
+    GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
+            GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), ui32Pattern & 0xFF);
+}
+
+/***************************************************************************************************************************
+ * Function name : StatsInit()
+ * Inputs : none
+ * Outputs : none
+ * UART module used : UART0
+ * Description : This function clears the link statistics and initializes the UART0 module, which is connected to the
+ * virtual COM port of the debugger on the Tiva board. For specifications check comments below. UART0 is served from the
+ * main loop by StatsService(), so it needs no interrupt.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+void StatsInit(void)
+{
+    /*Enables UART0 module and GPIO port A, configures PA0 and PA1 as uart rx and tx pins, selects the clock source to UART
+     * as Precision Internal Oscillator (PIOSC) which is 16MHz, so the rate does not depend on the system clock, selects
+     * buadrate as STATS_BAUD_RATE and defines the number of data bits - 8, stop bit -1 and no parity. */
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
+    GPIOPinConfigure(GPIO_PA0_U0RX);
+    GPIOPinConfigure(GPIO_PA1_U0TX);
+    UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
+    GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+    UARTConfigSetExpClk(UART0_BASE, 16000000, STATS_BAUD_RATE, (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+            UART_CONFIG_PAR_NONE));
+    UARTEnable(UART0_BASE);
+
+    LinkStatsInit(&sLinkStats);
+    ui32StatsTick = ui32TickCount;
+}
+
+/***************************************************************************************************************************
+ * Function name : StatsCollect()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function copies the counters that the frame decoder, the retransmission and the UART interrupt
+ * handler keep to sLinkStats. The retransmissions and timeouts count from the last time the link came up.
+ ***************************************************************************************************************************/
+
+void StatsCollect(void)
+{
+    uint32_t ui32Node;
+
+    sLinkStats.ui32Milliseconds = ui32TickCount*1000/TICK_RATE_HZ;
+    sLinkStats.ui32Baud = ui32LinkBaud;
+    sLinkStats.ui32FramesReceived = sFrameDecoder.ui32FramesDecoded;
+    sLinkStats.ui32CRCErrors = sFrameDecoder.ui32CRCErrors;
+    sLinkStats.ui32FramingErrors = sFrameDecoder.ui32FramingErrors;
+    sLinkStats.ui32Overruns = ui32UARTOverrunCount;
+    sLinkStats.ui32LineErrors = ui32UARTLineErrorCount;
+    sLinkStats.ui32RxRingOverflows = ui32RxOverflowCount;
+
+    sLinkStats.ui32Retransmissions = 0;
+    sLinkStats.ui32Timeouts = 0;
+    for(ui32Node = 0; ui32Node < ui32ChainNodes; ui32Node++)
+    {
+        sLinkStats.ui32Retransmissions += psArqSender[ui32Node].ui32Retransmissions;
+        sLinkStats.ui32Timeouts += psArqSender[ui32Node].ui32Timeouts;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : StatsAnswer()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function answers a stats query of the sender with the statistics of this node in LINK_STATS_FRAMES
+ * stats frames, which travel on around the ring to the sender. A frame that does not fit in the transmit ring is lost, and
+ * the sender writes the statistics when the next answer is complete.
+ ***************************************************************************************************************************/
+
+void StatsAnswer(void)
 {
-    /*compares ui8CharacterReceived with different cases to light the LED bar to represent the digital value*/
-    switch(ui8CharacterReceived) {
-
-           case 'a' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x0);
-                   break;
-           case 'b' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x1);
-
-                   break;
-           case 'c' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x3);
-
-                   break;
-           case 'd' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x7);
-
-                   break;
-           case 'e' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0xF);
-
-                   break;
-           case 'f' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x1F);
-
-                   break;
-           case 'g' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x3F);
-
-                   break;
-           case 'h' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0x7F);
-
-                   break;
-           case 'i' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0xFF);
-
-                   break;
-           case 'j' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0x40);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0xFF);
-
-                   break;
-           case 'k' :
-               GPIOPinWrite(GPIO_PORTA_BASE, (GPIO_PIN_7 | GPIO_PIN_6), 0xC0);
-               GPIOPinWrite(GPIO_PORTB_BASE, (GPIO_PIN_7 | GPIO_PIN_6 | GPIO_PIN_5 | GPIO_PIN_4 | GPIO_PIN_3 |
-                       GPIO_PIN_2 | GPIO_PIN_1 | GPIO_PIN_0), 0xFF);
-
-                   break;
-
-           }
+    tFrame sFrame;
+    uint32_t ui32Word = 0;
+
+    StatsCollect();
+    do
+    {
+        ui32Word = LinkStatsSetFrame(&sFrame, &sLinkStats, ui8NodeAddress, ui32Word);
+        SendFrame(&sFrame);
+    } while(ui32Word != 0);
+}
+
+/***************************************************************************************************************************
+ * Function name : StatsService()
+ * Inputs : none
+ * Outputs : none
+ * UART module used : UART0
+ * Description : This function is called from the main loop of both boards. Every LINK_STATS_DUMP_MS, and at once when a
+ * character arrives from the PC, the statistics of this board are marked to be written, and when the link is up the
+ * sender queries every node. The statistics that are marked are written as lines of text to pui8StatsText, one line at a
+ * time while the buffer has room for the longest line, and as many characters as fit are moved into the UART0 transmit
+ * FIFO. The function never waits, so a slow terminal only delays the statistics.
+ * Reference for APIs : TivaWare Peripheral Driver Library User guide
+ ***************************************************************************************************************************/
+
+void StatsService(void)
+{
+    tFrame sFrame;
+    uint32_t ui32Node, ui32Length, ui32Index;
+    bool bDump = (ui32TickCount - ui32StatsTick >= LINK_STATS_DUMP_MS*TICK_RATE_HZ/1000);
+
+    while(UARTCharsAvail(UART0_BASE))
+    {
+        UARTCharGetNonBlocking(UART0_BASE);
+        bDump = true;
+    }
+
+    if(bDump)
+    {
+        ui32StatsTick = ui32TickCount;
+        ui32StatsPending |= 1;
+        if(eLinkState == LINK_UP)
+        {
+            for(ui32Node = 0; ui32Node < ui32ChainNodes; ui32Node++)
+            {
+                LinkStatsSetQuery(&sFrame, ui32Node + 1);
+                SendFrame(&sFrame);
+            }
+        }
+    }
 
+    /*writes the marked statistics, this board first*/
+    for(ui32Node = 0; ui32Node <= CHAIN_MAX_NODES && ui32StatsPending != 0; ui32Node++)
+    {
+        if((ui32StatsPending & (1 << ui32Node)) == 0)
+        {
+            continue;
+        }
+        if(STATS_TEXT_BUFFER_SIZE - (ui32StatsTextHead - ui32StatsTextTail) < LINK_STATS_TEXT_MAX)
+        {
+            break;
+        }
+        if(ui32Node == 0)
+        {
+            StatsCollect();
+            ui32Length = LinkStatsFormat(&sLinkStats, ui8NodeAddress, pcStatsLine, sizeof(pcStatsLine));
+        }
+        else
+        {
+            ui32Length = LinkStatsFormat(&psNodeStats[ui32Node - 1], ui32Node, pcStatsLine, sizeof(pcStatsLine));
+        }
+        for(ui32Index = 0; ui32Index < ui32Length; ui32Index++)
+        {
+            pui8StatsText[ui32StatsTextHead & (STATS_TEXT_BUFFER_SIZE - 1)] = pcStatsLine[ui32Index];
+            ui32StatsTextHead++;
+        }
+        ui32StatsPending &= ~(1 << ui32Node);
+    }
+
+    while(ui32StatsTextTail != ui32StatsTextHead && UARTSpaceAvail(UART0_BASE))
+    {
+        UARTCharPutNonBlocking(UART0_BASE, pui8StatsText[ui32StatsTextTail & (STATS_TEXT_BUFFER_SIZE - 1)]);
+        ui32StatsTextTail++;
+    }
 }
@@ -0,0 +1,67 @@
+/******************************************************************************************************************
+ * File name: quantizer.c
+ * Description : Quantizer with hysteresis described in quantizer.h. The functions do not use any peripheral, so they can
+ * also be built on a host computer.
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quantizer.h"
+
+/***************************************************************************************************************************
+ * Function name : QuantizerInit()
+ * Inputs : psQuantizer, pui16Thresholds, ui32Thresholds, ui16Hysteresis
+ * Outputs : none
+ * Description : This function sets up psQuantizer with the ui32Thresholds ascending thresholds in pui16Thresholds, which
+ * give ui32Thresholds + 1 levels, and a hysteresis of ui16Hysteresis codes. The table is not copied and must stay valid.
+ * The quantizer starts at level 0.
+ ***************************************************************************************************************************/
+
+void QuantizerInit(tQuantizer *psQuantizer, const uint16_t *pui16Thresholds, uint32_t ui32Thresholds,
+                   uint16_t ui16Hysteresis)
+{
+    psQuantizer->pui16Thresholds = pui16Thresholds;
+    psQuantizer->ui32Thresholds = ui32Thresholds;
+    psQuantizer->ui16Hysteresis = ui16Hysteresis;
+    psQuantizer->ui32Level = 0;
+    psQuantizer->ui32Transitions = 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : QuantizerUpdate()
+ * Inputs : psQuantizer, ui16Value
+ * Outputs : level of the quantizer after ui16Value
+ * Description : This function moves the level of psQuantizer up over every threshold that ui16Value exceeds by more than
+ * the hysteresis, or down under every threshold that ui16Value is at least the hysteresis below. A threshold smaller than
+ * the hysteresis is left when the value is 0. A value can move the level over several thresholds at once.
+ ***************************************************************************************************************************/
+
+uint32_t QuantizerUpdate(tQuantizer *psQuantizer, uint16_t ui16Value)
+{
+    const uint16_t *pui16Thresholds = psQuantizer->pui16Thresholds;
+    uint32_t ui32Hysteresis = psQuantizer->ui16Hysteresis;
+    uint32_t ui32Level = psQuantizer->ui32Level;
+    uint32_t ui32Threshold;
+
+    while(ui32Level < psQuantizer->ui32Thresholds && ui16Value > pui16Thresholds[ui32Level] + ui32Hysteresis)
+    {
+        ui32Level++;
+    }
+    while(ui32Level > 0)
+    {
+        ui32Threshold = pui16Thresholds[ui32Level - 1];
+        ui32Threshold = (ui32Threshold > ui32Hysteresis) ? ui32Threshold - ui32Hysteresis : 0;
+        if(ui16Value > ui32Threshold)
+        {
+            break;
+        }
+        ui32Level--;
+    }
+
+    if(ui32Level != psQuantizer->ui32Level)
+    {
+        psQuantizer->ui32Level = ui32Level;
+        psQuantizer->ui32Transitions++;
+    }
+    return ui32Level;
+}
@@ -0,0 +1,41 @@
+/******************************************************************************************************************
+ * File name: quantizer.h
+ * Description : N level quantizer with hysteresis, used to turn ADC values into the number of LEDs lit on the LED bar.
+ *
+ * The levels are separated by a table of ascending thresholds. Without hysteresis the level of a value is the number of
+ * thresholds below it, so a value that moves by a few codes around a threshold changes the level every time it crosses
+ * it. With a hysteresis of h codes the level only goes up when the value is more than h above the next threshold, and
+ * only goes down when the value is at least h below the threshold under it, so noise smaller than h does not change the
+ * level. A hysteresis of 0 gives the plain quantizer.
+ *
+ * QUANTIZER_THRESHOLD() is a constant expression, so a table of equal intervals is computed by the compiler. The
+ * functions do not use any peripheral, so they can also be built on a host computer.
+ *********************************************************************************************************************/
+
+#ifndef QUANTIZER_H_
+#define QUANTIZER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Threshold i of a table that divides the values 0 to ui32FullScale into ui32Levels equal intervals, rounded to the
+ * nearest integer. Threshold 0 is 0, so the lowest level holds only the value 0*/
+#define QUANTIZER_THRESHOLD(i, ui32Levels, ui32FullScale)                                                           \
+        ((2*(i)*(ui32FullScale) + (ui32Levels))/(2*(ui32Levels)))
+
+/*State of a quantizer. ui32Level is the current level, from 0 to ui32Thresholds, and ui32Transitions counts the
+ * changes of the level*/
+typedef struct
+{
+    const uint16_t *pui16Thresholds;
+    uint32_t ui32Thresholds;
+    uint16_t ui16Hysteresis;
+    uint32_t ui32Level;
+    uint32_t ui32Transitions;
+} tQuantizer;
+
+void QuantizerInit(tQuantizer *psQuantizer, const uint16_t *pui16Thresholds, uint32_t ui32Thresholds,
+                   uint16_t ui16Hysteresis);
+uint32_t QuantizerUpdate(tQuantizer *psQuantizer, uint16_t ui16Value);
+
+#endif /* QUANTIZER_H_ */
@@ -0,0 +1,93 @@
+/******************************************************************************************************************
+ * File name: ring.c
+ * Description : Single producer, single consumer rings described in ring.h.
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ring.h"
+
+/***************************************************************************************************************************
+ * Function name : RingPut()
+ * Inputs : psRing, ui8Byte
+ * Outputs : true if the byte was stored, false if the ring is full
+ * Description : This function appends a byte to a ring buffer. A ring has exactly one producer, which calls RingPut(), and
+ * one consumer, which calls RingGet(). The producer only writes ui32Head and the consumer only writes ui32Tail, so one of
+ * them may run in an interrupt handler without disabling interrupts. The byte is stored before ui32Head is advanced, so
+ * the consumer never sees a byte that has not been written yet.
+ ***************************************************************************************************************************/
+
+bool RingPut(tRingBuffer *psRing, uint8_t ui8Byte)
+{
+    uint32_t ui32Head = psRing->ui32Head;
+
+    if(ui32Head - psRing->ui32Tail >= RING_BUFFER_SIZE)
+    {
+        return false;
+    }
+    psRing->pui8Data[ui32Head & (RING_BUFFER_SIZE - 1)] = ui8Byte;
+    psRing->ui32Head = ui32Head + 1;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : RingGet()
+ * Inputs : psRing, pui8Byte
+ * Outputs : true if a byte was read, false if the ring is empty
+ * Description : This function removes the oldest byte from a ring buffer and stores it in *pui8Byte.
+ ***************************************************************************************************************************/
+
+bool RingGet(tRingBuffer *psRing, uint8_t *pui8Byte)
+{
+    uint32_t ui32Tail = psRing->ui32Tail;
+
+    if(ui32Tail == psRing->ui32Head)
+    {
+        return false;
+    }
+    *pui8Byte = psRing->pui8Data[ui32Tail & (RING_BUFFER_SIZE - 1)];
+    psRing->ui32Tail = ui32Tail + 1;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : SampleRingPut()
+ * Inputs : psRing, ui16Sample
+ * Outputs : true if the sample was stored, false if the ring is full
+ * Description : This function appends a sample to a sample ring, with the same ordering as RingPut(). It is called by
+ * ADC0SS3IntHandler().
+ ***************************************************************************************************************************/
+
+bool SampleRingPut(tSampleRing *psRing, uint16_t ui16Sample)
+{
+    uint32_t ui32Head = psRing->ui32Head;
+
+    if(ui32Head - psRing->ui32Tail >= SAMPLE_RING_SIZE)
+    {
+        return false;
+    }
+    psRing->pui16Data[ui32Head & (SAMPLE_RING_SIZE - 1)] = ui16Sample;
+    psRing->ui32Head = ui32Head + 1;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : SampleRingGet()
+ * Inputs : psRing, pui16Sample
+ * Outputs : true if a sample was read, false if the ring is empty
+ * Description : This function removes the oldest sample from a sample ring and stores it in *pui16Sample. It is called
+ * by the main loop of the sender.
+ ***************************************************************************************************************************/
+
+bool SampleRingGet(tSampleRing *psRing, uint16_t *pui16Sample)
+{
+    uint32_t ui32Tail = psRing->ui32Tail;
+
+    if(ui32Tail == psRing->ui32Head)
+    {
+        return false;
+    }
+    *pui16Sample = psRing->pui16Data[ui32Tail & (SAMPLE_RING_SIZE - 1)];
+    psRing->ui32Tail = ui32Tail + 1;
+    return true;
+}
@@ -0,0 +1,44 @@
+/******************************************************************************************************************
+ * File name: ring.h
+ * Description : Lock-free single producer, single consumer rings, used between the interrupt handlers and the main loop
+ * of lab 3: UART4IntHandler() produces into the receive byte ring and consumes from the transmit byte ring, the main
+ * loop does the opposite, and ADC0SS3IntHandler() produces into the sample ring that the main loop consumes. The
+ * producer only writes ui32Head and the consumer only writes ui32Tail, so neither side has to disable interrupts. The
+ * functions do not use any peripheral, so they can also be built on a host computer (see host/RingSim.c).
+ *********************************************************************************************************************/
+
+#ifndef RING_H_
+#define RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Size of the UART receive and transmit ring buffers in bytes. Must be a power of two. 256 bytes take 0.5ms at 5Mbaud*/
+#define RING_BUFFER_SIZE    256
+
+/*Size of the ring that holds the ADC samples between the ADC interrupt and the main loop. Must be a power of two*/
+#define SAMPLE_RING_SIZE    64
+
+/*Single producer, single consumer ring buffer. ui32Head and ui32Tail count the bytes written and read since start up
+ * and wrap around at 2^32, the index into pui8Data is the count modulo RING_BUFFER_SIZE*/
+typedef struct
+{
+    volatile uint32_t ui32Head;
+    volatile uint32_t ui32Tail;
+    volatile uint8_t pui8Data[RING_BUFFER_SIZE];
+} tRingBuffer;
+
+/*Ring of 16 bit ADC samples. Works like tRingBuffer*/
+typedef struct
+{
+    volatile uint32_t ui32Head;
+    volatile uint32_t ui32Tail;
+    volatile uint16_t pui16Data[SAMPLE_RING_SIZE];
+} tSampleRing;
+
+bool RingPut(tRingBuffer *psRing, uint8_t ui8Byte);
+bool RingGet(tRingBuffer *psRing, uint8_t *pui8Byte);
+bool SampleRingPut(tSampleRing *psRing, uint16_t ui16Sample);
+bool SampleRingGet(tSampleRing *psRing, uint16_t *pui16Sample);
+
+#endif /* RING_H_ */
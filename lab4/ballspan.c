@@ -0,0 +1,17 @@
+/******************************************************************************************************************
+ * File name: ballspan.c
+ * Description : Span tables of the ball described in ballspan.h, generated by the compiler from SPAN_ROWS().
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include "ballspan.h"
+
+/*ballSpanInset[d - SPAN_MIN_DIAMETER][j] is the number of pixels cut off at both ends of row j of a ball of diameter d.
+ * The table takes 992 bytes of flash for all diameters from 2 to 32*/
+const uint8_t ballSpanInset[SPAN_MAX_DIAMETER - SPAN_MIN_DIAMETER + 1][SPAN_MAX_DIAMETER] = {
+    SPAN_ROWS(2), SPAN_ROWS(3), SPAN_ROWS(4), SPAN_ROWS(5), SPAN_ROWS(6), SPAN_ROWS(7), SPAN_ROWS(8), SPAN_ROWS(9),
+    SPAN_ROWS(10), SPAN_ROWS(11), SPAN_ROWS(12), SPAN_ROWS(13), SPAN_ROWS(14), SPAN_ROWS(15), SPAN_ROWS(16),
+    SPAN_ROWS(17), SPAN_ROWS(18), SPAN_ROWS(19), SPAN_ROWS(20), SPAN_ROWS(21), SPAN_ROWS(22), SPAN_ROWS(23),
+    SPAN_ROWS(24), SPAN_ROWS(25), SPAN_ROWS(26), SPAN_ROWS(27), SPAN_ROWS(28), SPAN_ROWS(29), SPAN_ROWS(30),
+    SPAN_ROWS(31), SPAN_ROWS(32)
+};
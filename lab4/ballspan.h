@@ -0,0 +1,45 @@
+/******************************************************************************************************************
+ * File name: ballspan.h
+ * Description : Span tables of the lab 4 ball, a filled circle of any diameter from SPAN_MIN_DIAMETER to
+ * SPAN_MAX_DIAMETER pixels. Every row of a circle is a single horizontal span, so a ball is drawn by filling row j of its
+ * bounding box from ballSpanInset[d - SPAN_MIN_DIAMETER][j] to d - ballSpanInset[d - SPAN_MIN_DIAMETER][j]. The table
+ * is built by the compiler in ballspan.c and does not use any peripheral, so it can also be built on a host computer
+ * (see host/SpanCheck.c).
+ *********************************************************************************************************************/
+
+#ifndef BALLSPAN_H_
+#define BALLSPAN_H_
+
+#include <stdint.h>
+
+/*Range of ball diameters for which span tables are generated*/
+#define SPAN_MIN_DIAMETER       2
+#define SPAN_MAX_DIAMETER       32
+
+/*Span tables for the ball, generated by the compiler. A pixel in column i and row j of a ball of diameter d belongs to the
+ * ball if its center lies inside the circle, i.e. if (2i + 1 - d)^2 + (2j + 1 - d)^2 <= d^2. Every row of a circle is a
+ * single horizontal span, so it is enough to store how many pixels are cut off at each end of the row (the inset).
+ * SPAN_OUTSIDE is 1 if pixel i of row j lies outside of the circle and left of the center, and SPAN_INSET adds these up
+ * for the 16 pixels that a ball of at most 32 pixels can have left of its center.*/
+#define SPAN_SQUARE(a)          ((a)*(a))
+#define SPAN_OUTSIDE(d, j, i)   (((2*(i) + 1) < (d)) && \
+                                 ((SPAN_SQUARE(2*(i) + 1 - (d)) + SPAN_SQUARE(2*(j) + 1 - (d))) > SPAN_SQUARE(d)))
+#define SPAN_INSET(d, j)        (SPAN_OUTSIDE(d, j, 0) + SPAN_OUTSIDE(d, j, 1) + SPAN_OUTSIDE(d, j, 2) + \
+                                 SPAN_OUTSIDE(d, j, 3) + SPAN_OUTSIDE(d, j, 4) + SPAN_OUTSIDE(d, j, 5) + \
+                                 SPAN_OUTSIDE(d, j, 6) + SPAN_OUTSIDE(d, j, 7) + SPAN_OUTSIDE(d, j, 8) + \
+                                 SPAN_OUTSIDE(d, j, 9) + SPAN_OUTSIDE(d, j, 10) + SPAN_OUTSIDE(d, j, 11) + \
+                                 SPAN_OUTSIDE(d, j, 12) + SPAN_OUTSIDE(d, j, 13) + SPAN_OUTSIDE(d, j, 14) + \
+                                 SPAN_OUTSIDE(d, j, 15))
+#define SPAN_ROWS(d)            {SPAN_INSET(d, 0), SPAN_INSET(d, 1), SPAN_INSET(d, 2), SPAN_INSET(d, 3), \
+                                 SPAN_INSET(d, 4), SPAN_INSET(d, 5), SPAN_INSET(d, 6), SPAN_INSET(d, 7), \
+                                 SPAN_INSET(d, 8), SPAN_INSET(d, 9), SPAN_INSET(d, 10), SPAN_INSET(d, 11), \
+                                 SPAN_INSET(d, 12), SPAN_INSET(d, 13), SPAN_INSET(d, 14), SPAN_INSET(d, 15), \
+                                 SPAN_INSET(d, 16), SPAN_INSET(d, 17), SPAN_INSET(d, 18), SPAN_INSET(d, 19), \
+                                 SPAN_INSET(d, 20), SPAN_INSET(d, 21), SPAN_INSET(d, 22), SPAN_INSET(d, 23), \
+                                 SPAN_INSET(d, 24), SPAN_INSET(d, 25), SPAN_INSET(d, 26), SPAN_INSET(d, 27), \
+                                 SPAN_INSET(d, 28), SPAN_INSET(d, 29), SPAN_INSET(d, 30), SPAN_INSET(d, 31)}
+
+/*ballSpanInset[d - SPAN_MIN_DIAMETER][j] is the number of pixels cut off at both ends of row j of a ball of diameter d*/
+extern const uint8_t ballSpanInset[SPAN_MAX_DIAMETER - SPAN_MIN_DIAMETER + 1][SPAN_MAX_DIAMETER];
+
+#endif /* BALLSPAN_H_ */
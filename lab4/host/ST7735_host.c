@@ -0,0 +1,268 @@
+/*********************************************************************************************************************
+ * File name : ST7735_host.c
+ * Description : Host replacement of the ST7735 LCD and of the functions of ST7735.c used by lab 4. Every byte sent to
+ * the LCD, by the driver functions below or by the SSI0/uDMA model in tiva_host.c, goes through ST7735Host_Write(),
+ * which decodes the CASET, RASET and RAMWR commands[8] and writes the pixels to a 128x128 RGB565 framebuffer. Command
+ * bytes, data bytes and pixels are counted and the time the bytes take on the bus is added by Host_BusWrite().
+ * Reference : [8]ST7735_V2.1_20100505.pdf
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ST7735.h"
+#include "host.h"
+
+/*ST7735 commands decoded by the simulation*/
+#define ST7735_CASET    0x2A
+#define ST7735_RASET    0x2B
+#define ST7735_RAMWR    0x2C
+
+uint16_t hostFrameBuffer[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+tLcdStats hostLcdStats;
+
+/*Set whenever a pixel is written. Cleared when the frame has been written to a PPM file*/
+bool hostFrameChanged;
+
+/*State of the LCD: level of LCD_RS, last command, number of parameter bytes received for it, address window, write
+ * position in the window and the high byte of the pixel being received (-1 if none)*/
+static bool dataMode = true;
+static uint8_t command;
+static int parameterCount;
+static uint16_t parameter[4];
+static int windowLeft, windowRight, windowTop, windowBottom;
+static int column, row;
+static int pixelHighByte = -1;
+
+/***************************************************************************************************************************
+ * Function name : ST7735Host_SetDataMode()
+ * Inputs : data
+ * Outputs : none
+ * Description : This function sets the level of LCD_RS (PA6). false selects command bytes and true selects data bytes.
+ ***************************************************************************************************************************/
+
+void ST7735Host_SetDataMode(bool data)
+{
+    dataMode = data;
+}
+
+/***************************************************************************************************************************
+ * Function name : ST7735Host_Write()
+ * Inputs : byte
+ * Outputs : none
+ * Description : This function receives one byte on the simulated SPI bus.
+ ***************************************************************************************************************************/
+
+void ST7735Host_Write(uint8_t byte)
+{
+    if(!dataMode)
+    {
+        hostLcdStats.commandBytes++;
+        command = byte;
+        parameterCount = 0;
+        if(command == ST7735_RAMWR)
+        {
+            column = windowLeft;
+            row = windowTop;
+            pixelHighByte = -1;
+        }
+        return;
+    }
+
+    hostLcdStats.dataBytes++;
+    switch(command)
+    {
+    case ST7735_CASET:
+    case ST7735_RASET:
+        if(parameterCount < 4)
+        {
+            parameter[parameterCount++] = byte;
+        }
+        if(parameterCount == 4)
+        {
+            if(command == ST7735_CASET)
+            {
+                windowLeft = (parameter[0] << 8) | parameter[1];
+                windowRight = (parameter[2] << 8) | parameter[3];
+            }
+            else
+            {
+                windowTop = (parameter[0] << 8) | parameter[1];
+                windowBottom = (parameter[2] << 8) | parameter[3];
+            }
+        }
+        break;
+
+    case ST7735_RAMWR:
+        if(pixelHighByte < 0)
+        {
+            pixelHighByte = byte;
+            break;
+        }
+        if(column < HOST_LCD_WIDTH && row < HOST_LCD_HEIGHT)
+        {
+            hostFrameBuffer[row][column] = (pixelHighByte << 8) | byte;
+        }
+        pixelHighByte = -1;
+        hostLcdStats.pixels++;
+        hostFrameChanged = true;
+        if(++column > windowRight)
+        {
+            column = windowLeft;
+            if(++row > windowBottom)
+            {
+                row = windowTop;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : SendCommand(), SendData()
+ * Inputs : byte
+ * Outputs : none
+ * Description : These functions send a command or a data byte like writecommand() and writedata() in ST7735.c.
+ ***************************************************************************************************************************/
+
+static void SendCommand(uint8_t byte)
+{
+    ST7735Host_SetDataMode(false);
+    ST7735Host_Write(byte);
+    Host_BusWrite(1);
+    ST7735Host_SetDataMode(true);
+}
+
+static void SendData(uint8_t byte)
+{
+    ST7735Host_Write(byte);
+    Host_BusWrite(1);
+}
+
+/***************************************************************************************************************************
+ * Function name : SetAddrWindow()
+ * Inputs : x0, y0, x1, y1
+ * Outputs : none
+ * Description : This function opens an address window and starts a memory write like setAddrWindow() in ST7735.c.
+ ***************************************************************************************************************************/
+
+static void SetAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    SendCommand(ST7735_CASET);
+    SendData(0x00);
+    SendData(x0);
+    SendData(0x00);
+    SendData(x1);
+
+    SendCommand(ST7735_RASET);
+    SendData(0x00);
+    SendData(y0);
+    SendData(0x00);
+    SendData(y1);
+
+    SendCommand(ST7735_RAMWR);
+}
+
+/***************************************************************************************************************************
+ * Function name : ST7735_InitR()
+ * Inputs : option
+ * Outputs : none
+ * Description : The simulated LCD needs no initialization. The framebuffer starts black like the LCD after reset.
+ ***************************************************************************************************************************/
+
+void ST7735_InitR(enum initRFlags option)
+{
+    (void)option;
+}
+
+/***************************************************************************************************************************
+ * Function name : ST7735_FillScreen()
+ * Inputs : color
+ * Outputs : none
+ * Description : This function fills the whole screen with color.
+ ***************************************************************************************************************************/
+
+void ST7735_FillScreen(uint16_t color)
+{
+    int i;
+
+    SetAddrWindow(0, 0, HOST_LCD_WIDTH - 1, HOST_LCD_HEIGHT - 1);
+    for(i = 0; i < HOST_LCD_WIDTH*HOST_LCD_HEIGHT; i++)
+    {
+        SendData(color >> 8);
+        SendData(color);
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : ST7735_DrawBitmap()
+ * Inputs : x, y, image, w, h
+ * Outputs : none
+ * Description : This function draws the w x h image with its lower left corner at (x, y). The rows of the image are
+ * stored bottom up, and parts of the image outside the screen are not sent, like ST7735_DrawBitmap() in ST7735.c.
+ ***************************************************************************************************************************/
+
+void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h)
+{
+    int left = x, right = x + w - 1, top = y - h + 1, bottom = y;
+    int i, j;
+
+    if(left >= HOST_LCD_WIDTH || bottom < 0 || right < 0 || top >= HOST_LCD_HEIGHT)
+    {
+        return;
+    }
+    if(left < 0)
+        left = 0;
+    if(top < 0)
+        top = 0;
+    if(right >= HOST_LCD_WIDTH)
+        right = HOST_LCD_WIDTH - 1;
+    if(bottom >= HOST_LCD_HEIGHT)
+        bottom = HOST_LCD_HEIGHT - 1;
+
+    SetAddrWindow(left, top, right, bottom);
+    for(j = top; j <= bottom; j++)
+    {
+        for(i = left; i <= right; i++)
+        {
+            uint16_t color = image[(y - j)*w + (i - x)];
+            SendData(color >> 8);
+            SendData(color);
+        }
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : ST7735Host_DumpPPM()
+ * Inputs : path
+ * Outputs : true if the file was written
+ * Description : This function writes the framebuffer to a binary PPM (P6) file, converting RGB565 to 8 bits per color.
+ ***************************************************************************************************************************/
+
+bool ST7735Host_DumpPPM(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    int x, y;
+
+    if(file == NULL)
+    {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", HOST_LCD_WIDTH, HOST_LCD_HEIGHT);
+    for(y = 0; y < HOST_LCD_HEIGHT; y++)
+    {
+        for(x = 0; x < HOST_LCD_WIDTH; x++)
+        {
+            uint16_t color = hostFrameBuffer[y][x];
+            fputc(((color >> 11) & 0x1F)*255/31, file);
+            fputc(((color >> 5) & 0x3F)*255/63, file);
+            fputc((color & 0x1F)*255/31, file);
+        }
+    }
+    fclose(file);
+    hostFrameChanged = false;
+    return true;
+}
@@ -0,0 +1,170 @@
+/*********************************************************************************************************************
+ * File name : SpanCheck.c
+ * Description : Host check of the ball span tables of lab 4 (../ballspan.c). Every diameter from SPAN_MIN_DIAMETER to
+ * SPAN_MAX_DIAMETER is rasterized from ballSpanInset the way DrawDirtyRect() in ../main.c fills the rows of the ball,
+ * and compared pixel by pixel with a reference circle computed in floating point: a pixel belongs to the ball if its
+ * center is inside the circle of radius d/2 around the center of the d x d bounding box. For every diameter the
+ * pixels that differ and the area of the ball against the area of the circle are printed.
+ *
+ * All balls are written side by side to one P6 PPM file, top row the span tables and bottom row the reference, with
+ * the ball in black, pixels that differ in red and the bounding boxes in grey, so the shapes can also be looked at.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Wall -Ilab4 lab4/host/SpanCheck.c lab4/ballspan.c -lm -o span_check
+ *   ./span_check [span_check.ppm]
+ * The exit code is 1 if any pixel differs.
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "ballspan.h"
+
+#define DIAMETERS       (SPAN_MAX_DIAMETER - SPAN_MIN_DIAMETER + 1)
+
+/*Every ball gets a cell of CELL_SIZE x CELL_SIZE pixels in the PPM file, with the ball in the upper left corner of the
+ * cell after a border of one pixel*/
+#define CELL_SIZE       (SPAN_MAX_DIAMETER + 3)
+#define IMAGE_WIDTH     (DIAMETERS*CELL_SIZE)
+#define IMAGE_HEIGHT    (2*CELL_SIZE)
+
+/*Colors of the PPM file*/
+enum
+{
+    COLOR_BACKGROUND,
+    COLOR_BALL,
+    COLOR_DIFFERENT,
+    COLOR_BOX
+};
+
+static const uint8_t palette[][3] = {{255, 255, 255}, {0, 0, 0}, {255, 0, 0}, {192, 192, 192}};
+
+static uint8_t image[IMAGE_HEIGHT][IMAGE_WIDTH];
+
+/*****************************************************************************************************************
+ * Function name : SpanPixel()
+ * Inputs : diameter, row, column
+ * Outputs : true if the pixel is filled by the span of row row
+ * Description : This function fills the row like DrawDirtyRect(), from the inset to the width minus the inset.
+ *****************************************************************************************************************/
+
+static bool SpanPixel(int diameter, int row, int column)
+{
+    int inset = ballSpanInset[diameter - SPAN_MIN_DIAMETER][row];
+
+    return (column >= inset) && (column < diameter - inset);
+}
+
+/*****************************************************************************************************************
+ * Function name : ReferencePixel()
+ * Inputs : diameter, row, column
+ * Outputs : true if the center of the pixel is inside the circle
+ *****************************************************************************************************************/
+
+static bool ReferencePixel(int diameter, int row, int column)
+{
+    double radius = diameter/2.0, x = column + 0.5 - radius, y = row + 0.5 - radius;
+
+    return sqrt(x*x + y*y) <= radius;
+}
+
+/*****************************************************************************************************************
+ * Function name : DrawCell()
+ * Inputs : cellRow, diameter, reference
+ * Outputs : none
+ * Description : This function draws the ball of the span tables (reference false) or the reference ball in its cell
+ * of the image. Pixels in which the two differ are drawn in red.
+ *****************************************************************************************************************/
+
+static void DrawCell(int cellRow, int diameter, bool reference)
+{
+    int left = (diameter - SPAN_MIN_DIAMETER)*CELL_SIZE + 1, top = cellRow*CELL_SIZE + 1, row, column;
+    bool span, circle;
+
+    for(row = -1; row <= diameter; row++)
+    {
+        for(column = -1; column <= diameter; column++)
+        {
+            if(row < 0 || row == diameter || column < 0 || column == diameter)
+            {
+                image[top + row][left + column] = COLOR_BOX;
+                continue;
+            }
+            span = SpanPixel(diameter, row, column);
+            circle = ReferencePixel(diameter, row, column);
+            if(span != circle)
+            {
+                image[top + row][left + column] = COLOR_DIFFERENT;
+            }
+            else if(reference ? circle : span)
+            {
+                image[top + row][left + column] = COLOR_BALL;
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : WriteImage()
+ * Inputs : path
+ * Outputs : true if the file was written
+ *****************************************************************************************************************/
+
+static bool WriteImage(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    int row, column;
+
+    if(file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", IMAGE_WIDTH, IMAGE_HEIGHT);
+    for(row = 0; row < IMAGE_HEIGHT; row++)
+    {
+        for(column = 0; column < IMAGE_WIDTH; column++)
+        {
+            fwrite(palette[image[row][column]], 1, 3, file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = (argc > 1) ? argv[1] : "span_check.ppm";
+    int diameter, row, column, pixels, different, failures = 0;
+
+    memset(image, COLOR_BACKGROUND, sizeof(image));
+    printf("%8s %8s %10s %10s\n", "diameter", "pixels", "circle", "different");
+    for(diameter = SPAN_MIN_DIAMETER; diameter <= SPAN_MAX_DIAMETER; diameter++)
+    {
+        pixels = 0;
+        different = 0;
+        for(row = 0; row < diameter; row++)
+        {
+            for(column = 0; column < diameter; column++)
+            {
+                pixels += SpanPixel(diameter, row, column);
+                different += (SpanPixel(diameter, row, column) != ReferencePixel(diameter, row, column));
+            }
+        }
+        DrawCell(0, diameter, false);
+        DrawCell(1, diameter, true);
+        printf("%8d %8d %10.1f %10d\n", diameter, pixels, M_PI*diameter*diameter/4.0, different);
+        if(different != 0)
+        {
+            failures++;
+        }
+    }
+
+    if(!WriteImage(path))
+    {
+        return 1;
+    }
+    printf("%d of %d diameters differ from the reference circle, image written to %s\n", failures, DIAMETERS, path);
+    return (failures != 0) ? 1 : 0;
+}
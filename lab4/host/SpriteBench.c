@@ -0,0 +1,411 @@
+/*********************************************************************************************************************
+ * File name : SpriteBench.c
+ * Description : Host benchmark of the two ways lab 4 has stored the ball: the run length encoded sprites that replaced
+ * the seven 128x128 bitmaps first, and the span tables of ../ballspan.c that replaced the sprites.
+ *
+ * Every ball bitmap is encoded like the sprite converter did it: the bitmap is cropped to the bounding box of the
+ * pixels that are not background colored (0xFFFF) and every row, top row first, is stored as runs of (number of
+ * pixels 1 to 255, color low byte, color high byte), with a table of the first run of every row. The sprite is decoded
+ * back row by row into a window buffer like DrawDirtyRect() did it and must give the cropped bitmap again. The flash of
+ * the full bitmaps, of the sprites and of the span tables is printed, then the pixels per ms of decoding the sprites and
+ * of filling the same windows from the span tables like DrawDirtyRect() does now.
+ *
+ * The bitmaps are read from the files given on the command line, which hold C arrays in the format written by
+ * BmpConvert16, "const uint16_t name[] = { 0xFFFF, ... };" with the bottom row first. A file can hold several arrays
+ * and arrays of another size are skipped, so the original lab 4 program, which embeds all seven bitmaps, can be read:
+ *   git show $(git rev-list --max-parents=0 HEAD):lab4/main.c > balls.c
+ *   ./sprite_bench balls.c
+ * Without files, black balls of the seven diameters of the bitmaps are drawn from the span tables.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Wall -Ilab4 lab4/host/SpriteBench.c lab4/ballspan.c -o sprite_bench
+ *   ./sprite_bench [bitmap files]
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "ballspan.h"
+
+#define BITMAP_WIDTH        128
+#define BITMAP_HEIGHT       128
+#define BACKGROUND_COLOR    0xFFFF
+#define BALL_COLOR          0x0000
+#define MAX_RUN_LENGTH      255
+#define MAX_NAME_LENGTH     64
+#define MAX_BALLS           16
+
+/*Time every benchmark runs for*/
+#define BENCH_SECONDS       0.2
+
+/*A ball bitmap and its sprite. left and top are the upper left corner of the bounding box in the bitmap, with row 0
+ * at the top. rows[i] is the index of the first run of row i and every run is three bytes in runs*/
+typedef struct
+{
+    char name[MAX_NAME_LENGTH];
+    uint16_t bitmap[BITMAP_WIDTH*BITMAP_HEIGHT];
+    int left, top, width, height;
+    uint16_t rows[BITMAP_HEIGHT];
+    uint8_t runs[3*BITMAP_WIDTH*BITMAP_HEIGHT];
+    int runCount;
+} tBall;
+
+static tBall balls[MAX_BALLS];
+static int ballCount;
+
+/*Window buffer the rows are decoded into, and a sum of it that keeps the compiler from dropping the decoding*/
+static uint16_t window[BITMAP_WIDTH*BITMAP_HEIGHT];
+static volatile uint32_t windowSum;
+
+/*****************************************************************************************************************
+ * Function name : Seconds()
+ * Outputs : monotonic time in seconds
+ *****************************************************************************************************************/
+
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+/*****************************************************************************************************************
+ * Function name : Pixel()
+ * Inputs : ball, column, row
+ * Outputs : pixel of the bitmap, row 0 at the top
+ *****************************************************************************************************************/
+
+static uint16_t Pixel(const tBall *ball, int column, int row)
+{
+    return ball->bitmap[(BITMAP_HEIGHT - 1 - row)*BITMAP_WIDTH + column];
+}
+
+/*****************************************************************************************************************
+ * Function name : ReadBitmaps()
+ * Inputs : fileName
+ * Outputs : false if the file can not be read
+ * Description : This function adds every array of 128x128 values in the file to balls.
+ *****************************************************************************************************************/
+
+static bool ReadBitmaps(const char *fileName)
+{
+    FILE *input = fopen(fileName, "rb");
+    char *text, *cursor, *bracket, *nameStart, *end;
+    long size;
+    int pixels;
+    tBall *ball;
+
+    if(input == NULL)
+    {
+        perror(fileName);
+        return false;
+    }
+    fseek(input, 0, SEEK_END);
+    size = ftell(input);
+    fseek(input, 0, SEEK_SET);
+    text = malloc(size + 1);
+    if(text == NULL || fread(text, 1, size, input) != (size_t)size)
+    {
+        fprintf(stderr, "%s: read failed\n", fileName);
+        fclose(input);
+        free(text);
+        return false;
+    }
+    text[size] = '\0';
+    fclose(input);
+
+    /*Every "name[] = {" starts an array, which ends at the next '}'*/
+    for(cursor = text; (bracket = strstr(cursor, "[] = {")) != NULL && ballCount < MAX_BALLS; cursor = end)
+    {
+        end = strchr(bracket, '}');
+        if(end == NULL)
+        {
+            break;
+        }
+        ball = &balls[ballCount];
+        for(nameStart = bracket; nameStart > text && (isalnum((unsigned char)nameStart[-1]) || nameStart[-1] == '_');
+            nameStart--)
+        {
+        }
+        snprintf(ball->name, sizeof(ball->name), "%.*s", (int)(bracket - nameStart), nameStart);
+
+        pixels = 0;
+        for(cursor = bracket; (cursor = strstr(cursor, "0x")) != NULL && cursor < end; pixels++)
+        {
+            if(pixels < BITMAP_WIDTH*BITMAP_HEIGHT)
+            {
+                ball->bitmap[pixels] = (uint16_t)strtoul(cursor, &cursor, 16);
+            }
+            else
+            {
+                cursor += 2;
+            }
+        }
+        if(pixels == BITMAP_WIDTH*BITMAP_HEIGHT)
+        {
+            ballCount++;
+        }
+    }
+    free(text);
+    return true;
+}
+
+/*****************************************************************************************************************
+ * Function name : DrawBalls()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function draws black balls of the diameters of the seven lab 4 bitmaps in the middle of white
+ * bitmaps, from the span tables.
+ *****************************************************************************************************************/
+
+static void DrawBalls(void)
+{
+    static const int diameters[] = {25, 23, 20, 18, 15, 12, 9};
+    int index, row, column, inset, diameter, left;
+    tBall *ball;
+
+    for(index = 0; index < (int)(sizeof(diameters)/sizeof(diameters[0])); index++)
+    {
+        ball = &balls[ballCount++];
+        diameter = diameters[index];
+        left = (BITMAP_WIDTH - diameter)/2;
+        snprintf(ball->name, sizeof(ball->name), "ball %d", diameter);
+        for(row = 0; row < BITMAP_HEIGHT; row++)
+        {
+            for(column = 0; column < BITMAP_WIDTH; column++)
+            {
+                ball->bitmap[row*BITMAP_WIDTH + column] = BACKGROUND_COLOR;
+            }
+        }
+        for(row = 0; row < diameter; row++)
+        {
+            inset = ballSpanInset[diameter - SPAN_MIN_DIAMETER][row];
+            for(column = inset; column < diameter - inset; column++)
+            {
+                ball->bitmap[(left + row)*BITMAP_WIDTH + left + column] = BALL_COLOR;
+            }
+        }
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : EncodeSprite()
+ * Inputs : ball
+ * Outputs : flash bytes of the sprite on the TM4C
+ * Description : This function crops the bitmap of ball to its bounding box and encodes the rows in runs.
+ *****************************************************************************************************************/
+
+static int EncodeSprite(tBall *ball)
+{
+    int left = BITMAP_WIDTH, right = -1, top = BITMAP_HEIGHT, bottom = -1, row, column, runLength;
+    uint16_t color;
+
+    for(row = 0; row < BITMAP_HEIGHT; row++)
+    {
+        for(column = 0; column < BITMAP_WIDTH; column++)
+        {
+            if(Pixel(ball, column, row) != BACKGROUND_COLOR)
+            {
+                left = (column < left) ? column : left;
+                right = (column > right) ? column : right;
+                top = (row < top) ? row : top;
+                bottom = (row > bottom) ? row : bottom;
+            }
+        }
+    }
+    if(right < 0)
+    {
+        /*Empty bitmap, keep a single background pixel so the sprite is still valid*/
+        left = right = top = bottom = 0;
+    }
+    ball->left = left;
+    ball->top = top;
+    ball->width = right - left + 1;
+    ball->height = bottom - top + 1;
+
+    ball->runCount = 0;
+    for(row = 0; row < ball->height; row++)
+    {
+        ball->rows[row] = ball->runCount;
+        for(column = 0; column < ball->width; column += runLength)
+        {
+            color = Pixel(ball, left + column, top + row);
+            for(runLength = 1; column + runLength < ball->width && runLength < MAX_RUN_LENGTH &&
+                Pixel(ball, left + column + runLength, top + row) == color; runLength++)
+            {
+            }
+            ball->runs[3*ball->runCount] = runLength;
+            ball->runs[3*ball->runCount + 1] = color & 0xFF;
+            ball->runs[3*ball->runCount + 2] = color >> 8;
+            ball->runCount++;
+        }
+    }
+
+    /*Row table, runs and the sprite structure (four int16_t and two 32-bit pointers on the TM4C)*/
+    return ball->height*sizeof(uint16_t) + 3*ball->runCount + 4*sizeof(int16_t) + 2*4;
+}
+
+/*****************************************************************************************************************
+ * Function name : DecodeSprite()
+ * Inputs : ball
+ * Outputs : none
+ * Description : This function decodes all rows of the sprite of ball into window, one row after the other like
+ * DecodeSpriteRow() of the sprite version of main.c.
+ *****************************************************************************************************************/
+
+static void DecodeSprite(const tBall *ball)
+{
+    const uint8_t *run;
+    uint16_t *pixel = window, color;
+    int row, column, runEnd;
+
+    for(row = 0; row < ball->height; row++)
+    {
+        run = &ball->runs[3*ball->rows[row]];
+        runEnd = 0;
+        column = 0;
+        while(column < ball->width)
+        {
+            runEnd += run[0];
+            color = run[1] | (run[2] << 8);
+            while(column < runEnd && column < ball->width)
+            {
+                *pixel++ = color;
+                column++;
+            }
+            run += 3;
+        }
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : FillSpans()
+ * Inputs : diameter
+ * Outputs : none
+ * Description : This function fills a diameter x diameter window from the span tables, like DrawDirtyRect().
+ *****************************************************************************************************************/
+
+static void FillSpans(int diameter)
+{
+    uint16_t *pixel = window;
+    int row, column, inset;
+
+    for(row = 0; row < diameter; row++)
+    {
+        inset = ballSpanInset[diameter - SPAN_MIN_DIAMETER][row];
+        for(column = 0; column < diameter; column++)
+        {
+            *pixel++ = ((column >= inset) && (column < diameter - inset)) ? BALL_COLOR : BACKGROUND_COLOR;
+        }
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : Checksum()
+ * Inputs : pixels
+ * Outputs : none
+ * Description : This function adds the first pixels of window to windowSum.
+ *****************************************************************************************************************/
+
+static void Checksum(int pixels)
+{
+    uint32_t sum = 0;
+    int index;
+
+    for(index = 0; index < pixels; index++)
+    {
+        sum += window[index];
+    }
+    windowSum += sum;
+}
+
+int main(int argc, char **argv)
+{
+    int index, row, column, spriteBytes, spriteTotal = 0, errors = 0, ballErrors, pixelsPerPass = 0, diameter;
+    double start, seconds, pixels;
+    tBall *ball;
+
+    for(index = 1; index < argc; index++)
+    {
+        if(!ReadBitmaps(argv[index]))
+        {
+            return 1;
+        }
+    }
+    if(argc < 2)
+    {
+        DrawBalls();
+    }
+    if(ballCount == 0)
+    {
+        fprintf(stderr, "no 128x128 bitmaps found\n");
+        return 1;
+    }
+
+    printf("%-24s %9s %6s %8s %8s\n", "bitmap", "box", "runs", "sprite", "errors");
+    for(index = 0; index < ballCount; index++)
+    {
+        ball = &balls[index];
+        spriteBytes = EncodeSprite(ball);
+        spriteTotal += spriteBytes;
+        pixelsPerPass += ball->width*ball->height;
+
+        /*the decoded sprite must give the cropped bitmap*/
+        DecodeSprite(ball);
+        ballErrors = 0;
+        for(row = 0; row < ball->height; row++)
+        {
+            for(column = 0; column < ball->width; column++)
+            {
+                ballErrors += (window[row*ball->width + column] != Pixel(ball, ball->left + column, ball->top + row));
+            }
+        }
+        printf("%-24s %4dx%-4d %6d %8d %8d\n", ball->name, ball->width, ball->height, ball->runCount, spriteBytes,
+               ballErrors);
+        errors += ballErrors;
+    }
+
+    printf("flash: %d full bitmaps %lu bytes, sprites %d bytes, span tables for diameters %d to %d %lu bytes\n",
+           ballCount, (unsigned long)ballCount*BITMAP_WIDTH*BITMAP_HEIGHT*sizeof(uint16_t), spriteTotal,
+           SPAN_MIN_DIAMETER, SPAN_MAX_DIAMETER, (unsigned long)sizeof(ballSpanInset));
+
+    /*Decode all sprites, then fill windows of the same widths from the span tables, for BENCH_SECONDS each*/
+    pixels = 0;
+    start = Seconds();
+    do
+    {
+        for(index = 0; index < ballCount; index++)
+        {
+            DecodeSprite(&balls[index]);
+            Checksum(balls[index].width*balls[index].height);
+        }
+        pixels += pixelsPerPass;
+        seconds = Seconds() - start;
+    } while(seconds < BENCH_SECONDS);
+    printf("sprite decode : %.0f pixels/ms\n", pixels/seconds/1000.0);
+
+    pixels = 0;
+    start = Seconds();
+    do
+    {
+        for(index = 0; index < ballCount; index++)
+        {
+            diameter = balls[index].width;
+            diameter = (diameter < SPAN_MIN_DIAMETER) ? SPAN_MIN_DIAMETER :
+                       (diameter > SPAN_MAX_DIAMETER) ? SPAN_MAX_DIAMETER : diameter;
+            FillSpans(diameter);
+            Checksum(diameter*diameter);
+            pixels += diameter*diameter;
+        }
+        seconds = Seconds() - start;
+    } while(seconds < BENCH_SECONDS);
+    printf("span fill     : %.0f pixels/ms\n", pixels/seconds/1000.0);
+
+    printf("%d pixels decoded wrong\n", errors);
+    return (errors != 0) ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*********************************************************************************************************************
+ * File name : TiltCheck.c
+ * Description : Host check of the tilt conversion of lab 4 (../tilt.c). Every digital value from 0 to 4095 is
+ * converted with TiltToPixels() and compared with a reference computed with asin() in double precision:
+ *   distance = asin((value - ACCEL_OFFSET_COUNTS)/ACCEL_COUNTS_PER_G)/TILT_EDGE_ANGLE*BALL_EDGE_OFFSET
+ * with the sine limited to 1g and the distance limited to BALL_EDGE_OFFSET on both sides. The conversion rounds to whole
+ * pixels, so it may differ from the reference by half a pixel plus the error of the interpolated asin table; the check
+ * fails for any value that differs by more than TILT_TOLERANCE_PIXELS. It also checks the documented anchor points:
+ * 5 degree (value 2119) gives 25 pixels and 10 degree (value 2190) gives 50 pixels, and the same to the other side.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Wall -Ilab4 lab4/host/TiltCheck.c lab4/tilt.c -lm -o tilt_check
+ *   ./tilt_check
+ * The exit code is 1 if any value is outside the tolerance or an anchor point is wrong.
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "tilt.h"
+
+#define ADC_FULL_SCALE          4095
+
+/*Largest difference from the reference in pixels: half a pixel of rounding and 0.01 pixel for the asin table*/
+#define TILT_TOLERANCE_PIXELS   0.51
+
+/*Anchor points: digital value and distance in pixels*/
+static const int anchors[][2] = {{2119, 25}, {2190, 50}, {1977, -25}, {1906, -50}, {ACCEL_OFFSET_COUNTS, 0}};
+
+/*****************************************************************************************************************
+ * Function name : ReferencePixels()
+ * Inputs : digitalValue
+ * Outputs : distance of the ball from the center of the screen in pixels, not rounded
+ *****************************************************************************************************************/
+
+static double ReferencePixels(int digitalValue)
+{
+    double sine = (digitalValue - ACCEL_OFFSET_COUNTS)/(double)ACCEL_COUNTS_PER_G;
+    double degrees, distance;
+
+    sine = (sine > 1.0) ? 1.0 : (sine < -1.0) ? -1.0 : sine;
+    degrees = asin(sine)*180.0/M_PI;
+    distance = degrees*256.0/TILT_EDGE_ANGLE*BALL_EDGE_OFFSET;
+    return (distance > BALL_EDGE_OFFSET) ? BALL_EDGE_OFFSET : (distance < -BALL_EDGE_OFFSET) ? -BALL_EDGE_OFFSET : distance;
+}
+
+int main(void)
+{
+    int value, pixels, worstValue = 0, failures = 0, i;
+    double error, worst = 0.0;
+
+    for(value = 0; value <= ADC_FULL_SCALE; value++)
+    {
+        pixels = TiltToPixels(value);
+        error = fabs(pixels - ReferencePixels(value));
+        if(error > worst)
+        {
+            worst = error;
+            worstValue = value;
+        }
+        if(error > TILT_TOLERANCE_PIXELS)
+        {
+            printf("value %4d: %3d pixels, reference %.3f\n", value, pixels, ReferencePixels(value));
+            failures++;
+        }
+    }
+    printf("largest error %.3f pixels at value %d (%d pixels, reference %.3f), %d of %d values above %.2f\n", worst,
+           worstValue, TiltToPixels(worstValue), ReferencePixels(worstValue), failures, ADC_FULL_SCALE + 1,
+           TILT_TOLERANCE_PIXELS);
+
+    for(i = 0; i < (int)(sizeof(anchors)/sizeof(anchors[0])); i++)
+    {
+        pixels = TiltToPixels(anchors[i][0]);
+        printf("value %4d: %3d pixels, expected %3d%s\n", anchors[i][0], pixels, anchors[i][1],
+               (pixels == anchors[i][1]) ? "" : " FAILED");
+        if(pixels != anchors[i][1])
+        {
+            failures++;
+        }
+    }
+    return (failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+/*********************************************************************************************************************
+ * File name : host.h
+ * Description : Declarations shared by the host simulation of lab 4. The lab 4 program (../main.c) is compiled
+ * unchanged for a PC and linked with ST7735_host.c, which replaces the ST7735 LCD with a 128x128 RGB565 framebuffer, and
+ * tiva_host.c, which replaces the TivaWare functions used by the program with a model of the timers, the ADC, SSI0 and
+ * the uDMA driven by simulated time. The accelerometer values are replayed from a trace read from standard input.
+ * When the trace ends the simulation prints a report of the rendering cost and exits.
+ *
+ * Build (TIVAWARE is the TivaWare installation, VALVANO the directory with ST7735.h and PLL.h):
+ *   gcc -std=gnu99 -O2 -I$TIVAWARE -I$VALVANO -Ilab4/host lab4/main.c lab4/ballspan.c lab4/tilt.c
+ *       lab4/host/ST7735_host.c lab4/host/tiva_host.c -o lab4_host
+ * Run:
+ *   ./lab4_host < lab4/host/tilt_trace.txt
+ * Capture a binary trace from the board on the virtual COM port, starting the capture before the board is reset so that
+ * the header is included, and replay it:
+ *   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > trace.bin
+ *   ./lab4_host < trace.bin
+ * Two runs with the same trace print the same frame checksum, so a change of the motion shows as a different checksum.
+ * Environment variables:
+ *   LCD_SPI_HZ     SSI0 bit rate used to model the bus time. Default 4000000, which is what the ST7735 driver sets up
+ *                  (system clock/10) once ADCInit() has changed the system clock to 40MHz.
+ *   LCD_PPM_DIR    if set, every frame in which pixels changed is written to LCD_PPM_DIR/frameNNNNN.ppm
+ *   LCD_PPM_FILE   file the last frame is written to at the end. Default lab4_last.ppm
+ *   LAB4_UART_OUT  if set, the bytes sent on UART0 are written to this file. For a text trace this gives the binary
+ *                  trace the board would have sent
+ *********************************************************************************************************************/
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Dimensions of the simulated LCD*/
+#define HOST_LCD_WIDTH      128
+#define HOST_LCD_HEIGHT     128
+
+/*Counters of the simulated LCD*/
+typedef struct
+{
+    uint64_t commandBytes;
+    uint64_t dataBytes;
+    uint64_t pixels;
+} tLcdStats;
+
+/*ST7735_host.c*/
+extern uint16_t hostFrameBuffer[HOST_LCD_HEIGHT][HOST_LCD_WIDTH];
+extern tLcdStats hostLcdStats;
+extern bool hostFrameChanged;
+void ST7735Host_SetDataMode(bool data);
+void ST7735Host_Write(uint8_t byte);
+bool ST7735Host_DumpPPM(const char *path);
+
+/*tiva_host.c*/
+void Host_BusWrite(uint32_t bytes);
+uint64_t Host_NowNs(void);
+
+#endif /* HOST_H_ */
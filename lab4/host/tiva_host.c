@@ -0,0 +1,910 @@
+/*********************************************************************************************************************
+ * File name : tiva_host.c
+ * Description : Host replacement of the TivaWare functions and of PLL_Init() used by lab 4. The peripherals are
+ * modeled in simulated time:
+ *  - Timer0 raises its interrupt and Timer1 triggers ADC0 sample sequencer 1 at the period given by TimerLoadSet().
+ *  - Sample sequencer 1 is a mock of the hardware: a pass only runs if the sequencer is enabled with the timer trigger,
+ *    it converts the configured steps in order up to the step marked ADC_CTL_END into a FIFO of 4 entries, channel 0
+ *    reading the x and channel 1 the y value of the accelerometer trace for the time of the pass, and the step marked
+ *    ADC_CTL_IE raises the interrupt if it is enabled. Entries that do not fit in the FIFO are counted as overflows.
+ *    The report shows the passes, the steps and the overflows, so the set up of the sequencer can be checked on a PC.
+ *  - SSI0 sends one byte every 8 bit times of LCD_SPI_HZ. Bytes written by SSIDataPut() and by the uDMA are passed to
+ *    the simulated ST7735 and the uDMA raises the SSI0 interrupt when its transfer has been sent.
+ *  - Interrupts run when they become pending unless they are masked by IntMasterDisable(). SysCtlSleep() advances
+ *    the time to the next event.
+ *  - UART0 sends every byte at once. The bytes are written to the file named by LAB4_UART_OUT, if it is set, so the
+ *    accelerometer trace streamed by the program can be captured on the host too.
+ * The processor itself takes no time, so the report shows the cost of the LCD bus alone.
+ *
+ * The accelerometer trace is read from standard input in one of two formats:
+ *  - text, one segment per line, lines starting with # are ignored:
+ *      <duration in ms> <x digital value> <y digital value>
+ *    The accelerometer reads the given values for the duration of the segment.
+ *  - binary, as streamed by the program on UART0 (see ACCEL_TRACE_CAPTURE in main.c): the header "L4T1" followed by
+ *    5 byte records of a 16 bit time stamp in ms and two 12 bit digital values. Pass n of the ADC reads the last record
+ *    with a time stamp of at most n ms, so the program sees the same values in the same passes as on the board.
+ * The simulation ends with the last segment or record.
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/ssi.h"
+#include "driverlib/udma.h"
+#include "driverlib/uart.h"
+#include "PLL.h"
+#include "host.h"
+
+#define NS_PER_SECOND       1000000000ULL
+
+/*Header and record size of the binary accelerometer trace*/
+#define TRACE_HEADER        "L4T1"
+#define TRACE_RECORD_BYTES  5
+
+/*FNV-1a hash parameters used for the frame checksum*/
+#define FNV_OFFSET_BASIS    14695981039346656037ULL
+#define FNV_PRIME           1099511628211ULL
+
+/*Interrupts modeled by the simulation, in order of their interrupt numbers, which is the order in which pending
+ * interrupts of the same priority are taken*/
+enum
+{
+    HOST_INT_SSI0,
+    HOST_INT_ADC0SS1,
+    HOST_INT_TIMER0A,
+    HOST_INT_COUNT
+};
+
+/*State of a general purpose timer*/
+typedef struct
+{
+    uint32_t load;
+    bool enabled;
+    bool interruptEnabled;
+    bool adcTrigger;
+    uint64_t nextNs;
+} tHostTimer;
+
+static uint32_t clockHz = 16000000;
+static uint32_t spiHz = 4000000;
+static uint64_t nowNs;
+
+static tHostTimer timers[2];
+static void (*handlers[HOST_INT_COUNT])(void);
+static uint32_t pendingInterrupts;
+static bool interruptsMasked;
+
+/*Depth of the FIFO of sample sequencer 1 and the channel bits of a step configuration*/
+#define ADC_SS1_STEPS       4
+#define ADC_CHANNEL_MASK    0x0F
+
+/*ADC0 sample sequencer 1: configuration, FIFO and counters*/
+typedef struct
+{
+    uint32_t trigger;
+    uint32_t steps[ADC_SS1_STEPS];
+    uint32_t oversample;
+    bool enabled;
+    bool interruptEnabled;
+    uint32_t fifo[ADC_SS1_STEPS];
+    int fifoCount;
+    uint32_t passes;
+    uint32_t interrupts;
+    uint32_t overflows;
+    int stepsPerPass;
+} tHostSequencer;
+
+static tHostSequencer sequencer = {.trigger = ADC_TRIGGER_PROCESSOR, .oversample = 1};
+
+/*Accelerometer trace. traceFormat is 0 until the first pass, then 1 for a text trace and 2 for a binary trace. For a
+ * binary trace recordTime, recordX and recordY hold the next record*/
+static int traceX = 2048, traceY = 2048;
+static uint64_t segmentEndNs;
+static int traceFormat;
+static uint32_t adcPasses;
+static bool recordValid;
+static uint64_t recordTime;
+static uint16_t recordStamp;
+static int recordX, recordY;
+
+/*File the bytes sent on UART0 are written to*/
+static FILE *uartFile;
+
+/*SSI0 and the uDMA channel 11*/
+static uint64_t busFreeNs, busBusyNs;
+static uint8_t *dmaSource;
+static uint32_t dmaBytes;
+static bool dmaEnabled;
+static uint64_t dmaDoneNs;
+
+/*Frame statistics. The counters are taken from the time Timer0 is enabled, so the first screen clear is left out*/
+static uint32_t frameTicks, updatedFrames;
+static uint64_t startNs, startBusyNs, pixelsAtTick;
+static tLcdStats startStats;
+
+/*Checksum of the screen content at every frame tick, to compare the motion of two runs*/
+static uint64_t frameChecksum = FNV_OFFSET_BASIS;
+
+static void Report(void);
+
+/***************************************************************************************************************************
+ * Function name : Host_NowNs()
+ * Inputs : none
+ * Outputs : simulated time in ns
+ ***************************************************************************************************************************/
+
+uint64_t Host_NowNs(void)
+{
+    return nowNs;
+}
+
+/***************************************************************************************************************************
+ * Function name : Host_BusWrite()
+ * Inputs : bytes
+ * Outputs : none
+ * Description : This function queues bytes on SSI0. They are sent as soon as the bytes queued before them have been sent.
+ ***************************************************************************************************************************/
+
+void Host_BusWrite(uint32_t bytes)
+{
+    uint64_t duration = (uint64_t)bytes*8*NS_PER_SECOND/spiHz;
+
+    if(busFreeNs < nowNs)
+    {
+        busFreeNs = nowNs;
+    }
+    busFreeNs += duration;
+    busBusyNs += duration;
+}
+
+/***************************************************************************************************************************
+ * Function name : RunPendingInterrupts()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function runs the handlers of the pending interrupts unless interrupts are masked.
+ ***************************************************************************************************************************/
+
+static void RunPendingInterrupts(void)
+{
+    int source;
+
+    while(pendingInterrupts != 0 && !interruptsMasked)
+    {
+        for(source = 0; (pendingInterrupts & (1u << source)) == 0; source++)
+        {
+        }
+        pendingInterrupts &= ~(1u << source);
+        if(handlers[source] != NULL)
+        {
+            handlers[source]();
+        }
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : ReadSegment()
+ * Inputs : none
+ * Outputs : false at the end of the trace
+ * Description : This function reads the next segment of a text trace from standard input.
+ ***************************************************************************************************************************/
+
+static bool ReadSegment(void)
+{
+    char line[128];
+    unsigned duration;
+    int x, y;
+
+    while(fgets(line, sizeof(line), stdin) != NULL)
+    {
+        if(line[0] == '#' || sscanf(line, "%u %d %d", &duration, &x, &y) != 3)
+        {
+            continue;
+        }
+        traceX = x;
+        traceY = y;
+        segmentEndNs += (uint64_t)duration*1000000ULL;
+        return true;
+    }
+    return false;
+}
+
+/***************************************************************************************************************************
+ * Function name : ReadRecord()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function reads the next record of a binary trace from standard input into recordTime, recordX and
+ * recordY. The 16 bit time stamps are extended to 64 bits, assuming that two records are less than 65.536 s apart.
+ ***************************************************************************************************************************/
+
+static void ReadRecord(void)
+{
+    uint8_t record[TRACE_RECORD_BYTES];
+    uint16_t stamp;
+
+    if(fread(record, 1, TRACE_RECORD_BYTES, stdin) != TRACE_RECORD_BYTES)
+    {
+        recordValid = false;
+        return;
+    }
+    stamp = record[0] | (record[1] << 8);
+    recordTime = recordValid ? recordTime + (uint16_t)(stamp - recordStamp) : stamp;
+    recordStamp = stamp;
+    recordX = record[2] | ((record[3] & 0x0F) << 8);
+    recordY = (record[3] >> 4) | (record[4] << 4);
+    recordValid = true;
+}
+
+/***************************************************************************************************************************
+ * Function name : OpenTrace()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function detects the format of the trace on standard input from its first bytes.
+ ***************************************************************************************************************************/
+
+static void OpenTrace(void)
+{
+    char header[sizeof(TRACE_HEADER)];
+    size_t length = fread(header, 1, sizeof(TRACE_HEADER) - 1, stdin);
+
+    if(length == sizeof(TRACE_HEADER) - 1 && memcmp(header, TRACE_HEADER, length) == 0)
+    {
+        traceFormat = 2;
+        ReadRecord();
+        return;
+    }
+
+    /*A text trace. The bytes that have been read are put back*/
+    traceFormat = 1;
+    while(length > 0)
+    {
+        ungetc(header[--length], stdin);
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : SequencerPass()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function converts the steps of sample sequencer 1 into its FIFO, if the sequencer is enabled with
+ * the timer trigger, and raises the interrupt for a step marked ADC_CTL_IE.
+ ***************************************************************************************************************************/
+
+static void SequencerPass(void)
+{
+    uint32_t config;
+    int step;
+
+    if(!sequencer.enabled || sequencer.trigger != ADC_TRIGGER_TIMER)
+    {
+        return;
+    }
+    sequencer.passes++;
+    for(step = 0; step < ADC_SS1_STEPS; step++)
+    {
+        config = sequencer.steps[step];
+        if(sequencer.fifoCount < ADC_SS1_STEPS)
+        {
+            switch(config & ADC_CHANNEL_MASK)
+            {
+            case 0:
+                sequencer.fifo[sequencer.fifoCount++] = traceX;
+                break;
+            case 1:
+                sequencer.fifo[sequencer.fifoCount++] = traceY;
+                break;
+            default:
+                sequencer.fifo[sequencer.fifoCount++] = 0;
+                break;
+            }
+        }
+        else
+        {
+            sequencer.overflows++;
+        }
+        if((config & ADC_CTL_IE) && sequencer.interruptEnabled)
+        {
+            sequencer.interrupts++;
+            pendingInterrupts |= 1u << HOST_INT_ADC0SS1;
+        }
+        if(config & ADC_CTL_END)
+        {
+            break;
+        }
+    }
+    sequencer.stepsPerPass = (step < ADC_SS1_STEPS) ? step + 1 : ADC_SS1_STEPS;
+}
+
+/***************************************************************************************************************************
+ * Function name : AdcPass()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function runs one pass of ADC0 sample sequencer 1 when Timer1 triggers it.
+ ***************************************************************************************************************************/
+
+static void AdcPass(void)
+{
+    /*Time of the pass in ms, computed like the time stamp of the program*/
+    uint64_t passTime = (uint64_t)adcPasses*1000*(timers[1].load + 1)/clockHz;
+
+    if(traceFormat == 0)
+    {
+        OpenTrace();
+    }
+
+    if(traceFormat == 1)
+    {
+        while(nowNs >= segmentEndNs)
+        {
+            if(!ReadSegment())
+            {
+                Report();
+                exit(0);
+            }
+        }
+    }
+    else
+    {
+        if(!recordValid)
+        {
+            Report();
+            exit(0);
+        }
+        while(recordValid && recordTime <= passTime)
+        {
+            traceX = recordX;
+            traceY = recordY;
+            ReadRecord();
+        }
+    }
+
+    adcPasses++;
+    SequencerPass();
+}
+
+/***************************************************************************************************************************
+ * Function name : FrameTick()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function counts the frames at every Timer0 timeout, adds the screen content to the frame checksum
+ * and writes the frame to a PPM file if asked to.
+ ***************************************************************************************************************************/
+
+static void FrameTick(void)
+{
+    const char *directory = getenv("LCD_PPM_DIR");
+    char path[512];
+    int x, y;
+
+    frameTicks++;
+    for(y = 0; y < HOST_LCD_HEIGHT; y++)
+    {
+        for(x = 0; x < HOST_LCD_WIDTH; x++)
+        {
+            frameChecksum = (frameChecksum ^ hostFrameBuffer[y][x])*FNV_PRIME;
+        }
+    }
+    if(hostLcdStats.pixels != pixelsAtTick)
+    {
+        updatedFrames++;
+        pixelsAtTick = hostLcdStats.pixels;
+    }
+    if(directory != NULL && hostFrameChanged)
+    {
+        snprintf(path, sizeof(path), "%s/frame%05u.ppm", directory, (unsigned)frameTicks);
+        ST7735Host_DumpPPM(path);
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : NextEventNs()
+ * Inputs : none
+ * Outputs : time of the next event, UINT64_MAX if there is none
+ ***************************************************************************************************************************/
+
+static uint64_t NextEventNs(void)
+{
+    uint64_t next = UINT64_MAX;
+    int i;
+
+    for(i = 0; i < 2; i++)
+    {
+        if(timers[i].enabled && timers[i].nextNs < next)
+            next = timers[i].nextNs;
+    }
+    if(dmaEnabled && dmaDoneNs < next)
+        next = dmaDoneNs;
+    return next;
+}
+
+/***************************************************************************************************************************
+ * Function name : AdvanceTo()
+ * Inputs : timeNs
+ * Outputs : none
+ * Description : This function advances the simulated time to timeNs and handles every event on the way.
+ ***************************************************************************************************************************/
+
+static void AdvanceTo(uint64_t timeNs)
+{
+    uint64_t next;
+    int i;
+
+    while((next = NextEventNs()) <= timeNs)
+    {
+        nowNs = next;
+        if(dmaEnabled && dmaDoneNs == nowNs)
+        {
+            dmaEnabled = false;
+            pendingInterrupts |= 1u << HOST_INT_SSI0;
+        }
+        for(i = 0; i < 2; i++)
+        {
+            if(timers[i].enabled && timers[i].nextNs == nowNs)
+            {
+                timers[i].nextNs += (uint64_t)(timers[i].load + 1)*NS_PER_SECOND/clockHz;
+                if(timers[i].adcTrigger)
+                    AdcPass();
+                if(timers[i].interruptEnabled)
+                {
+                    FrameTick();
+                    pendingInterrupts |= 1u << HOST_INT_TIMER0A;
+                }
+            }
+        }
+        RunPendingInterrupts();
+    }
+    if(nowNs < timeNs)
+    {
+        nowNs = timeNs;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : Report()
+ * Inputs : none
+ * Outputs : none
+ * Description : This function prints the rendering cost and writes the last frame to a PPM file.
+ ***************************************************************************************************************************/
+
+static void Report(void)
+{
+    const char *path = getenv("LCD_PPM_FILE");
+    double seconds = (double)(nowNs - startNs)/NS_PER_SECOND;
+    double busSeconds = (double)(busBusyNs - startBusyNs)/NS_PER_SECOND;
+    uint64_t commandBytes = hostLcdStats.commandBytes - startStats.commandBytes;
+    uint64_t dataBytes = hostLcdStats.dataBytes - startStats.dataBytes;
+    uint64_t pixels = hostLcdStats.pixels - startStats.pixels;
+
+    printf("Simulated time           : %.3f s\n", seconds);
+    printf("Frame ticks              : %u (%.1f per second)\n", (unsigned)frameTicks, frameTicks/seconds);
+    printf("Frames with LCD updates  : %u (%.1f per second)\n", (unsigned)updatedFrames, updatedFrames/seconds);
+    printf("Command bytes            : %llu\n", (unsigned long long)commandBytes);
+    printf("Data bytes               : %llu\n", (unsigned long long)dataBytes);
+    printf("Pixels written           : %llu\n", (unsigned long long)pixels);
+    if(updatedFrames != 0)
+    {
+        printf("Bytes per updated frame  : %.1f\n", (double)(commandBytes + dataBytes)/updatedFrames);
+    }
+    printf("SPI clock                : %u Hz\n", (unsigned)spiHz);
+    printf("Bus time                 : %.3f ms (%.2f %% of the simulated time)\n", busSeconds*1000.0,
+           100.0*busSeconds/seconds);
+    if(busSeconds > 0.0)
+    {
+        printf("Bus limited frame rate   : %.0f frames per second\n", updatedFrames/busSeconds);
+    }
+    printf("ADC0 SS1                 : %u passes, %d steps per pass, oversample %u, %u interrupts, %u FIFO overflows\n",
+           (unsigned)sequencer.passes, sequencer.stepsPerPass, (unsigned)sequencer.oversample,
+           (unsigned)sequencer.interrupts, (unsigned)sequencer.overflows);
+    printf("Frame checksum           : %016llx\n", (unsigned long long)frameChecksum);
+
+    if(uartFile != NULL)
+    {
+        fclose(uartFile);
+    }
+
+    if(path == NULL)
+    {
+        path = "lab4_last.ppm";
+    }
+    ST7735Host_DumpPPM(path);
+}
+
+/***************************************************************************************************************************
+ * Function name : TimerIndex()
+ * Inputs : base
+ * Outputs : index of the timer in timers
+ ***************************************************************************************************************************/
+
+static int TimerIndex(uint32_t base)
+{
+    return (base == TIMER0_BASE) ? 0 : 1;
+}
+
+/*System control*/
+
+void PLL_Init(uint32_t freq)
+{
+    /*The PLL runs at 400MHz and freq is the divider minus one*/
+    const char *spi = getenv("LCD_SPI_HZ");
+
+    clockHz = 400000000/(freq + 1);
+    if(spi != NULL && atol(spi) > 0)
+    {
+        spiHz = atol(spi);
+    }
+}
+
+void SysCtlClockSet(uint32_t ui32Config)
+{
+    uint32_t divider = ((ui32Config >> 23) & 0xF) + 1;
+
+    clockHz = ((ui32Config & SYSCTL_USE_OSC) == SYSCTL_USE_OSC) ? 16000000/divider : 200000000/divider;
+}
+
+uint32_t SysCtlClockGet(void)
+{
+    return clockHz;
+}
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+    (void)ui32Peripheral;
+}
+
+void SysCtlSleep(void)
+{
+    uint64_t next;
+
+    /*A pending interrupt wakes the processor even when it is masked*/
+    if(pendingInterrupts != 0)
+    {
+        return;
+    }
+    next = NextEventNs();
+    if(next == UINT64_MAX)
+    {
+        fprintf(stderr, "The processor sleeps with no event left\n");
+        Report();
+        exit(1);
+    }
+    AdvanceTo(next);
+}
+
+/*UART0*/
+
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+    (void)ui32Base;
+    (void)ui32Source;
+}
+
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk, uint32_t ui32Baud, uint32_t ui32Config)
+{
+    const char *path = getenv("LAB4_UART_OUT");
+
+    (void)ui32Base;
+    (void)ui32UARTClk;
+    (void)ui32Baud;
+    (void)ui32Config;
+    if(path != NULL && uartFile == NULL)
+    {
+        uartFile = fopen(path, "wb");
+    }
+}
+
+void UARTEnable(uint32_t ui32Base)
+{
+    (void)ui32Base;
+}
+
+bool UARTSpaceAvail(uint32_t ui32Base)
+{
+    (void)ui32Base;
+    return true;
+}
+
+bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    (void)ui32Base;
+    if(uartFile != NULL)
+    {
+        fputc(ucData, uartFile);
+    }
+    return true;
+}
+
+/*Interrupt controller*/
+
+bool IntMasterEnable(void)
+{
+    bool wasMasked = interruptsMasked;
+
+    interruptsMasked = false;
+    RunPendingInterrupts();
+    return wasMasked;
+}
+
+bool IntMasterDisable(void)
+{
+    bool wasMasked = interruptsMasked;
+
+    interruptsMasked = true;
+    return wasMasked;
+}
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+    (void)ui32Interrupt;
+}
+
+/*GPIO. PA6 is LCD_RS*/
+
+void GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    (void)ui32Port;
+    (void)ui8Pins;
+}
+
+void GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+    (void)ui32PinConfig;
+}
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    if(ui32Port == GPIO_PORTA_BASE && (ui8Pins & GPIO_PIN_6))
+    {
+        ST7735Host_SetDataMode((ui8Val & GPIO_PIN_6) != 0);
+    }
+}
+
+/*ADC0*/
+
+/***************************************************************************************************************************
+ * Function name : CheckSequencer()
+ * Inputs : base, sequenceNum
+ * Outputs : none
+ * Description : This function stops the simulation if the program uses a sequencer that is not modeled.
+ ***************************************************************************************************************************/
+
+static void CheckSequencer(uint32_t base, uint32_t sequenceNum)
+{
+    if(base != ADC0_BASE || sequenceNum != 1)
+    {
+        fprintf(stderr, "Only sample sequencer 1 of ADC0 is modeled\n");
+        exit(1);
+    }
+}
+
+void ADCHardwareOversampleConfigure(uint32_t ui32Base, uint32_t ui32Factor)
+{
+    (void)ui32Base;
+    sequencer.oversample = ui32Factor;
+}
+
+void ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t ui32Trigger, uint32_t ui32Priority)
+{
+    (void)ui32Priority;
+    CheckSequencer(ui32Base, ui32SequenceNum);
+    sequencer.trigger = ui32Trigger;
+}
+
+void ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t ui32Step, uint32_t ui32Config)
+{
+    CheckSequencer(ui32Base, ui32SequenceNum);
+    if(ui32Step < ADC_SS1_STEPS)
+    {
+        sequencer.steps[ui32Step] = ui32Config;
+    }
+}
+
+void ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    CheckSequencer(ui32Base, ui32SequenceNum);
+    sequencer.enabled = true;
+}
+
+void ADCIntRegister(uint32_t ui32Base, uint32_t ui32SequenceNum, void (*pfnHandler)(void))
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+    handlers[HOST_INT_ADC0SS1] = pfnHandler;
+}
+
+void ADCIntEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    CheckSequencer(ui32Base, ui32SequenceNum);
+    sequencer.interruptEnabled = true;
+}
+
+void ADCIntClear(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+}
+
+int32_t ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t *pui32Buffer)
+{
+    int32_t count = sequencer.fifoCount;
+    int32_t i;
+
+    CheckSequencer(ui32Base, ui32SequenceNum);
+    for(i = 0; i < count; i++)
+    {
+        pui32Buffer[i] = sequencer.fifo[i];
+    }
+    sequencer.fifoCount = 0;
+    return count;
+}
+
+/*Timer0 and Timer1*/
+
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+    (void)ui32Config;
+    timers[TimerIndex(ui32Base)].enabled = false;
+}
+
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    (void)ui32Timer;
+    timers[TimerIndex(ui32Base)].load = ui32Value;
+}
+
+void TimerControlTrigger(uint32_t ui32Base, uint32_t ui32Timer, bool bEnable)
+{
+    (void)ui32Timer;
+    timers[TimerIndex(ui32Base)].adcTrigger = bEnable;
+}
+
+void TimerIntRegister(uint32_t ui32Base, uint32_t ui32Timer, void (*pfnHandler)(void))
+{
+    (void)ui32Base;
+    (void)ui32Timer;
+    handlers[HOST_INT_TIMER0A] = pfnHandler;
+}
+
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    (void)ui32IntFlags;
+    timers[TimerIndex(ui32Base)].interruptEnabled = true;
+}
+
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    (void)ui32Base;
+    (void)ui32IntFlags;
+}
+
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    tHostTimer *timer = &timers[TimerIndex(ui32Base)];
+
+    (void)ui32Timer;
+    timer->enabled = true;
+    timer->nextNs = nowNs + (uint64_t)(timer->load + 1)*NS_PER_SECOND/clockHz;
+
+    /*The frame timer starts after the screen has been cleared and the first ball has been drawn*/
+    if(ui32Base == TIMER0_BASE)
+    {
+        startNs = nowNs;
+        startBusyNs = busBusyNs;
+        startStats = hostLcdStats;
+        pixelsAtTick = hostLcdStats.pixels;
+    }
+}
+
+/*SSI0*/
+
+void SSIDataPut(uint32_t ui32Base, uint32_t ui32Data)
+{
+    (void)ui32Base;
+    ST7735Host_Write(ui32Data);
+    Host_BusWrite(1);
+}
+
+bool SSIBusy(uint32_t ui32Base)
+{
+    (void)ui32Base;
+    AdvanceTo(busFreeNs);
+    return false;
+}
+
+void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    (void)ui32Base;
+    (void)ui32DMAFlags;
+}
+
+void SSIIntRegister(uint32_t ui32Base, void (*pfnHandler)(void))
+{
+    (void)ui32Base;
+    handlers[HOST_INT_SSI0] = pfnHandler;
+}
+
+uint32_t SSIIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    (void)ui32Base;
+    (void)bMasked;
+    return 0;
+}
+
+void SSIIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    (void)ui32Base;
+    (void)ui32IntFlags;
+}
+
+/*uDMA channel 11 (SSI0 TX)*/
+
+void uDMAEnable(void)
+{
+}
+
+void uDMAControlBaseSet(void *pControlTable)
+{
+    (void)pControlTable;
+}
+
+void uDMAChannelAssign(uint32_t ui32Mapping)
+{
+    (void)ui32Mapping;
+}
+
+void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    (void)ui32ChannelNum;
+    (void)ui32Attr;
+}
+
+void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+    (void)ui32ChannelStructIndex;
+    (void)ui32Control;
+}
+
+void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode, void *pvSrcAddr, void *pvDstAddr,
+                            uint32_t ui32TransferSize)
+{
+    (void)ui32ChannelStructIndex;
+    (void)ui32Mode;
+    (void)pvDstAddr;
+    dmaSource = pvSrcAddr;
+    dmaBytes = ui32TransferSize;
+}
+
+void uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+    uint32_t i;
+
+    (void)ui32ChannelNum;
+
+    /*The line buffer is not written again before the transfer is done, so the bytes can be passed to the LCD now*/
+    for(i = 0; i < dmaBytes; i++)
+    {
+        ST7735Host_Write(dmaSource[i]);
+    }
+    Host_BusWrite(dmaBytes);
+    dmaDoneNs = busFreeNs;
+    dmaEnabled = true;
+}
+
+bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum)
+{
+    (void)ui32ChannelNum;
+    return dmaEnabled;
+}
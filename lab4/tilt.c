@@ -0,0 +1,59 @@
+/******************************************************************************************************************
+ * File name: tilt.c
+ * Description : Conversion of the accelerometer values to the position of the ball described in tilt.h.
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tilt.h"
+
+/*asinTable[i] = asin(i/64) in 1/256 degree, for i = 0 to 64*/
+const int16_t asinTable[65] = {
+        0,   229,   458,   688,   917,  1147,  1377,  1607,  1838,
+     2070,  2301,  2534,  2767,  3000,  3235,  3470,  3706,  3943,
+     4182,  4421,  4662,  4904,  5147,  5392,  5638,  5886,  6136,
+     6388,  6642,  6898,  7156,  7417,  7680,  7946,  8215,  8487,
+     8763,  9042,  9324,  9611,  9903, 10199, 10500, 10806, 11119,
+    11438, 11764, 12097, 12439, 12790, 13152, 13525, 13911, 14312,
+    14730, 15167, 15628, 16116, 16638, 17204, 17827, 18531, 19363,
+    20444, 23040
+};
+
+/***************************************************************************************************************************
+ * Function name : TiltToPixels()
+ * Inputs : digitalValue
+ * Outputs : distance of the ball from the center of the screen in pixels
+ * Description : This function converts the digital value of one accelerometer axis to the distance of the ball from the
+ * center of the screen along that axis, using fixed point arithmetic only.
+ * The acceleration is sin(angle) = (digitalValue - ACCEL_OFFSET_COUNTS)/ACCEL_COUNTS_PER_G, which is converted to Q15.
+ * The angle is interpolated linearly between the two nearest entries of asinTable and then scaled so that a tilt of
+ * 5 degree gives half of BALL_EDGE_OFFSET and a tilt of 10 degree or more gives BALL_EDGE_OFFSET:
+ * distance = angle * BALL_EDGE_OFFSET / 10 degree
+ * The function takes the same time for every input.
+ ***************************************************************************************************************************/
+
+int TiltToPixels(int digitalValue)
+{
+    int32_t counts = digitalValue - ACCEL_OFFSET_COUNTS;
+    int32_t sine, index, fraction, angle, distance;
+    bool negative = (counts < 0);
+
+    if(negative)
+        counts = -counts;
+
+    /*sin(angle) in Q15, limited to 1g*/
+    sine = (counts*32768 + ACCEL_COUNTS_PER_G/2)/ACCEL_COUNTS_PER_G;
+    if(sine > 32767)
+        sine = 32767;
+
+    /*The table has an entry every 1/64 g, i.e. every 512 in Q15*/
+    index = sine >> 9;
+    fraction = sine & 511;
+    angle = asinTable[index] + (((asinTable[index + 1] - asinTable[index])*fraction + 256) >> 9);
+
+    distance = (angle*BALL_EDGE_OFFSET + TILT_EDGE_ANGLE/2)/TILT_EDGE_ANGLE;
+    if(distance > BALL_EDGE_OFFSET)
+        distance = BALL_EDGE_OFFSET;
+
+    return negative ? -distance : distance;
+}
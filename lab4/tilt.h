@@ -0,0 +1,31 @@
+/******************************************************************************************************************
+ * File name: tilt.h
+ * Description : Conversion of the accelerometer values of lab 4 to the position of the ball. The tilt of one axis is
+ * asin((digitalValue - ACCEL_OFFSET_COUNTS)/ACCEL_COUNTS_PER_G), and the ball is placed BALL_EDGE_OFFSET pixels from the
+ * center of the screen for a tilt of TILT_EDGE_ANGLE, proportionally in between. The conversion uses fixed point
+ * arithmetic only and does not use any peripheral, so it can also be built on a host computer (see host/TiltCheck.c).
+ *********************************************************************************************************************/
+
+#ifndef TILT_H_
+#define TILT_H_
+
+#include <stdint.h>
+
+/*Accelerometer calibration (references [10] and [11] of main.c): the output is 1.65V (digital value 2048) at 0g and
+ * changes by 0.66V per g, which is 0.66V*4095/3.3V = 819 digital counts per g*/
+#define ACCEL_OFFSET_COUNTS     2048
+#define ACCEL_COUNTS_PER_G      819
+
+/*Distance from the center of the screen at which the center of the ball is placed for a tilt of 10 degree (at the
+ * edge). A tilt of 5 degree places the ball half way*/
+#define BALL_EDGE_OFFSET        50
+
+/*Tilt angle at which the ball reaches the edge of the screen, in 1/256 degree*/
+#define TILT_EDGE_ANGLE         (10*256)
+
+/*asinTable[i] = asin(i/64) in 1/256 degree, for i = 0 to 64*/
+extern const int16_t asinTable[65];
+
+int TiltToPixels(int digitalValue);
+
+#endif /* TILT_H_ */
@@ -0,0 +1,331 @@
+/*********************************************************************************************************************
+ * File name : DrainBench.c
+ * Description : Host benchmark of the offline sample log of lab 5 (../potlog.c) on the file backed stand-in of the
+ * CC3100 file system (sl_fs_host.c). The main loop of ../main.c is replayed in simulated time: the pot is sampled every
+ * 100ms into the ring of ../potbatch.h, the connection is down for the given number of minutes, and meanwhile the ring
+ * is moved to the log whenever it holds POT_LOG_SPILL_SAMPLES samples. Then the connection is back and the log is
+ * drained in batches that fill the 1460 bytes of g_buff, followed by the samples of the ring.
+ *
+ * Every batch is decoded again and checked against the samples that were taken, so the benchmark also shows that the
+ * server gets every sample that was not counted as lost, once and in order. With a port the batches are posted to
+ * pot_server.c on this computer over one keep-alive connection and the answer is awaited, like on the board.
+ *
+ * For every outage it prints the samples taken, logged and lost, the flash traffic, erases and modelled time of the
+ * writes, and for the drain the requests, samples per request, modelled flash time, measured time of the HTTP requests
+ * and the resulting drain rate. At the end the number of times each segment was erased shows how evenly the segments
+ * wear. If DRAIN_RESET is set the log is initialized again before every outage, like after a reset of the board, so the
+ * erase counts show whether the turn of the segments survives resets.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Wall -Ilab5/host -Ilab5 lab5/host/DrainBench.c lab5/potlog.c lab5/potbatch.c
+ *       lab5/host/sl_fs_host.c -o drain_bench
+ *   ./drain_bench [minutes offline [outages [port]]]
+ * The defaults are 10 minutes and 4 outages, without a server.
+ *********************************************************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "simplelink.h"
+#include "potbatch.h"
+#include "potlog.h"
+
+/*Settings of main.c*/
+#define POT_SAMPLE_PERIOD_MS        100
+#define POT_LOG_SPILL_SAMPLES       128
+#define MAX_BUFF_SIZE               1460
+#define POT_DEVICE_ID               "xxxxxxxxx"
+
+static tPotRing ring;
+static tPotLog potLog;
+static char g_buff[MAX_BUFF_SIZE + 1];
+static char request[MAX_BUFF_SIZE + 512];
+static uint32_t tick;
+static int server = -1;
+
+/*Time of the next sample the server has to get, and the errors found by CheckBatch()*/
+static uint32_t expectedTime = POT_SAMPLE_PERIOD_MS;
+static uint32_t checkErrors;
+
+/*Times each segment was erased over all outages, also over the simulated resets*/
+static uint32_t erases[POT_LOG_SEGMENTS];
+
+/*****************************************************************************************************************
+ * Function name : Seconds()
+ * Outputs : monotonic time in seconds
+ *****************************************************************************************************************/
+
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+/*****************************************************************************************************************
+ * Function name : PotValue()
+ * Inputs : time
+ * Outputs : value of the sample taken at time, a slow sweep over the 12 bit range
+ *****************************************************************************************************************/
+
+static uint16_t PotValue(uint32_t time)
+{
+    return (time/POT_SAMPLE_PERIOD_MS*37) % 4096;
+}
+
+/*****************************************************************************************************************
+ * Function name : CheckBatch()
+ * Inputs : body, samples
+ * Outputs : none
+ * Description : This function decodes the POT field of body and checks that it holds the samples samples that follow
+ * the last one checked. Samples lost in the log are skipped, they are older than every sample still in it.
+ *****************************************************************************************************************/
+
+static void CheckBatch(const char *body, uint32_t samples)
+{
+    const char *pot = strstr(body, "&POT=");
+    uint32_t time = 0, count = 0;
+    char *end;
+
+    if(pot == NULL)
+    {
+        checkErrors++;
+        return;
+    }
+    for(pot += 5; *pot != 0; count++)
+    {
+        unsigned long delta = strtoul(pot, &end, 10);
+        unsigned long value = strtoul(end + 1, &end, 10);
+
+        time = (count == 0) ? delta : time + delta;
+        if(count == 0 && time > expectedTime)
+        {
+            /*samples dropped as lost*/
+            expectedTime = time;
+        }
+        if(time != expectedTime || value != PotValue(time)/16u)
+        {
+            checkErrors++;
+        }
+        expectedTime = time + POT_SAMPLE_PERIOD_MS;
+        pot = (*end == ',') ? end + 1 : end;
+    }
+    if(count != samples)
+    {
+        checkErrors++;
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : Post()
+ * Inputs : length
+ * Outputs : bytes sent and received
+ * Description : This function posts the body in g_buff to the server, if there is one, and waits for the answer.
+ *****************************************************************************************************************/
+
+static uint32_t Post(uint32_t length)
+{
+    char response[2048];
+    const char *field, *header;
+    int requestLength, received = 0;
+
+    requestLength = snprintf(request, sizeof(request), "POST / HTTP/1.1\r\nHost: 192.168.2.18\r\nAccept: */*\r\n"
+                             "Content-Type: application/x-www-form-urlencoded\r\nConnection: keep-alive\r\n"
+                             "Content-Length: %u\r\n\r\n%s", length, g_buff);
+    if(server < 0)
+    {
+        return requestLength;
+    }
+    if(send(server, request, requestLength, 0) != requestLength)
+    {
+        perror("drain_bench");
+        exit(1);
+    }
+    while((header = memmem(response, received, "\r\n\r\n", 4)) == NULL ||
+          received < header - response + 4 + atoi(strcasestr(response, "Content-Length:") + 15))
+    {
+        int bytes = recv(server, response + received, sizeof(response) - 1 - received, 0);
+
+        if(bytes <= 0)
+        {
+            fprintf(stderr, "drain_bench: connection closed by the server\n");
+            exit(1);
+        }
+        received += bytes;
+        response[received] = 0;
+    }
+    field = strstr(header, "\"error\":0");
+    if(field == NULL)
+    {
+        checkErrors++;
+    }
+    return requestLength + received;
+}
+
+/*****************************************************************************************************************
+ * Function name : Upload()
+ * Inputs : fromLog, bytes
+ * Outputs : number of samples uploaded
+ * Description : This function sends one batch from the log or from the ring, like the main loop of main.c, and adds
+ * the bytes sent and received to *bytes.
+ *****************************************************************************************************************/
+
+static uint32_t Upload(bool fromLog, uint64_t *bytes)
+{
+    tPotBatch batch;
+    uint32_t samples, length;
+
+    PotBatchBegin(&batch, g_buff, sizeof(g_buff), POT_DEVICE_ID, tick);
+    if(fromLog)
+    {
+        samples = PotLogFill(&potLog, &batch);
+    }
+    else
+    {
+        for(samples = 0; samples < PotRingCount(&ring); samples++)
+        {
+            const tPotSample *sample = PotRingPeek(&ring, samples);
+
+            if(!PotBatchAdd(&batch, sample->ui32Time, sample->ui16Value))
+            {
+                break;
+            }
+        }
+    }
+    length = PotBatchEnd(&batch);
+    CheckBatch(g_buff, samples);
+    *bytes += Post(length);
+    if(fromLog)
+    {
+        PotLogRemove(&potLog, samples);
+    }
+    else
+    {
+        PotRingRemove(&ring, samples);
+    }
+    return samples;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t minutes = (argc > 1) ? strtoul(argv[1], NULL, 0) : 10;
+    uint32_t outages = (argc > 2) ? strtoul(argv[2], NULL, 0) : 4;
+    uint32_t port = (argc > 3) ? strtoul(argv[3], NULL, 0) : 0;
+    uint32_t outage, end, taken, logged, lost, requests, samples, slot, minErases, maxErases;
+    uint64_t bytes;
+    tSlFsHostStats before;
+    double flashMs, httpStart, httpMs;
+    struct sockaddr_in address;
+    int on = 1;
+    bool reset = getenv("DRAIN_RESET") != NULL;
+
+    if(port != 0)
+    {
+        server = socket(AF_INET, SOCK_STREAM, 0);
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if(connect(server, (struct sockaddr *)&address, sizeof(address)) < 0)
+        {
+            perror("drain_bench");
+            return 1;
+        }
+        setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    PotLogInit(&potLog);
+    printf("log of %u segments of %u samples\n", POT_LOG_SEGMENTS, (unsigned)POT_LOG_SEGMENT_SAMPLES);
+
+    for(outage = 1; outage <= outages; outage++)
+    {
+        if(reset && outage > 1)
+        {
+            PotLogInit(&potLog);
+        }
+
+        /*connection down: sample and move the ring to the log when it is half full*/
+        before = slFsHostStats;
+        taken = 0;
+        lost = potLog.ui32Lost + ring.ui32Lost;
+        for(end = tick + minutes*60000; tick < end; tick++)
+        {
+            if(tick % POT_SAMPLE_PERIOD_MS == 0 && tick != 0)
+            {
+                PotRingPut(&ring, tick, PotValue(tick));
+                taken++;
+            }
+            if(PotRingCount(&ring) >= POT_LOG_SPILL_SAMPLES &&
+               PotLogAppend(&potLog, &ring, PotRingCount(&ring)) < 0)
+            {
+                fprintf(stderr, "drain_bench: failed to write the log\n");
+                return 1;
+            }
+        }
+        logged = PotLogCount(&potLog);
+        lost = potLog.ui32Lost + ring.ui32Lost - lost;
+        flashMs = (slFsHostStats.modelMicroseconds - before.modelMicroseconds)/1000.0;
+        printf("outage %u: %u min, %u samples taken, %u in the log, %u in the ring, %u lost\n", outage, minutes,
+               taken, logged, PotRingCount(&ring), lost);
+        printf("  log writes: %llu bytes, %llu sector erases, %llu calls, %.0f ms modelled\n",
+               (unsigned long long)(slFsHostStats.bytesWritten - before.bytesWritten),
+               (unsigned long long)(slFsHostStats.sectorErases - before.sectorErases),
+               (unsigned long long)(slFsHostStats.calls - before.calls), flashMs);
+
+        /*connection back: drain the log, then the ring*/
+        before = slFsHostStats;
+        requests = 0;
+        samples = 0;
+        bytes = 0;
+        httpStart = Seconds();
+        while(PotLogCount(&potLog) != 0)
+        {
+            samples += Upload(true, &bytes);
+            requests++;
+        }
+        while(PotRingCount(&ring) != 0)
+        {
+            samples += Upload(false, &bytes);
+            requests++;
+        }
+        httpMs = (Seconds() - httpStart)*1000.0;
+        flashMs = (slFsHostStats.modelMicroseconds - before.modelMicroseconds)/1000.0;
+        printf("  drain: %u samples in %u requests, %.1f samples/request, %.1f bytes/sample\n", samples, requests,
+               (requests != 0) ? (double)samples/requests : 0.0, (samples != 0) ? (double)bytes/samples : 0.0);
+        printf("  drain time: %.1f ms flash modelled (%llu bytes read, %llu calls) + %.1f ms %s = %.0f samples/s\n",
+               flashMs, (unsigned long long)(slFsHostStats.bytesRead - before.bytesRead),
+               (unsigned long long)(slFsHostStats.calls - before.calls), httpMs,
+               (server < 0) ? "encoding" : "HTTP to the server", samples/((flashMs + httpMs)/1000.0));
+        for(slot = 0; slot < POT_LOG_SEGMENTS; slot++)
+        {
+            erases[slot] += potLog.pui32Erases[slot];
+            potLog.pui32Erases[slot] = 0;
+        }
+    }
+
+    minErases = maxErases = erases[0];
+    for(slot = 1; slot < POT_LOG_SEGMENTS; slot++)
+    {
+        if(erases[slot] < minErases)
+        {
+            minErases = erases[slot];
+        }
+        if(erases[slot] > maxErases)
+        {
+            maxErases = erases[slot];
+        }
+    }
+    printf("segment erases: min %u max %u, %u sl_Fs errors, %u check errors\n", minErases, maxErases,
+           potLog.ui32Errors, checkErrors);
+    return (checkErrors != 0 || potLog.ui32Errors != 0) ? 1 : 0;
+}
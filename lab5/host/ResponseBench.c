@@ -0,0 +1,250 @@
+/*********************************************************************************************************************
+ * File name : ResponseBench.c
+ * Description : Host test and benchmark of the streaming response parser of lab 5 (../jsonstream.c).
+ *
+ * First a set of small bodies, valid and invalid, is parsed in pieces of 1 byte, 7 bytes and READ_SIZE bytes, and the
+ * result, the number of tokens and the value of "error" are compared with the expected ones, so a piece boundary at any
+ * place of a token gives the same result.
+ *
+ * Then synthetic responses of growing size, an object with "error", "ID" and an array "pot" of [time,value,"text"]
+ * elements with escapes in the strings, are parsed the way readResponse() of ../main.c does it: the body is copied a
+ * READ_SIZE chunk at a time into one g_buff of MAX_BUFF_SIZE + 1 bytes, as HTTPCli_readResponseBody() would, and every
+ * chunk is fed to the parser. For every size the parse time, the throughput and the memory used are printed. The memory
+ * is the parser state and g_buff, which are static, plus the deepest stack use of the parse, measured on a painted
+ * thread stack; the heap in use is checked before and after the parse. The old readResponse() needed a malloc() of the whole
+ * body for anything longer than g_buff, which is also printed, and the TM4C123 has 32kB of RAM in all.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Wall -Ilab5 lab5/host/ResponseBench.c lab5/jsonstream.c -lpthread -o response_bench
+ *   ./response_bench [largest size in MB]
+ * The default largest size is 64MB.
+ *********************************************************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include <pthread.h>
+#include "jsonstream.h"
+
+/*Settings of main.c*/
+#define READ_SIZE           1450
+#define MAX_BUFF_SIZE       1460
+
+/*Stack of the thread that parses, painted with STACK_PAINT*/
+#define STACK_BYTES         (64*1024)
+#define STACK_PAINT         0xA5
+
+/*A small body and the expected result*/
+typedef struct
+{
+    const char *body;
+    int32_t result;
+    uint32_t tokens;
+    const char *error;
+} tCase;
+
+static const tCase cases[] =
+{
+    {"{\"error\":0}", JSON_STREAM_OK, 3, "0"},
+    {" {\"error\" : -12 , \"x\":[1,2,{}]}\r\n", JSON_STREAM_OK, 8, "-12"},
+    {"{\"a\":{\"error\":1},\"error\":\"late\"}", JSON_STREAM_OK, 7, "late"},
+    {"{\"error\":\"a\\\"b\\\\c\\u00e9\\n\"}", JSON_STREAM_OK, 3, "a\"b\\c?\n"},
+    {"{\"error\":{\"code\":3}}", JSON_STREAM_OK, 5, NULL},
+    {"{\"errorx\":1,\"erro\":2}", JSON_STREAM_OK, 5, NULL},
+    {"[true,false,null,1.5e3,\"\"]", JSON_STREAM_OK, 6, NULL},
+    {"42", JSON_STREAM_OK, 1, NULL},
+    {"{}", JSON_STREAM_OK, 1, NULL},
+    {"[]", JSON_STREAM_OK, 1, NULL},
+    {"{\"error\":0", JSON_STREAM_INCOMPLETE, 3, NULL},
+    {"", JSON_STREAM_INCOMPLETE, 0, NULL},
+    {"{\"error\":0}}", JSON_STREAM_INVALID, 3, "0"},
+    {"{\"error\" 0}", JSON_STREAM_INVALID, 2, NULL},
+    {"{error:0}", JSON_STREAM_INVALID, 1, NULL},
+    {"[1,2}", JSON_STREAM_INVALID, 3, NULL},
+    {"{\"a\":1,}", JSON_STREAM_INVALID, 3, NULL},
+    {"[1 2]", JSON_STREAM_INVALID, 2, NULL},
+    {"\"ab\ncd\"", JSON_STREAM_INVALID, 1, NULL},
+    {"\"\\x\"", JSON_STREAM_INVALID, 1, NULL},
+    {"\"\\u12g4\"", JSON_STREAM_INVALID, 1, NULL},
+    {"[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]", JSON_STREAM_OK, 32, NULL},
+    {"[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]", JSON_STREAM_TOO_DEEP, 33, NULL},
+};
+
+static tJsonStream json;
+static char g_buff[MAX_BUFF_SIZE + 1];
+
+/*Body parsed by the thread and its result*/
+static const char *body;
+static size_t bodyLength;
+static int32_t bodyResult;
+static double parseSeconds;
+static size_t heapBefore, heapAfter;
+static unsigned char *stack;
+static uint32_t stackUsed;
+
+/*****************************************************************************************************************
+ * Function name : Seconds()
+ * Outputs : monotonic time in seconds
+ *****************************************************************************************************************/
+
+static double Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec*1e-9;
+}
+
+/*****************************************************************************************************************
+ * Function name : Parse()
+ * Inputs : text, length, piece
+ * Outputs : result of the parser
+ * Description : This function parses length bytes of text, copied piece bytes at a time into g_buff.
+ *****************************************************************************************************************/
+
+static int32_t Parse(const char *text, size_t length, uint32_t piece)
+{
+    size_t offset;
+    uint32_t chunk;
+
+    JsonStreamInit(&json, "error");
+    for(offset = 0; offset < length; offset += chunk)
+    {
+        chunk = (length - offset < piece) ? length - offset : piece;
+        memcpy(g_buff, text + offset, chunk);
+        if(JsonStreamFeed(&json, g_buff, chunk) != JSON_STREAM_OK)
+        {
+            break;
+        }
+    }
+    return JsonStreamEnd(&json);
+}
+
+/*****************************************************************************************************************
+ * Function name : ParseThread()
+ * Inputs : argument, not used
+ * Outputs : NULL
+ * Description : This function runs on the thread stack stack. It paints the stack below its own frame, parses body in
+ * READ_SIZE chunks and measures the time, the deepest stack use below its frame and the heap in use before and after.
+ * The painting and the search are loops in this function, so that they do not use the stack below the frame. The
+ * 256 bytes below the frame are not painted, they hold the locals of this function, so the stack use is at least 256.
+ *****************************************************************************************************************/
+
+static void *ParseThread(void *argument)
+{
+    volatile unsigned char marker = 0;
+    unsigned char *frame = (unsigned char *)((uintptr_t)&marker - 256);
+    unsigned char *byte;
+    double start;
+
+    (void)argument;
+    heapBefore = mallinfo2().uordblks;
+    for(byte = stack; byte < frame; byte++)
+    {
+        *byte = STACK_PAINT;
+    }
+    start = Seconds();
+    bodyResult = Parse(body, bodyLength, READ_SIZE);
+    parseSeconds = Seconds() - start;
+    for(byte = stack; byte < frame && *byte == STACK_PAINT; byte++)
+    {
+    }
+    stackUsed = (uintptr_t)&marker - (uintptr_t)byte;
+    heapAfter = mallinfo2().uordblks;
+    return NULL;
+}
+
+/*****************************************************************************************************************
+ * Function name : Synthetic()
+ * Inputs : size, elements, tokens
+ * Outputs : body of about size bytes, to be freed by the caller
+ * Description : This function writes a synthetic response and the number of elements and tokens it has.
+ *****************************************************************************************************************/
+
+static char *Synthetic(size_t size, uint32_t *elements, uint32_t *tokens)
+{
+    char *text = malloc(size + 256);
+    size_t length;
+    uint32_t count = 0;
+
+    length = sprintf(text, "{\"error\":0,\"ID\":\"xxxxxxxxx\",\"pot\":[");
+    while(length < size)
+    {
+        length += sprintf(text + length, "%s[%llu,%u,\"s\\\"%u\\u00e9\"]", (count == 0) ? "" : ",",
+                          1792171904573ULL + count*100ULL, (count*37) % 256, count);
+        count++;
+    }
+    length += sprintf(text + length, "]}\r\n");
+    text[length] = 0;
+    *elements = count;
+    *tokens = 7 + 4*count;
+    return text;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t pieces[] = {1, 7, READ_SIZE};
+    size_t largest = ((argc > 1) ? strtoul(argv[1], NULL, 0) : 64)*1024*1024, size;
+    uint32_t index, piece, failures = 0, elements, tokens;
+    pthread_attr_t attributes;
+    pthread_t thread;
+    char *text;
+
+    for(index = 0; index < sizeof(cases)/sizeof(cases[0]); index++)
+    {
+        for(piece = 0; piece < sizeof(pieces)/sizeof(pieces[0]); piece++)
+        {
+            int32_t result = Parse(cases[index].body, strlen(cases[index].body), pieces[piece]);
+            bool valueOk = (cases[index].error == NULL) ? !json.bFound :
+                           (json.bFound && strcmp(json.pcValue, cases[index].error) == 0);
+
+            if(result != cases[index].result || json.ui32Tokens != cases[index].tokens || !valueOk)
+            {
+                printf("FAIL %s in pieces of %u: result %d tokens %u error %s\n", cases[index].body, pieces[piece],
+                       result, json.ui32Tokens, json.bFound ? json.pcValue : "(none)");
+                failures++;
+            }
+        }
+    }
+    printf("%u small bodies in pieces of 1, 7 and %u bytes: %u failures\n",
+           (unsigned)(sizeof(cases)/sizeof(cases[0])), READ_SIZE, failures);
+
+    printf("parser state %zu bytes, g_buff %zu bytes\n", sizeof(json), sizeof(g_buff));
+    printf("%10s %9s %9s %10s %8s %10s %10s %12s\n", "body", "elements", "tokens", "parse ms", "MB/s", "stack", "heap",
+           "old malloc");
+
+    /*the first call of a library function can use more stack than the parse*/
+    stack = aligned_alloc(4096, STACK_BYTES);
+    Seconds();
+    for(size = 1024; size <= largest; size *= 4)
+    {
+        text = Synthetic(size, &elements, &tokens);
+        body = text;
+        bodyLength = strlen(text);
+
+        pthread_attr_init(&attributes);
+        pthread_attr_setstack(&attributes, stack, STACK_BYTES);
+        pthread_create(&thread, &attributes, ParseThread, NULL);
+        pthread_join(thread, NULL);
+        pthread_attr_destroy(&attributes);
+
+        if(bodyResult != JSON_STREAM_OK || json.ui32Tokens != tokens || !json.bFound || strcmp(json.pcValue, "0") != 0)
+        {
+            printf("FAIL synthetic body of %zu bytes: result %d tokens %u of %u\n", bodyLength, bodyResult,
+                   json.ui32Tokens, tokens);
+            failures++;
+        }
+        printf("%10zu %9u %9u %10.2f %8.1f %10u %10zd %12zu\n", bodyLength, elements, json.ui32Tokens,
+               parseSeconds*1000.0, bodyLength/parseSeconds/1e6, stackUsed,
+               (ssize_t)(heapAfter - heapBefore), (bodyLength > sizeof(g_buff)) ? bodyLength : 0);
+        free(text);
+    }
+    printf("stack is the deepest stack use of the parse (at least 256), heap the change of the heap in use during the parse\n");
+    free(stack);
+    return (failures != 0) ? 1 : 0;
+}
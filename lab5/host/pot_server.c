@@ -0,0 +1,417 @@
+/*********************************************************************************************************************
+ * File name : pot_server.c
+ * Description : Stand-in on a PC for the web server of lab 5. It accepts the uploads of ../main.c on an HTTP/1.1
+ * connection that is kept open between requests, like the server of the lab:
+ *   POST /  with the body  func=save&ID=<id>&NOW=<ms>&POT=<ms>:<value>,<ms>:<value>,...   (batch of samples)
+ *   GET  /?func=save&ID=<id>&POT=<value>                                                   (one sample, old format)
+ *   GET  /?func=show&ID=<id>                                         (last samples of the board, for a web browser)
+ * The format of the batch is described in ../potbatch.h. Every save is answered with {"error":0}, or {"error":1} if
+ * the request cannot be decoded, as application/json with a Content-Length, so that the board keeps the connection.
+ *
+ * For every request one line is printed with the samples it carried, the bytes received and sent on the connection for
+ * it and the bytes per sample, followed by the totals since start. The samples are printed with the time they were
+ * taken, computed from the time of the server when the request arrived and the NOW field of the board.
+ * With a close count n > 0 the server answers every n-th request with "Connection: close" and closes the connection,
+ * to test how the board opens it again.
+ *
+ * Build and run:
+ *   gcc -std=gnu99 -O2 -Wall lab5/host/pot_server.c -o pot_server
+ *   ./pot_server [port [close count [-v]]]
+ * and set HOST_NAME and HOST_PORT of main.c to the address of the PC. The port is 8080 by default.
+ *********************************************************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/*Longest request header and body accepted. The body of the board fits in its buffer of 1460 bytes*/
+#define HEADER_MAX          2048
+#define BODY_MAX            4096
+
+/*Samples kept for func=show*/
+#define SHOW_SAMPLES        20
+
+/*One request as received*/
+typedef struct
+{
+    char method[8];
+    char uri[HEADER_MAX];
+    char body[BODY_MAX + 1];
+    uint32_t bodyLength;
+    uint32_t bytes;
+    bool close;
+} tRequest;
+
+/*A stored sample: wall clock time in ms and value 0-255*/
+typedef struct
+{
+    uint64_t time;
+    uint32_t value;
+} tSample;
+
+static char buffer[HEADER_MAX + BODY_MAX];
+static uint32_t bufferLength;
+static tSample shown[SHOW_SAMPLES];
+static uint32_t shownCount;
+static bool verbose;
+
+/*Totals since start*/
+static uint64_t totalRequests, totalSamples, totalBytesIn, totalBytesOut, totalConnections;
+
+/*****************************************************************************************************************
+ * Function name : NowMs()
+ * Outputs : wall clock time in ms
+ *****************************************************************************************************************/
+
+static uint64_t NowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec*1000 + now.tv_nsec/1000000;
+}
+
+/*****************************************************************************************************************
+ * Function name : FindParameter()
+ * Inputs : query, name
+ * Outputs : value of the parameter name in the form or query string query, NULL if it is missing
+ * Description : The value ends at the next '&' or at the end of query.
+ *****************************************************************************************************************/
+
+static const char *FindParameter(const char *query, const char *name)
+{
+    size_t length = strlen(name);
+    const char *field = query;
+
+    while(field != NULL && *field != 0)
+    {
+        if(strncmp(field, name, length) == 0 && field[length] == '=')
+        {
+            return field + length + 1;
+        }
+        field = strchr(field, '&');
+        if(field != NULL)
+        {
+            field++;
+        }
+    }
+    return NULL;
+}
+
+/*****************************************************************************************************************
+ * Function name : StoreSample()
+ * Inputs : time, value
+ * Outputs : none
+ * Description : This function keeps the sample for func=show and prints it with -v.
+ *****************************************************************************************************************/
+
+static void StoreSample(uint64_t time, uint32_t value)
+{
+    memmove(&shown[1], &shown[0], (SHOW_SAMPLES - 1)*sizeof(shown[0]));
+    shown[0].time = time;
+    shown[0].value = value;
+    if(shownCount < SHOW_SAMPLES)
+    {
+        shownCount++;
+    }
+    if(verbose)
+    {
+        printf("    %llu.%03llu %u\n", (unsigned long long)(time/1000), (unsigned long long)(time%1000), value);
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : DecodeSave()
+ * Inputs : query, arrival
+ * Outputs : number of samples, -1 if query is not a valid save
+ * Description : This function decodes the parameters of a save request that arrived at the wall clock time arrival.
+ * Without NOW the request carries one value of the old format, taken when it arrived.
+ *****************************************************************************************************************/
+
+static int DecodeSave(const char *query, uint64_t arrival)
+{
+    const char *now = FindParameter(query, "NOW");
+    const char *pot = FindParameter(query, "POT");
+    char *end;
+    unsigned long boardNow, time = 0, delta, value;
+    int samples = 0;
+
+    if(FindParameter(query, "ID") == NULL || pot == NULL)
+    {
+        return -1;
+    }
+
+    if(now == NULL)
+    {
+        value = strtoul(pot, &end, 10);
+        if(end == pot || value > 255)
+        {
+            return -1;
+        }
+        StoreSample(arrival, value);
+        return 1;
+    }
+
+    boardNow = strtoul(now, NULL, 10);
+    while(*pot != 0 && *pot != '&')
+    {
+        delta = strtoul(pot, &end, 10);
+        if(end == pot || *end != ':')
+        {
+            return -1;
+        }
+        pot = end + 1;
+        value = strtoul(pot, &end, 10);
+        if(end == pot || value > 255 || (*end != ',' && *end != '&' && *end != 0))
+        {
+            return -1;
+        }
+        pot = (*end == ',') ? end + 1 : end;
+
+        /*the first time is absolute, the others are the time since the sample before*/
+        time = (samples == 0) ? delta : time + delta;
+        if(time > boardNow)
+        {
+            return -1;
+        }
+        StoreSample(arrival - (boardNow - time), value);
+        samples++;
+    }
+    return samples;
+}
+
+/*****************************************************************************************************************
+ * Function name : ReadRequest()
+ * Inputs : client, request
+ * Outputs : true if a complete request was read, false when the connection is closed or the request is invalid
+ * Description : This function reads the header and the Content-Length bytes of the body of the next request from
+ * client. Bytes of a following request stay in buffer.
+ *****************************************************************************************************************/
+
+static bool ReadRequest(int client, tRequest *request)
+{
+    char *headerEnd, *line, *next;
+    uint32_t headerLength, contentLength = 0;
+    ssize_t received;
+
+    while((headerEnd = memmem(buffer, bufferLength, "\r\n\r\n", 4)) == NULL)
+    {
+        if(bufferLength >= HEADER_MAX)
+        {
+            return false;
+        }
+        received = recv(client, buffer + bufferLength, sizeof(buffer) - bufferLength, 0);
+        if(received <= 0)
+        {
+            return false;
+        }
+        bufferLength += received;
+    }
+    headerLength = headerEnd - buffer + 4;
+    *headerEnd = 0;
+
+    if(sscanf(buffer, "%7s %2047s", request->method, request->uri) != 2)
+    {
+        return false;
+    }
+    request->close = false;
+    for(line = strstr(buffer, "\r\n"); line != NULL; line = next)
+    {
+        line += 2;
+        next = strstr(line, "\r\n");
+        if(strncasecmp(line, "Content-Length:", 15) == 0)
+        {
+            contentLength = strtoul(line + 15, NULL, 10);
+        }
+        else if(strncasecmp(line, "Connection:", 11) == 0)
+        {
+            request->close = strstr(line + 11, "close") != NULL;
+        }
+    }
+    if(contentLength > BODY_MAX)
+    {
+        return false;
+    }
+
+    while(bufferLength < headerLength + contentLength)
+    {
+        received = recv(client, buffer + bufferLength, sizeof(buffer) - bufferLength, 0);
+        if(received <= 0)
+        {
+            return false;
+        }
+        bufferLength += received;
+    }
+    memcpy(request->body, buffer + headerLength, contentLength);
+    request->body[contentLength] = 0;
+    request->bodyLength = contentLength;
+    request->bytes = headerLength + contentLength;
+
+    bufferLength -= headerLength + contentLength;
+    memmove(buffer, buffer + headerLength + contentLength, bufferLength);
+    return true;
+}
+
+/*****************************************************************************************************************
+ * Function name : SendResponse()
+ * Inputs : client, json, close
+ * Outputs : number of bytes sent
+ *****************************************************************************************************************/
+
+static uint32_t SendResponse(int client, const char *json, bool close)
+{
+    char response[HEADER_MAX + 1024];
+    int length;
+
+    length = snprintf(response, sizeof(response),
+                      "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n"
+                      "Connection: %s\r\n\r\n%s", strlen(json), close ? "close" : "keep-alive", json);
+    if(send(client, response, length, MSG_NOSIGNAL) != length)
+    {
+        return 0;
+    }
+    return length;
+}
+
+/*****************************************************************************************************************
+ * Function name : ShowJson()
+ * Inputs : json, size
+ * Outputs : none
+ * Description : This function writes the stored samples, newest first, as JSON to json.
+ *****************************************************************************************************************/
+
+static void ShowJson(char *json, size_t size)
+{
+    size_t length;
+    uint32_t index;
+
+    length = snprintf(json, size, "{\"error\":0,\"pot\":[");
+    for(index = 0; index < shownCount && length < size; index++)
+    {
+        length += snprintf(json + length, size - length, "%s[%llu,%u]", (index == 0) ? "" : ",",
+                           (unsigned long long)shown[index].time, shown[index].value);
+    }
+    if(length < size)
+    {
+        snprintf(json + length, size - length, "]}");
+    }
+}
+
+/*****************************************************************************************************************
+ * Function name : ServeClient()
+ * Inputs : client, closeCount
+ * Outputs : none
+ * Description : This function answers the requests of one connection until the client closes it or every
+ * closeCount requests.
+ *****************************************************************************************************************/
+
+static void ServeClient(int client, uint32_t closeCount)
+{
+    static tRequest request;
+    char json[1024];
+    const char *query, *func;
+    uint32_t requests = 0, bytesOut;
+    uint64_t arrival;
+    int samples;
+    bool closeNow;
+
+    bufferLength = 0;
+    while(ReadRequest(client, &request))
+    {
+        arrival = NowMs();
+        requests++;
+        closeNow = request.close || (closeCount != 0 && requests%closeCount == 0);
+
+        if(strcmp(request.method, "POST") == 0)
+        {
+            query = request.body;
+        }
+        else
+        {
+            query = strchr(request.uri, '?');
+            query = (query != NULL) ? query + 1 : "";
+        }
+        func = FindParameter(query, "func");
+
+        samples = 0;
+        if(func != NULL && strncmp(func, "show", 4) == 0)
+        {
+            ShowJson(json, sizeof(json));
+        }
+        else if(func != NULL && strncmp(func, "save", 4) == 0 && (samples = DecodeSave(query, arrival)) >= 0)
+        {
+            snprintf(json, sizeof(json), "{\"error\":0}");
+        }
+        else
+        {
+            samples = 0;
+            snprintf(json, sizeof(json), "{\"error\":1}");
+        }
+
+        bytesOut = SendResponse(client, json, closeNow);
+        totalRequests++;
+        totalSamples += samples;
+        totalBytesIn += request.bytes;
+        totalBytesOut += bytesOut;
+        printf("%s %u samples, %u bytes in (body %u), %u bytes out, %.1f bytes/sample | total %llu requests, "
+               "%llu samples, %.1f bytes/sample\n",
+               request.method, samples, request.bytes, request.bodyLength, bytesOut,
+               (samples != 0) ? (double)(request.bytes + bytesOut)/samples : 0.0,
+               (unsigned long long)totalRequests, (unsigned long long)totalSamples,
+               (totalSamples != 0) ? (double)(totalBytesIn + totalBytesOut)/totalSamples : 0.0);
+        fflush(stdout);
+
+        if(closeNow || bytesOut == 0)
+        {
+            break;
+        }
+    }
+    close(client);
+}
+
+int main(int argc, char **argv)
+{
+    struct sockaddr_in address;
+    int listener, client, on = 1;
+    uint32_t port = (argc > 1) ? strtoul(argv[1], NULL, 0) : 8080;
+    uint32_t closeCount = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0;
+
+    verbose = (argc > 3) && strcmp(argv[3], "-v") == 0;
+    signal(SIGPIPE, SIG_IGN);
+
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if(listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listener, 4) < 0)
+    {
+        perror("pot_server");
+        return 1;
+    }
+    printf("listening on port %u\n", port);
+    fflush(stdout);
+
+    /*the board opens one connection at a time*/
+    while((client = accept(listener, NULL, NULL)) >= 0)
+    {
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        totalConnections++;
+        printf("connection %llu\n", (unsigned long long)totalConnections);
+        ServeClient(client, closeCount);
+    }
+    perror("pot_server");
+    return 1;
+}
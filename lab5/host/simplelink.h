@@ -0,0 +1,53 @@
+/*********************************************************************************************************************
+ * File name : simplelink.h
+ * Description : Stand-in for the SimpleLink host driver header on a PC. It only declares the types and the file system
+ * functions (sl_Fs*) that ../potlog.c uses, with the prototypes of the CC3100 SDK 1.x, and the counters of
+ * sl_fs_host.c, which implements the functions with files on the PC. The build of the board uses the header of the SDK.
+ *********************************************************************************************************************/
+
+#ifndef SIMPLELINK_H_HOST_
+#define SIMPLELINK_H_HOST_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint8_t     _u8;
+typedef int8_t      _i8;
+typedef uint16_t    _u16;
+typedef int16_t     _i16;
+typedef uint32_t    _u32;
+typedef int32_t     _i32;
+
+/*Access modes of sl_FsOpen(). The encoding is the one of this stand-in, not the one of the SDK*/
+#define FS_MODE_OPEN_READ                                   0x00000000UL
+#define FS_MODE_OPEN_WRITE                                  0x10000000UL
+#define FS_MODE_OPEN_CREATE(maxSizeInBytes, accessModeFlags) \
+    (0x30000000UL | (((_u32)(accessModeFlags) & 0xF) << 24) | ((_u32)(maxSizeInBytes) & 0xFFFFFF))
+
+/*Error codes returned by the stand-in*/
+#define SL_FS_ERR_FILE_NOT_EXISTS           (-11)
+#define SL_FS_ERR_NO_AVAILABLE_NV_INDEX     (-12)
+#define SL_FS_ERR_OFFSET_OUT_OF_RANGE       (-13)
+#define SL_FS_ERR_INVALID_HANDLE            (-14)
+#define SL_FS_ERR_FAILED_TO_WRITE           (-15)
+
+_i32 sl_FsOpen(const _u8 *pFileName, const _u32 AccessModeAndMaxSize, _u32 *pToken, _i32 *pFileHandle);
+_i16 sl_FsClose(const _i32 FileHdl, const _u8 *pCeritificateFileName, const _u8 *pSignature, const _u32 SignatureLen);
+_i32 sl_FsRead(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len);
+_i32 sl_FsWrite(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len);
+_i16 sl_FsDel(const _u8 *pFileName, const _u32 Token);
+
+/*Counters of sl_fs_host.c. modelMicroseconds is the time the calls would take on the board, see sl_fs_host.c*/
+typedef struct
+{
+    uint64_t calls;
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+    uint64_t sectorErases;
+    uint64_t modelMicroseconds;
+} tSlFsHostStats;
+
+extern tSlFsHostStats slFsHostStats;
+
+#endif /* SIMPLELINK_H_HOST_ */
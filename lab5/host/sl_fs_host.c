@@ -0,0 +1,264 @@
+/*********************************************************************************************************************
+ * File name : sl_fs_host.c
+ * Description : File backed stand-in for the file system of the CC3100 (sl_Fs* of the SimpleLink host driver), so that
+ * ../potlog.c can be run and measured on a PC. Every file of the CC3100 is a file in the directory SL_FS_DIR (default
+ * sl_fs, created if needed), with the '/' of the name replaced by '_'. The behaviour of the CC3100 that matters for the
+ * log is kept:
+ *   - a file is created with a maximum size and can not grow beyond it
+ *   - opening a file for writing erases all of it, and the data only replaces the old content when the file is closed
+ *   - a handle is open either for reading or for writing, at most SL_FS_HOST_HANDLES at a time
+ *
+ * The time the calls would take on the board is added up in slFsHostStats.modelMicroseconds with a simple model: every
+ * call is a command and a response on the SPI bus of the CC3100 (SL_FS_CALL_US), the data is moved at SL_SPI_HZ, an
+ * open for writing erases the 4kB sectors of the file (SL_FS_ERASE_US each) and a write programs 256 byte pages
+ * (SL_FS_PROGRAM_US each). The defaults are typical values of the SPI bus and of a serial NOR flash, not measurements of
+ * a CC3100; they can be set with environment variables of the same name.
+ *********************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "simplelink.h"
+
+#define SL_FS_HOST_HANDLES      4
+#define SL_FS_SECTOR_BYTES      4096
+#define SL_FS_PAGE_BYTES        256
+
+/*An open file*/
+typedef struct
+{
+    bool used;
+    bool write;
+    char path[512];
+    _u8 *image;
+    _u32 size;
+} tHostFile;
+
+tSlFsHostStats slFsHostStats;
+
+static tHostFile files[SL_FS_HOST_HANDLES];
+static bool modelRead;
+static double callMicroseconds, byteMicroseconds, eraseMicroseconds, programMicroseconds;
+
+/*****************************************************************************************************************
+ * Function name : ModelSetting()
+ * Inputs : name, value
+ * Outputs : the environment variable name as a number, value if it is not set
+ *****************************************************************************************************************/
+
+static double ModelSetting(const char *name, double value)
+{
+    const char *setting = getenv(name);
+
+    return (setting != NULL) ? atof(setting) : value;
+}
+
+/*****************************************************************************************************************
+ * Function name : ModelCall()
+ * Inputs : bytes
+ * Outputs : none
+ * Description : This function counts one call that moves bytes over the SPI bus.
+ *****************************************************************************************************************/
+
+static void ModelCall(_u32 bytes)
+{
+    if(!modelRead)
+    {
+        callMicroseconds = ModelSetting("SL_FS_CALL_US", 100);
+        byteMicroseconds = 8e6/ModelSetting("SL_SPI_HZ", 12000000);
+        eraseMicroseconds = ModelSetting("SL_FS_ERASE_US", 45000);
+        programMicroseconds = ModelSetting("SL_FS_PROGRAM_US", 700);
+        modelRead = true;
+    }
+    slFsHostStats.calls++;
+    slFsHostStats.modelMicroseconds += callMicroseconds + bytes*byteMicroseconds;
+}
+
+/*****************************************************************************************************************
+ * Function name : HostPath()
+ * Inputs : name, path, size
+ * Outputs : none
+ * Description : This function writes the path of the PC file of the CC3100 file name to path.
+ *****************************************************************************************************************/
+
+static void HostPath(const _u8 *name, char *path, size_t size)
+{
+    const char *directory = getenv("SL_FS_DIR");
+    size_t length;
+
+    if(directory == NULL)
+    {
+        directory = "sl_fs";
+    }
+    mkdir(directory, 0755);
+    length = snprintf(path, size, "%s/", directory);
+    for(; *name != 0 && length + 1 < size; name++)
+    {
+        path[length++] = (*name == '/') ? '_' : *name;
+    }
+    path[length] = 0;
+}
+
+/*****************************************************************************************************************
+ * Function name : FileSize()
+ * Inputs : path
+ * Outputs : size of the PC file, negative if it does not exist
+ *****************************************************************************************************************/
+
+static long FileSize(const char *path)
+{
+    struct stat status;
+
+    return (stat(path, &status) == 0) ? (long)status.st_size : -1;
+}
+
+_i32 sl_FsOpen(const _u8 *pFileName, const _u32 AccessModeAndMaxSize, _u32 *pToken, _i32 *pFileHandle)
+{
+    tHostFile *file = NULL;
+    _u32 type = AccessModeAndMaxSize >> 28;
+    long size;
+    FILE *stream;
+    int handle;
+
+    (void)pToken;
+    ModelCall(strlen((const char *)pFileName));
+    for(handle = 0; handle < SL_FS_HOST_HANDLES; handle++)
+    {
+        if(!files[handle].used)
+        {
+            file = &files[handle];
+            break;
+        }
+    }
+    if(file == NULL)
+    {
+        return SL_FS_ERR_NO_AVAILABLE_NV_INDEX;
+    }
+    HostPath(pFileName, file->path, sizeof(file->path));
+    size = FileSize(file->path);
+
+    if(type == 3 && size < 0)
+    {
+        size = AccessModeAndMaxSize & 0xFFFFFF;
+    }
+    if(size < 0)
+    {
+        return SL_FS_ERR_FILE_NOT_EXISTS;
+    }
+
+    file->size = size;
+    file->image = malloc(size + 1);
+    file->write = (type != 0);
+    if(file->write)
+    {
+        /*the sectors of the file are erased when it is opened for writing*/
+        memset(file->image, 0xFF, size);
+        slFsHostStats.sectorErases += (size + SL_FS_SECTOR_BYTES - 1)/SL_FS_SECTOR_BYTES;
+        slFsHostStats.modelMicroseconds += (size + SL_FS_SECTOR_BYTES - 1)/SL_FS_SECTOR_BYTES*eraseMicroseconds;
+    }
+    else
+    {
+        stream = fopen(file->path, "rb");
+        if(stream == NULL || fread(file->image, 1, size, stream) != (size_t)size)
+        {
+            if(stream != NULL)
+            {
+                fclose(stream);
+            }
+            free(file->image);
+            return SL_FS_ERR_FILE_NOT_EXISTS;
+        }
+        fclose(stream);
+    }
+    file->used = true;
+    *pFileHandle = handle;
+    return 0;
+}
+
+_i16 sl_FsClose(const _i32 FileHdl, const _u8 *pCeritificateFileName, const _u8 *pSignature, const _u32 SignatureLen)
+{
+    tHostFile *file;
+    FILE *stream;
+    _i16 result = 0;
+
+    (void)pCeritificateFileName;
+    (void)pSignature;
+    (void)SignatureLen;
+    ModelCall(0);
+    if(FileHdl < 0 || FileHdl >= SL_FS_HOST_HANDLES || !files[FileHdl].used)
+    {
+        return SL_FS_ERR_INVALID_HANDLE;
+    }
+    file = &files[FileHdl];
+
+    /*the data written replaces the file when it is closed*/
+    if(file->write)
+    {
+        stream = fopen(file->path, "wb");
+        if(stream == NULL || fwrite(file->image, 1, file->size, stream) != file->size)
+        {
+            result = SL_FS_ERR_FAILED_TO_WRITE;
+        }
+        if(stream != NULL)
+        {
+            fclose(stream);
+        }
+    }
+    free(file->image);
+    file->used = false;
+    return result;
+}
+
+_i32 sl_FsRead(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len)
+{
+    tHostFile *file;
+
+    ModelCall(Len);
+    if(FileHdl < 0 || FileHdl >= SL_FS_HOST_HANDLES || !files[FileHdl].used || files[FileHdl].write)
+    {
+        return SL_FS_ERR_INVALID_HANDLE;
+    }
+    file = &files[FileHdl];
+    if(Offset >= file->size)
+    {
+        return SL_FS_ERR_OFFSET_OUT_OF_RANGE;
+    }
+    if(Len > file->size - Offset)
+    {
+        Len = file->size - Offset;
+    }
+    memcpy(pData, file->image + Offset, Len);
+    slFsHostStats.bytesRead += Len;
+    return Len;
+}
+
+_i32 sl_FsWrite(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len)
+{
+    tHostFile *file;
+
+    ModelCall(Len);
+    if(FileHdl < 0 || FileHdl >= SL_FS_HOST_HANDLES || !files[FileHdl].used || !files[FileHdl].write)
+    {
+        return SL_FS_ERR_INVALID_HANDLE;
+    }
+    file = &files[FileHdl];
+    if(Offset + Len > file->size)
+    {
+        return SL_FS_ERR_OFFSET_OUT_OF_RANGE;
+    }
+    memcpy(file->image + Offset, pData, Len);
+    slFsHostStats.bytesWritten += Len;
+    slFsHostStats.modelMicroseconds += (Len + SL_FS_PAGE_BYTES - 1)/SL_FS_PAGE_BYTES*programMicroseconds;
+    return Len;
+}
+
+_i16 sl_FsDel(const _u8 *pFileName, const _u32 Token)
+{
+    char path[512];
+
+    (void)Token;
+    ModelCall(strlen((const char *)pFileName));
+    HostPath(pFileName, path, sizeof(path));
+    return (remove(path) == 0) ? 0 : SL_FS_ERR_FILE_NOT_EXISTS;
+}
@@ -0,0 +1,398 @@
+/******************************************************************************************************************
+ * File name: jsonstream.c
+ * Description : Incremental JSON parser described in jsonstream.h. The functions do not use any peripheral, so they can
+ * also be built on a host computer.
+ * References: [1]RFC 8259, The JavaScript Object Notation (JSON) Data Interchange Format
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "jsonstream.h"
+
+static bool JsonStreamByte(tJsonStream *psJson, char cByte);
+static bool JsonStreamValue(tJsonStream *psJson, char cByte);
+static bool JsonStreamClose(tJsonStream *psJson, char cByte);
+static void JsonStreamAfterValue(tJsonStream *psJson);
+static void JsonStreamAppend(tJsonStream *psJson, char cByte);
+
+/*White space between tokens*/
+#define JSON_STREAM_SPACE(c)        ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n')
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamInit()
+ * Inputs : psJson, pcKey
+ * Outputs : none
+ * Description : This function prepares psJson for a new body. The value of the key pcKey of the outermost object is
+ * kept, pcKey can be NULL if no value is needed.
+ ***************************************************************************************************************************/
+
+void JsonStreamInit(tJsonStream *psJson, const char *pcKey)
+{
+    psJson->eState = JSON_STATE_VALUE;
+    psJson->i32Error = JSON_STREAM_OK;
+    psJson->ui32Depth = 0;
+    psJson->ui32Arrays = 0;
+    psJson->ui32Tokens = 0;
+    psJson->ui32Bytes = 0;
+    psJson->ui32HexDigits = 0;
+    psJson->bKey = false;
+    psJson->bKeyMatch = false;
+    psJson->bCapture = false;
+    psJson->bFound = false;
+    psJson->ui32TextLength = 0;
+    psJson->pcText[0] = 0;
+    psJson->pcValue[0] = 0;
+    psJson->pcKey = pcKey;
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamFeed()
+ * Inputs : psJson, pcData, ui32Length
+ * Outputs : JSON_STREAM_OK, or the error found in this or an earlier piece of the body
+ * Description : This function parses the next ui32Length bytes of the body.
+ ***************************************************************************************************************************/
+
+int32_t JsonStreamFeed(tJsonStream *psJson, const char *pcData, uint32_t ui32Length)
+{
+    uint32_t ui32Index;
+
+    if(psJson->eState == JSON_STATE_ERROR)
+    {
+        return psJson->i32Error;
+    }
+    for(ui32Index = 0; ui32Index < ui32Length; ui32Index++)
+    {
+        if(!JsonStreamByte(psJson, pcData[ui32Index]))
+        {
+            if(psJson->i32Error == JSON_STREAM_OK)
+            {
+                psJson->i32Error = JSON_STREAM_INVALID;
+            }
+            psJson->eState = JSON_STATE_ERROR;
+            psJson->ui32Bytes += ui32Index;
+            return psJson->i32Error;
+        }
+    }
+    psJson->ui32Bytes += ui32Length;
+    return JSON_STREAM_OK;
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamEnd()
+ * Inputs : psJson
+ * Outputs : JSON_STREAM_OK if the body was one complete JSON value, or the error
+ * Description : This function is called after the last byte of the body. It ends a primitive that is the whole body.
+ ***************************************************************************************************************************/
+
+int32_t JsonStreamEnd(tJsonStream *psJson)
+{
+    if(psJson->eState == JSON_STATE_PRIMITIVE && psJson->ui32Depth == 0)
+    {
+        JsonStreamAfterValue(psJson);
+    }
+    if(psJson->eState != JSON_STATE_DONE && psJson->eState != JSON_STATE_ERROR)
+    {
+        psJson->i32Error = JSON_STREAM_INCOMPLETE;
+        psJson->eState = JSON_STATE_ERROR;
+    }
+    return psJson->i32Error;
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamByte()
+ * Inputs : psJson, cByte
+ * Outputs : false if cByte is not valid in the current state
+ * Description : This function parses one byte of the body.
+ ***************************************************************************************************************************/
+
+static bool JsonStreamByte(tJsonStream *psJson, char cByte)
+{
+    switch(psJson->eState)
+    {
+    case JSON_STATE_VALUE:
+        return JSON_STREAM_SPACE(cByte) || JsonStreamValue(psJson, cByte);
+
+    case JSON_STATE_VALUE_OR_END:
+        if(cByte == ']')
+        {
+            return JsonStreamClose(psJson, cByte);
+        }
+        return JSON_STREAM_SPACE(cByte) || JsonStreamValue(psJson, cByte);
+
+    case JSON_STATE_KEY_OR_END:
+        if(cByte == '}')
+        {
+            return JsonStreamClose(psJson, cByte);
+        }
+        /*fall through*/
+    case JSON_STATE_KEY:
+        if(cByte == '"')
+        {
+            psJson->ui32Tokens++;
+            psJson->bKey = true;
+            psJson->ui32TextLength = 0;
+            psJson->eState = JSON_STATE_STRING;
+            return true;
+        }
+        return JSON_STREAM_SPACE(cByte);
+
+    case JSON_STATE_COLON:
+        if(cByte == ':')
+        {
+            psJson->eState = JSON_STATE_VALUE;
+            return true;
+        }
+        return JSON_STREAM_SPACE(cByte);
+
+    case JSON_STATE_COMMA_OR_END:
+        if(cByte == ',')
+        {
+            psJson->eState = (psJson->ui32Arrays & (1UL << (psJson->ui32Depth - 1))) ? JSON_STATE_VALUE :
+                             JSON_STATE_KEY;
+            return true;
+        }
+        if(cByte == '}' || cByte == ']')
+        {
+            return JsonStreamClose(psJson, cByte);
+        }
+        return JSON_STREAM_SPACE(cByte);
+
+    case JSON_STATE_STRING:
+        if(cByte == '"')
+        {
+            if(psJson->bKey)
+            {
+                /*only a key of the outermost object that was not cut off can match*/
+                psJson->bKey = false;
+                psJson->bKeyMatch = false;
+                if(psJson->pcKey != NULL && psJson->ui32Depth == 1 && psJson->ui32TextLength <= JSON_STREAM_TEXT_MAX)
+                {
+                    const char *pcKey = psJson->pcKey;
+                    const char *pcText = psJson->pcText;
+
+                    psJson->pcText[psJson->ui32TextLength] = 0;
+                    while(*pcKey != 0 && *pcKey == *pcText)
+                    {
+                        pcKey++;
+                        pcText++;
+                    }
+                    psJson->bKeyMatch = (*pcKey == *pcText);
+                }
+                psJson->eState = JSON_STATE_COLON;
+            }
+            else
+            {
+                JsonStreamAfterValue(psJson);
+            }
+            return true;
+        }
+        if(cByte == '\\')
+        {
+            psJson->eState = JSON_STATE_ESCAPE;
+            return true;
+        }
+        if((unsigned char)cByte < 0x20)
+        {
+            return false;
+        }
+        JsonStreamAppend(psJson, cByte);
+        return true;
+
+    case JSON_STATE_ESCAPE:
+        psJson->eState = JSON_STATE_STRING;
+        switch(cByte)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            JsonStreamAppend(psJson, cByte);
+            return true;
+        case 'b':
+            JsonStreamAppend(psJson, '\b');
+            return true;
+        case 'f':
+            JsonStreamAppend(psJson, '\f');
+            return true;
+        case 'n':
+            JsonStreamAppend(psJson, '\n');
+            return true;
+        case 'r':
+            JsonStreamAppend(psJson, '\r');
+            return true;
+        case 't':
+            JsonStreamAppend(psJson, '\t');
+            return true;
+        case 'u':
+            /*the character is kept as '?'*/
+            JsonStreamAppend(psJson, '?');
+            psJson->ui32HexDigits = 4;
+            psJson->eState = JSON_STATE_UNICODE;
+            return true;
+        default:
+            return false;
+        }
+
+    case JSON_STATE_UNICODE:
+        if(!((cByte >= '0' && cByte <= '9') || (cByte >= 'a' && cByte <= 'f') || (cByte >= 'A' && cByte <= 'F')))
+        {
+            return false;
+        }
+        if(--psJson->ui32HexDigits == 0)
+        {
+            psJson->eState = JSON_STATE_STRING;
+        }
+        return true;
+
+    case JSON_STATE_PRIMITIVE:
+        if(JSON_STREAM_SPACE(cByte) || cByte == ',' || cByte == '}' || cByte == ']')
+        {
+            /*the byte after the primitive belongs to the next token*/
+            JsonStreamAfterValue(psJson);
+            return JsonStreamByte(psJson, cByte);
+        }
+        if(!((cByte >= '0' && cByte <= '9') || (cByte >= 'a' && cByte <= 'z') || (cByte >= 'A' && cByte <= 'Z') ||
+             cByte == '+' || cByte == '-' || cByte == '.'))
+        {
+            return false;
+        }
+        JsonStreamAppend(psJson, cByte);
+        return true;
+
+    case JSON_STATE_DONE:
+        return JSON_STREAM_SPACE(cByte);
+
+    default:
+        return false;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamValue()
+ * Inputs : psJson, cByte
+ * Outputs : false if cByte cannot start a value
+ * Description : This function starts the value that begins with cByte. The value is kept if it follows the key
+ * searched.
+ ***************************************************************************************************************************/
+
+static bool JsonStreamValue(tJsonStream *psJson, char cByte)
+{
+    bool bCapture = psJson->bKeyMatch;
+
+    psJson->bKeyMatch = false;
+    psJson->ui32Tokens++;
+    psJson->ui32TextLength = 0;
+
+    if(cByte == '{' || cByte == '[')
+    {
+        if(psJson->ui32Depth == JSON_STREAM_MAX_DEPTH)
+        {
+            psJson->i32Error = JSON_STREAM_TOO_DEEP;
+            return false;
+        }
+        if(cByte == '[')
+        {
+            psJson->ui32Arrays |= 1UL << psJson->ui32Depth;
+            psJson->eState = JSON_STATE_VALUE_OR_END;
+        }
+        else
+        {
+            psJson->ui32Arrays &= ~(1UL << psJson->ui32Depth);
+            psJson->eState = JSON_STATE_KEY_OR_END;
+        }
+        psJson->ui32Depth++;
+        return true;
+    }
+
+    psJson->bCapture = bCapture;
+    if(bCapture)
+    {
+        psJson->pcValue[0] = 0;
+    }
+    if(cByte == '"')
+    {
+        psJson->bKey = false;
+        psJson->eState = JSON_STATE_STRING;
+        return true;
+    }
+    if((cByte >= '0' && cByte <= '9') || cByte == '-' || cByte == 't' || cByte == 'f' || cByte == 'n')
+    {
+        psJson->eState = JSON_STATE_PRIMITIVE;
+        JsonStreamAppend(psJson, cByte);
+        return true;
+    }
+    return false;
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamClose()
+ * Inputs : psJson, cByte
+ * Outputs : false if cByte does not close the innermost object or array
+ ***************************************************************************************************************************/
+
+static bool JsonStreamClose(tJsonStream *psJson, char cByte)
+{
+    bool bArray;
+
+    if(psJson->ui32Depth == 0)
+    {
+        return false;
+    }
+    bArray = (psJson->ui32Arrays & (1UL << (psJson->ui32Depth - 1))) != 0;
+    if(bArray != (cByte == ']'))
+    {
+        return false;
+    }
+    psJson->ui32Depth--;
+    JsonStreamAfterValue(psJson);
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamAfterValue()
+ * Inputs : psJson
+ * Outputs : none
+ * Description : This function ends a value. A value that was kept is complete.
+ ***************************************************************************************************************************/
+
+static void JsonStreamAfterValue(tJsonStream *psJson)
+{
+    if(psJson->bCapture)
+    {
+        psJson->bCapture = false;
+        psJson->bFound = true;
+    }
+    psJson->eState = (psJson->ui32Depth == 0) ? JSON_STATE_DONE : JSON_STATE_COMMA_OR_END;
+}
+
+/***************************************************************************************************************************
+ * Function name : JsonStreamAppend()
+ * Inputs : psJson, cByte
+ * Outputs : none
+ * Description : This function adds a character of a key or of the value searched to the text kept. Characters beyond
+ * JSON_STREAM_TEXT_MAX are counted but not kept.
+ ***************************************************************************************************************************/
+
+static void JsonStreamAppend(tJsonStream *psJson, char cByte)
+{
+    char *pcText;
+
+    if(psJson->bKey)
+    {
+        pcText = psJson->pcText;
+    }
+    else if(psJson->bCapture)
+    {
+        pcText = psJson->pcValue;
+    }
+    else
+    {
+        return;
+    }
+    if(psJson->ui32TextLength < JSON_STREAM_TEXT_MAX)
+    {
+        pcText[psJson->ui32TextLength] = cByte;
+        pcText[psJson->ui32TextLength + 1] = 0;
+    }
+    psJson->ui32TextLength++;
+}
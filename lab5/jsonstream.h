@@ -0,0 +1,80 @@
+/******************************************************************************************************************
+ * File name: jsonstream.h
+ * Description : Incremental JSON parser for HTTP response bodies that are read a chunk at a time.
+ *
+ * The body of a response is passed to JsonStreamFeed() in pieces of any size, down to single bytes, as they are read
+ * into one receive buffer, so the body never has to be in memory as a whole and the memory used does not depend on its
+ * size: only the tJsonStream structure and the buffer of the caller. Nothing is allocated. The parser checks the syntax
+ * of the body, counts the tokens like jsmn does (every object, array, string and primitive, keys included) and keeps
+ * the value of one key of the outermost object, for example "error" of {"error":0}, as text. The parser is strict
+ * about the structure (brackets, commas, colons, keys as strings) and loose about primitives, which only have to start
+ * like a number, true, false or null. Objects and arrays can be nested JSON_STREAM_MAX_DEPTH deep.
+ *
+ * Use:
+ *   JsonStreamInit(&sJson, "error");
+ *   while(more data) JsonStreamFeed(&sJson, pcChunk, ui32Length);
+ *   i32Result = JsonStreamEnd(&sJson);
+ * The result is JSON_STREAM_OK for a complete and valid body, then sJson.ui32Tokens holds the number of tokens and, if
+ * sJson.bFound is true, sJson.pcValue the value of the key. JsonStreamFeed() also returns an error as soon as it finds
+ * one, and ignores all data after it. The functions do not use any peripheral, so they can also be built on a host
+ * computer.
+ *********************************************************************************************************************/
+
+#ifndef JSONSTREAM_H_
+#define JSONSTREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Deepest nesting of objects and arrays, at most 32, and longest key and value kept, without the terminating 0. A
+ * longer key does not match, a longer value is cut off*/
+#define JSON_STREAM_MAX_DEPTH       32
+#define JSON_STREAM_TEXT_MAX        15
+
+/*Results*/
+#define JSON_STREAM_OK              0
+#define JSON_STREAM_INVALID         -1      /*the body is not valid JSON*/
+#define JSON_STREAM_TOO_DEEP        -2      /*objects and arrays are nested too deep*/
+#define JSON_STREAM_INCOMPLETE      -3      /*the body ended before the JSON value*/
+
+/*What the parser expects next*/
+typedef enum
+{
+    JSON_STATE_VALUE,               /*a value, at the start, after ':' or after ',' in an array*/
+    JSON_STATE_VALUE_OR_END,        /*a value or ']' after '['*/
+    JSON_STATE_KEY,                 /*a key after ',' in an object*/
+    JSON_STATE_KEY_OR_END,          /*a key or '}' after '{'*/
+    JSON_STATE_COLON,               /*':' after a key*/
+    JSON_STATE_COMMA_OR_END,        /*',' or the end of the object or array after a value*/
+    JSON_STATE_STRING,              /*characters of a string*/
+    JSON_STATE_ESCAPE,              /*character after '\' in a string*/
+    JSON_STATE_UNICODE,             /*hexadecimal digits after "\u"*/
+    JSON_STATE_PRIMITIVE,           /*characters of a number, true, false or null*/
+    JSON_STATE_DONE,                /*only white space after the value*/
+    JSON_STATE_ERROR
+} tJsonState;
+
+typedef struct
+{
+    tJsonState eState;
+    int32_t i32Error;
+    uint32_t ui32Depth;
+    uint32_t ui32Arrays;                        /*bit n set if the container at depth n + 1 is an array*/
+    uint32_t ui32Tokens;
+    uint32_t ui32Bytes;                         /*bytes parsed*/
+    uint32_t ui32HexDigits;                     /*digits of \u still expected*/
+    bool bKey;                                  /*the string is a key*/
+    bool bKeyMatch;                             /*the last key of the outermost object is the key searched*/
+    bool bCapture;                              /*the current string or primitive is the value searched*/
+    bool bFound;
+    uint32_t ui32TextLength;
+    char pcText[JSON_STREAM_TEXT_MAX + 1];      /*key being read*/
+    char pcValue[JSON_STREAM_TEXT_MAX + 1];     /*value of the key searched*/
+    const char *pcKey;
+} tJsonStream;
+
+void JsonStreamInit(tJsonStream *psJson, const char *pcKey);
+int32_t JsonStreamFeed(tJsonStream *psJson, const char *pcData, uint32_t ui32Length);
+int32_t JsonStreamEnd(tJsonStream *psJson);
+
+#endif /* JSONSTREAM_H_ */
@@ -3,24 +3,55 @@
  * Program Objective: To understand how to use the CC3100 SimpleLink Wi-Fi BoosterPack to
  * connect to a wifi access point and transfer data to a web server.
  * Objectives    : 1. CC3100 can connect to `Embedded_Lab_EXT` Wi-Fi network.
-                   2. CC3100 can communicate with HTTP server with aid of GET method.
-                   An appropriate GET URL is generated based on current POT value and it
-                   is sent to the HTTP server.
+                   2. CC3100 can communicate with HTTP server with aid of POST method.
+                   The POT is sampled every POT_SAMPLE_PERIOD_MS into a ring of samples
+                   and all samples taken since the last upload are sent in the body of
+                   one request, as a list of time stamp and value pairs.
                    3. HTTP response, i.e. JSON value, is parsed and the final error output
                    is shown on terminal panel in CCS software.
                    4. Timer and ADC peripherals are activated, and they are handled by using
-                   interrupt services. The system can send POT value every 5 seconds
-                   automatically.
+                   interrupt services. The system can send the POT samples every 5
+                   seconds automatically.
                    5. The correctness of recent saved POT values are tested by using
                    `show` functionality.
+                   6. The connection to the access point and to the HTTP server is opened
+                   once and kept. It is only opened again after a WLAN disconnection, a
+                   socket error or a server that closes the connection, with an
+                   exponential backoff between failed attempts.
+                   7. Samples taken while the AP or the server is down are kept in a log on
+                   the serial flash of the CC3100 and sent in full batches when the
+                   connection is back.
  * Description : CC3100 SimpleLink Wi-Fi module is stacked on top of the Tiva board and pot is
  * connected to the pin PE3 of Tiva board. When the program starts executing, the CC3100 module
  * establishes connection with the wifi access point and it gets connected to the internet.
- * After every five seconds the pot value is send to the server using GET method. The pot value
- * is updated in the table given in the web site and it is accessed using the
- * URL - http://192.168.2.18/?func=show&ID=xxxxxxxx. The ADC0 and Timer0 modules are enabled to
- * convert the pot values to digital and send them to the web server respectively. The JSON tokens
+ * The SysTick handler samples the pot every POT_SAMPLE_PERIOD_MS with ADC0 and stores the value
+ * with its time in ms in the ring sPotRing (potbatch.h). After every five seconds (Timer0) the
+ * samples of the ring are written to g_buff as
+ *   func=save&ID=xxxxxxxxx&NOW=<ms>&POT=<ms>:<value>,<ms>:<value>,...
+ * and sent to the server with the POST method. The samples are removed from the ring only after
+ * the server has answered with status 200 and "error":0, so samples taken while the connection
+ * is down or refused by the server are sent later. One request now carries 50 samples of about
+ * 8 bytes each instead of one value, so the request and response headers of about 250 bytes
+ * are shared by all of them: measured with the stand-in server a sample takes 9 to 10 bytes on
+ * the connection in full batches instead of 231, and one round trip in 50.
+ * When the connection is down for longer than the ring lasts, the samples are moved to a log of
+ * segment files on the serial flash of the CC3100 (potlog.h), which holds more than half an hour
+ * of samples. When the connection is back the log is sent first, one full g_buff per request
+ * without waiting for the timer, and the ring follows. lab5/host/DrainBench.c measures the log
+ * with a file backed stand-in of the sl_Fs functions.
+ * The pot values are updated in
+ * the table given in the web site and it is accessed using the
+ * URL - http://192.168.2.18/?func=show&ID=xxxxxxxx. lab5/host/pot_server.c is a stand-in for the
+ * server that runs on a PC (set HOST_NAME and HOST_PORT to its address). The JSON tokens
  * and error value are printed on the terminal after the value is successfully received.
+ * The body of a response is read READ_SIZE bytes at a time into g_buff and every chunk is fed
+ * to the streaming parser of jsonstream.h, so a response of any length is handled without
+ * malloc() and with the same memory: g_buff and 80 bytes of parser state. The parser takes
+ * less than 300 bytes of stack. lab5/host/ResponseBench.c parses synthetic responses of up to
+ * 64MB that way at about 115MB/s on a PC.
+ * The connection manager (ConnectionManagerService()) keeps the association with the access
+ * point and one HTTP/1.1 keep-alive connection to the server open, so an upload only takes the
+ * round trip of one request instead of an association, DHCP, DNS look up and TCP handshake.
  * Externally modified files: user.h, ssock.h, sl_common.h
  * TI provided code http_client is used in this program and the copyright goes to,
  * Copyright (C) 2014 Texas Instruments Incorporated - http://www.ti.com/
@@ -56,10 +87,14 @@
 #include "stdint.h"
 #include "httpcli.h"
 #include "httpcli.c"
-#include "jsmn.h"
-#include "jsmn.c"
+#include "jsonstream.h"
+#include "jsonstream.c"
 #include "ssock.h"
 #include "ssock.c"
+#include "potbatch.h"
+#include "potbatch.c"
+#include "potlog.h"
+#include "potlog.c"
 #include"inc/hw_memmap.h"
 #include"driverlib/gpio.h"
 #include"inc/hw_types.h"
@@ -69,6 +104,7 @@
 #include"driverlib/uart.h"
 #include "driverlib/timer.h"
 #include "driverlib/interrupt.h"
+#include "driverlib/systick.h"
 #include"driverlib/pin_map.h"
 #include "inc/hw_ints.h"
 #include"driverlib/uart.h"
@@ -78,13 +114,16 @@ static _i32 configureSimpleLinkToDefaultState();
 static _i32 initializeAppVariables();
 static void  displayBanner();
 static _i32 ConnectToHTTPServer(HTTPCli_Handle httpClient);
-static _i32 HTTPGetMethod(HTTPCli_Handle httpClient);
+static _i32 HTTPPostMethod(HTTPCli_Handle httpClient, const _i8 *pcBody, _u32 ui32Length);
 static _i32 readResponse(HTTPCli_Handle httpClient);
 static void FlushHTTPResponse(HTTPCli_Handle httpClient);
-static _i32 ParseJSONData(_i8 *ptr);
 void Timer0AIntHandler(void);
 void TimerInitAndStart(void);
-void ADC0InitAndTrigger(void);
+void ADC0Init(void);
+void SysTickIntHandler(void);
+void SysTickInit(void);
+void ConnectionManagerService(HTTPCli_Handle httpClient);
+void ConnectionClose(HTTPCli_Handle httpClient, bool bFailed);
 
 #define APPLICATION_VERSION "1.2.0"
 #define SL_STOP_TIMEOUT        0xFF
@@ -101,15 +140,73 @@ void ADC0InitAndTrigger(void);
 #define MAX_BUFF_SIZE   1460
 #define SPACE           32
 
-char GET_REQUEST_URI[32] =       "/?func=save&ID=xxxxxxxxx&POT=";
+/*Rate of the SysTick interrupt that counts the milliseconds for the connection manager*/
+#define TICK_RATE_HZ                1000
+
+/*Time the connection manager waits for the association and the IP address before it gives up,
+ * and the shortest and longest wait before a connection is opened again after a failure. The
+ * wait doubles with every failure and goes back to 0 after a successful request*/
+#define WLAN_CONNECT_TIMEOUT_MS     15000
+#define RECONNECT_BACKOFF_MIN_MS    500
+#define RECONNECT_BACKOFF_MAX_MS    60000
+
+/*Time between two POT samples, the ID of the board in the uploaded data and the URI the samples
+ * are posted to*/
+#define POT_SAMPLE_PERIOD_MS        100
+#define POT_DEVICE_ID               "xxxxxxxxx"
+#define POT_POST_URI                "/"
+
+/*Samples in the ring at which they are moved to the log if they cannot be uploaded, and time
+ * before the log is written again after a failure*/
+#define POT_LOG_SPILL_SAMPLES       (POT_RING_SIZE/2)
+#define POT_LOG_RETRY_MS            1000
+
+/*States of the connection manager
+ * CONNECTION_WLAN_IDLE    : not associated, sl_WlanConnect() is called when the backoff time has passed
+ * CONNECTION_WLAN_WAIT    : waiting for the connection and IP acquired events
+ * CONNECTION_SERVER       : the WLAN is up, the TCP connection to the server is opened when the backoff
+ *                           time has passed
+ * CONNECTION_READY        : the HTTP connection is open and every request reuses it*/
+typedef enum
+{
+    CONNECTION_WLAN_IDLE,
+    CONNECTION_WLAN_WAIT,
+    CONNECTION_SERVER,
+    CONNECTION_READY
+} e_ConnectionState;
+
 uint32_t ui32FlagToCheckTimer = 0;
-uint32_t ui32ADC0DigitalValue[1], ui32ADCValueStore;
+uint32_t ui32ADC0DigitalValue[1];
 _u32 g_Status;
 _u32 g_DestinationIP;
 _u32 g_BytesReceived; /* variable to store the file size */
 _u8  g_buff[MAX_BUFF_SIZE+1];
+tJsonStream sJson;
 _i32 g_SockID = 0;
 
+/*milliseconds since start up, counted by SysTickIntHandler()*/
+volatile uint32_t ui32TickCount;
+
+/*POT samples waiting for the upload, tick of the next sample and tick at which the conversion
+ * read by the next sample was started*/
+tPotRing sPotRing;
+uint32_t ui32SampleTick;
+uint32_t ui32ConversionTick;
+bool bConversionStarted;
+
+/*log of the samples that could not be uploaded and tick of the last failed write to it*/
+tPotLog sPotLog;
+uint32_t ui32LogErrorTick;
+
+/*state of the connection manager, tick at which the current state started or the last attempt
+ * failed, and wait before the next attempt*/
+e_ConnectionState eConnectionState = CONNECTION_WLAN_IDLE;
+uint32_t ui32ConnectionTick;
+uint32_t ui32BackoffMs;
+
+/*cleared when the last request failed or the server announced that it closes the connection*/
+bool bKeepConnection;
+
 typedef enum{
     DEVICE_NOT_IN_STATION_MODE = -0x7D0,
     INVALID_HEX_STRING = DEVICE_NOT_IN_STATION_MODE - 1,
@@ -280,8 +377,11 @@ int main(int argc, char** argv)
 {
    _i32            retVal = -1;
    HTTPCli_Struct     httpClient;
-   int ui32DigitFromADCValue;
-   int ui32DigitExtraction;
+   uint32_t ui32RequestStart;
+   uint32_t ui32Samples, ui32Length, ui32Lost = 0;
+   tPotBatch sBatch;
+   bool bFromLog;
+   _i8 printBuffer[12];
    stopWDT();
    initClk();
    CLI_Configure();
@@ -299,10 +399,13 @@ int main(int argc, char** argv)
    }
    CLI_Write(" Device is configured in default state \n\r");
 
+   PotLogInit(&sPotLog);
+   ADC0Init();
    TimerInitAndStart();
+   SysTickInit();
 
-   while(1)
-   {
+   /*The device is started once. The connection manager opens the connections to the AP and to
+    * the server and keeps them, so the loop only waits for the timer and sends a request*/
    retVal = sl_Start(0, 0, 0);
    if ((retVal < 0) || (ROLE_STA != retVal) )
    {
@@ -310,45 +413,116 @@ int main(int argc, char** argv)
        LOOP_FOREVER();
    }
    CLI_Write(" Device started as STATION \n\r");
-   retVal = establishConnectionWithAP();
-   if(retVal < 0)
+
+   while(1)
    {
-       CLI_Write(" Failed to establish connection w/ an AP \n\r");
-       LOOP_FOREVER();
-   }
-   CLI_Write(" Connection established w/ AP and IP is acquired \n\r");
-   retVal = ConnectToHTTPServer(&httpClient);
-   if(retVal < 0)
+   _SlNonOsMainLoopTask();
+   ConnectionManagerService(&httpClient);
+
+   /*Samples that cannot be uploaded now are moved from the half full ring to the log. The flash
+    * is only written while the connection is down: while the log is sent, the new samples wait in
+    * the ring, which lasts POT_RING_SIZE sample periods, and are sent after the log, so the server
+    * still gets them in the order they were taken*/
+   if(PotRingCount(&sPotRing) >= POT_LOG_SPILL_SAMPLES &&
+      eConnectionState != CONNECTION_READY &&
+      ui32TickCount - ui32LogErrorTick >= POT_LOG_RETRY_MS)
    {
-       LOOP_FOREVER();
+       if(PotLogAppend(&sPotLog, &sPotRing, PotRingCount(&sPotRing)) < 0)
+       {
+           CLI_Write(" Failed to write the sample log\n\r");
+           ui32LogErrorTick = ui32TickCount;
+       }
    }
-   ADC0InitAndTrigger();
-   if(ui32FlagToCheckTimer)
+
+   /*The log is sent as soon as the connection is ready, a full batch on every pass of the loop,
+    * and the ring every five seconds when the log is empty. A ring that has filled up to
+    * POT_LOG_SPILL_SAMPLES while the log was sent is sent at once when the log is empty*/
+   if(eConnectionState == CONNECTION_READY &&
+      (PotLogCount(&sPotLog) != 0 || (ui32FlagToCheckTimer && PotRingCount(&sPotRing) != 0) ||
+       PotRingCount(&sPotRing) >= POT_LOG_SPILL_SAMPLES))
    {
        CLI_Write("\n\r");
-       CLI_Write(" HTTP Get Test Begin:\n\r");
-
-       /*The pot value is dynamically appended with the GET_REQUEST_URI to update it in the server.
-        * When the get request starts, the pot value is scaled to a value from 0 to 255 by dividing
-        * it by 16. The MSB to LSB digits are extracted and converted to ASCII by adding 48 to those digits.
-        * These ASCII numbers are appended at the end of the string "/?func=save&ID=xxxxxxxxx&POT=" to
-        * save the values to the server.*/
-       ui32DigitExtraction = (int)ui32ADCValueStore/16;
-       ui32DigitFromADCValue = ui32DigitExtraction/100;
-       ui32DigitExtraction = ui32DigitExtraction-ui32DigitFromADCValue*100;
-       GET_REQUEST_URI[29]= ui32DigitFromADCValue+48;
-       ui32DigitFromADCValue = ui32DigitExtraction/10;
-       GET_REQUEST_URI[30] = ui32DigitFromADCValue+48;
-       ui32DigitExtraction = ui32DigitExtraction-ui32DigitFromADCValue*10;
-       GET_REQUEST_URI[31] = ui32DigitExtraction+48;
-       retVal = HTTPGetMethod(&httpClient);
-       ui32FlagToCheckTimer = 0;
+       CLI_Write(" HTTP Post Test Begin:\n\r");
+       /*The oldest samples of the log or of the ring are written to g_buff until it is full or all
+        * samples are in it. The value of a sample is scaled to a value from 0 to 255 by dividing it
+        * by 16, like the single value that was sent before. The samples stay in the log or in the
+        * ring until the server has answered, so a failed request sends them again with the next one*/
+       ui32RequestStart = ui32TickCount;
+       bFromLog = PotLogCount(&sPotLog) != 0;
+       PotBatchBegin(&sBatch, (char *)g_buff, sizeof(g_buff), POT_DEVICE_ID, ui32RequestStart);
+       if(bFromLog)
+       {
+           ui32Samples = PotLogFill(&sPotLog, &sBatch);
+       }
+       else
+       {
+           for(ui32Samples = 0; ui32Samples < PotRingCount(&sPotRing); ui32Samples++)
+           {
+               const tPotSample *psSample = PotRingPeek(&sPotRing, ui32Samples);
+
+               if(!PotBatchAdd(&sBatch, psSample->ui32Time, psSample->ui16Value))
+               {
+                   break;
+               }
+           }
+           ui32FlagToCheckTimer = 0;
+       }
+       /*nothing to send if the log could not be read*/
+       if(ui32Samples == 0)
+       {
+           continue;
+       }
+       ui32Length = PotBatchEnd(&sBatch);
+       bKeepConnection = true;
+       retVal = HTTPPostMethod(&httpClient, (const _i8 *)g_buff, ui32Length);
        if(retVal < 0)
        {
-           CLI_Write(" HTTP Get Test failed.\n\r");
+           CLI_Write(" HTTP Post Test failed.\n\r");
+       }
+       else
+       {
+           /*a successful request ends the backoff and removes the samples it carried*/
+           if(bFromLog)
+           {
+               PotLogRemove(&sPotLog, ui32Samples);
+           }
+           else
+           {
+               PotRingRemove(&sPotRing, ui32Samples);
+           }
+           ui32BackoffMs = 0;
+           CLI_Write(" HTTP Post Test Completed Successfully, ");
+           sprintf((char *)printBuffer, "%lu", (unsigned long)ui32Samples);
+           CLI_Write((_u8 *)printBuffer);
+           CLI_Write(" samples in ");
+           sprintf((char *)printBuffer, "%lu", (unsigned long)(ui32TickCount - ui32RequestStart));
+           CLI_Write((_u8 *)printBuffer);
+           CLI_Write(" ms\n\r");
+           if(bFromLog)
+           {
+               CLI_Write(" Samples left in the log: ");
+               sprintf((char *)printBuffer, "%lu", (unsigned long)PotLogCount(&sPotLog));
+               CLI_Write((_u8 *)printBuffer);
+               CLI_Write("\n\r");
+           }
+       }
+       /*samples lost because the ring or the log was full during a long outage*/
+       if(sPotRing.ui32Lost + sPotLog.ui32Lost != ui32Lost)
+       {
+           CLI_Write(" Samples lost: ");
+           sprintf((char *)printBuffer, "%lu", (unsigned long)(sPotRing.ui32Lost + sPotLog.ui32Lost - ui32Lost));
+           CLI_Write((_u8 *)printBuffer);
+           CLI_Write("\n\r");
+           ui32Lost = sPotRing.ui32Lost + sPotLog.ui32Lost;
        }
-       CLI_Write(" HTTP Get Test Completed Successfully\n\r");
        CLI_Write("\n\r");
+
+       /*a failed request or a connection closed by the server is opened again, after the backoff
+        * only if the request failed*/
+       if(!bKeepConnection)
+       {
+           ConnectionClose(&httpClient, retVal < 0);
+       }
    }
    }
    retVal = sl_Stop(SL_STOP_TIMEOUT);
@@ -360,33 +534,55 @@ int main(int argc, char** argv)
 }
 
 /**********************************************************************************************
- * Function name: HTTPGetMethod
- * Inputs: HTTPCli_Handle httpClient
+ * Function name: HTTPPostMethod
+ * Inputs: HTTPCli_Handle httpClient, const _i8 *pcBody, _u32 ui32Length
  * Outputs: retVal
- * Description: This function demonstrate the HTTP GET method
+ * Description: This function demonstrate the HTTP POST method. The ui32Length bytes of pcBody
+ * are sent as a form to POT_POST_URI. The request asks the server to keep the connection open
+ * for the next request. bKeepConnection is cleared if the request cannot be sent or the response
+ * cannot be read, so that the connection is opened again.
  * Copyright: Copyright (C) 2014 Texas Instruments Incorporated - http://www.ti.com/
  **********************************************************************************************/
 
-static _i32 HTTPGetMethod(HTTPCli_Handle httpClient)
+static _i32 HTTPPostMethod(HTTPCli_Handle httpClient, const _i8 *pcBody, _u32 ui32Length)
 {
     _i32             retVal = 0;
-    bool             moreFlags;
-    const HTTPCli_Field    fields[4] = {
+    bool             moreFlags = 1;
+    bool             lastFlag = 1;
+    _i8              lengthBuffer[12];
+    const HTTPCli_Field    fields[5] = {
                                     {HTTPCli_FIELD_NAME_HOST, HOST_NAME},
                                     {HTTPCli_FIELD_NAME_ACCEPT, "*/*"},
-                                    {HTTPCli_FIELD_NAME_CONTENT_LENGTH, "0"},
+                                    {HTTPCli_FIELD_NAME_CONTENT_TYPE, "application/x-www-form-urlencoded"},
+                                    {HTTPCli_FIELD_NAME_CONNECTION, "keep-alive"},
                                     {NULL, NULL}
                                 };
 
     HTTPCli_setRequestFields(httpClient, fields);
 
-    moreFlags = 0;
-    CLI_Write(GET_REQUEST_URI);
-    CLI_Write("\n");
-    retVal = HTTPCli_sendRequest(httpClient, HTTPCli_METHOD_GET, GET_REQUEST_URI, moreFlags);
+    /*the Content-Length field is sent after the request line and the fields above*/
+    retVal = HTTPCli_sendRequest(httpClient, HTTPCli_METHOD_POST, POT_POST_URI, moreFlags);
+    if(retVal < 0)
+    {
+        CLI_Write(" Failed to send HTTP POST request header.\n\r");
+        bKeepConnection = false;
+        return retVal;
+    }
+
+    sprintf((char *)lengthBuffer, "%lu", (unsigned long)ui32Length);
+    retVal = HTTPCli_sendField(httpClient, HTTPCli_FIELD_NAME_CONTENT_LENGTH, (const char *)lengthBuffer, lastFlag);
+    if(retVal < 0)
+    {
+        CLI_Write(" Failed to send HTTP POST request header.\n\r");
+        bKeepConnection = false;
+        return retVal;
+    }
+
+    retVal = HTTPCli_sendRequestBody(httpClient, (const char *)pcBody, ui32Length);
     if(retVal < 0)
     {
-        CLI_Write(" Failed to send HTTP GET request.\n\r");
+        CLI_Write(" Failed to send HTTP POST request body.\n\r");
+        bKeepConnection = false;
         return retVal;
     }
     retVal = readResponse(httpClient);
@@ -397,7 +593,14 @@ static _i32 HTTPGetMethod(HTTPCli_Handle httpClient)
  * Function name: readResponse
  * Inputs: HTTPCli_Handle httpClient
  * Outputs: retVal
- * Description: This function read response from server and dump on console
+ * Description: This function read response from server and dump on console. The body is read
+ * READ_SIZE bytes at a time into g_buff and a JSON body is parsed chunk by chunk with sJson,
+ * so nothing is allocated whatever the length of the body. Only the first chunk is printed. A
+ * response with "Connection: close" or one that cannot be read completely clears
+ * bKeepConnection. Only status 200 with an "error" value of 0 returns 0. Every other answer,
+ * including a body that cannot be read completely or parsed, returns a negative value, so the
+ * samples stay queued, and clears bKeepConnection, so the request is sent again after the
+ * backoff.
  * Copyright: Copyright (C) 2014 Texas Instruments Incorporated - http://www.ti.com/
  **********************************************************************************************/
 
@@ -407,9 +610,11 @@ static _i32 readResponse(HTTPCli_Handle httpClient)
     _i32            bytesRead = 0;
     _i32            id = 0;
     _u32            len = 0;
+    _u32            total = 0;
     _i32            json = 0;
-    _i8             *dataBuffer=NULL;
+    bool            bLength = false;
     bool            moreFlags = 1;
+    _i8             printBuffer[12];
     const _i8       *ids[4] = {
                                 HTTPCli_FIELD_NAME_CONTENT_LENGTH,
                                 HTTPCli_FIELD_NAME_CONNECTION,
@@ -435,10 +640,16 @@ static _i32 readResponse(HTTPCli_Handle httpClient)
                 case 0:
                 {
                     len = strtoul((char *)g_buff, NULL, 0);
+                    bLength = true;
                 }
                 break;
                 case 1:
                 {
+                    if(!strncmp((const char *)g_buff, "close", sizeof("close")))
+                    {
+                        CLI_Write(" Connection terminated by server\n\r");
+                        bKeepConnection = false;
+                    }
                 }
                 break;
                 case 2:
@@ -461,73 +672,108 @@ static _i32 readResponse(HTTPCli_Handle httpClient)
                 default:
                 {
                     CLI_Write(" Wrong filter id\n\r");
+                    bKeepConnection = false;
                     retVal = -1;
                     goto end;
                 }
                 }
             }
-            bytesRead = 0;
-            if(len > sizeof(g_buff))
+            if(json)
+            {
+                JsonStreamInit(&sJson, "error");
+            }
+            do
             {
-                dataBuffer = (_i8 *) malloc(len);
-                if(dataBuffer)
+                bytesRead = HTTPCli_readResponseBody(httpClient, (char *)g_buff, READ_SIZE, &moreFlags);
+                if(bytesRead < 0)
                 {
-                    CLI_Write(" Failed to allocate memory\n\r");
-                    retVal = -1;
+                    CLI_Write(" Failed to received response body\n\r");
+                    bKeepConnection = false;
+                    retVal = bytesRead;
                     goto end;
                 }
-            }
-            else
-            {
-                dataBuffer = (_i8 *)g_buff;
-            }
-            bytesRead = HTTPCli_readResponseBody(httpClient, (char *)dataBuffer, len, &moreFlags);
-            if(bytesRead < 0)
+                if(total == 0 && bytesRead > 0)
+                {
+                    g_buff[bytesRead] = '\0';
+                    CLI_Write(g_buff);
+                }
+                if(json)
+                {
+                    JsonStreamFeed(&sJson, (const char *)g_buff, bytesRead);
+                }
+                total += bytesRead;
+            } while(moreFlags && bytesRead > 0);
+
+            if(moreFlags || (bLength && total != len))
             {
-                CLI_Write(" Failed to received response body\n\r");
-                retVal = bytesRead;
+                /*the rest of the body would be taken as the next response*/
+                CLI_Write(" Mismatch in content length and received data length\n\r");
+                bKeepConnection = false;
+                retVal = TCP_RECV_ERROR;
                 goto end;
             }
-            else if( bytesRead < len || moreFlags)
+            if(total > READ_SIZE)
             {
-                CLI_Write(" Mismatch in content length and received data length\n\r");
-                goto end;
+                CLI_Write("\n\r ... ");
+                sprintf((char *)printBuffer, "%lu", (unsigned long)total);
+                CLI_Write((_u8 *)printBuffer);
+                CLI_Write(" bytes\n\r");
             }
-            dataBuffer[bytesRead] = '\0';
-            CLI_Write(dataBuffer);
             if(json)
             {
-                retVal = ParseJSONData(dataBuffer);
+                retVal = JsonStreamEnd(&sJson);
                 if(retVal < 0)
                 {
+                    CLI_Write(" Failed to parse JSON tokens\n\r");
+                    bKeepConnection = false;
                     goto end;
                 }
+                CLI_Write(" Successfully parsed ");
+                sprintf((char *)printBuffer, "%lu", (unsigned long)sJson.ui32Tokens);
+                CLI_Write((_u8 *)printBuffer);
+                CLI_Write(" JSON tokens\n\r");
+                if(sJson.bFound)
+                {
+                    CLI_Write(" error : ");
+                    CLI_Write((_u8 *)sJson.pcValue);
+                    CLI_Write("\n\r");
+                }
             }
-            else
+            /*the samples are only saved if the server says so with "error":0*/
+            if(!json || !sJson.bFound || strcmp(sJson.pcValue, "0") != 0)
             {
+                CLI_Write(" The server did not save the samples\n\r");
+                bKeepConnection = false;
+                retVal = -1;
+                goto end;
             }
         }
         break;
         case 404:
             CLI_Write(" File not found. \r\n");
         default:
+            /*no other status carries the "error" value, so the samples stay queued*/
             FlushHTTPResponse(httpClient);
-            break;
+            sprintf((char *)printBuffer, "%ld", (long)retVal);
+            CLI_Write(" HTTP Status ");
+            CLI_Write((_u8 *)printBuffer);
+            CLI_Write("\n\r");
+            bKeepConnection = false;
+            retVal = -1;
+            goto end;
         }
     }
     else
     {
         CLI_Write(" Failed to receive data from server.\r\n");
+        bKeepConnection = false;
+        retVal = TCP_RECV_ERROR;
         goto end;
     }
 
     retVal = 0;
 
 end:
-    if(len > sizeof(g_buff) && (dataBuffer != NULL))
-    {
-        free(dataBuffer);
-    }
     return retVal;
 }
 
@@ -535,7 +781,8 @@ end:
  * Function name: ConnectToHTTPServer
  * Inputs: HTTPCli_Handle httpClient
  * Outputs: retVal
- * Description: This function establish a HTTP connection
+ * Description: This function establish a HTTP connection. The IP address of the host is only
+ * looked up if g_DestinationIP is 0. If the connection fails the client is destructed again.
  * Copyright: Copyright (C) 2014 Texas Instruments Incorporated - http://www.ti.com/
  **********************************************************************************************/
 
@@ -553,12 +800,16 @@ static _i32 ConnectToHTTPServer(HTTPCli_Handle httpClient)
     HTTPCli_setProxy((struct sockaddr *)&paddr);
 #endif
 
-    retVal = sl_NetAppDnsGetHostByName(HOST_NAME, pal_Strlen(HOST_NAME),
-                                       &g_DestinationIP, SL_AF_INET);
-    if(retVal < 0)
+    /*the address is looked up once per association with the AP*/
+    if(g_DestinationIP == 0)
     {
-        CLI_Write(" Device couldn't get the IP for the host-name\r\n");
-        ASSERT_ON_ERROR(retVal);
+        retVal = sl_NetAppDnsGetHostByName(HOST_NAME, pal_Strlen(HOST_NAME),
+                                           &g_DestinationIP, SL_AF_INET);
+        if(retVal < 0)
+        {
+            CLI_Write(" Device couldn't get the IP for the host-name\r\n");
+            ASSERT_ON_ERROR(retVal);
+        }
     }
 
     addr.sin_family = AF_INET;
@@ -570,6 +821,7 @@ static _i32 ConnectToHTTPServer(HTTPCli_Handle httpClient)
     if (retVal < 0)
     {
         CLI_Write("Connection to server failed\n\r");
+        HTTPCli_destruct(httpClient);
         ASSERT_ON_ERROR(retVal);
     }
 
@@ -592,7 +844,7 @@ static void FlushHTTPResponse(HTTPCli_Handle httpClient)
                               };
     _i8             buf[128];
     _i32            id;
-    _i32            len = 1;
+    _i32            len;
     bool            moreFlag = 0;
     _i8             **prevRespFilelds = NULL;
 
@@ -607,6 +859,7 @@ static void FlushHTTPResponse(HTTPCli_Handle httpClient)
             if(!strncmp((const char *)buf, "close", sizeof("close")))
             {
                 CLI_Write(" Connection terminated by server\n\r");
+                bKeepConnection = false;
             }
         }
     }
@@ -615,70 +868,23 @@ static void FlushHTTPResponse(HTTPCli_Handle httpClient)
 
     while(1)
     {
-        HTTPCli_readResponseBody(httpClient, (char *)buf, sizeof(buf) - 1, &moreFlag);
-        CLI_Write((_u8 *)buf);
-        CLI_Write("\r\n");
-
-        if ((len - 2) >= 0 && buf[len - 2] == '\r' && buf [len - 1] == '\n')
+        len = HTTPCli_readResponseBody(httpClient, (char *)buf, sizeof(buf) - 1, &moreFlag);
+        if(len < 0)
         {
+            bKeepConnection = false;
+            break;
         }
+        buf[len] = '\0';
+        CLI_Write((_u8 *)buf);
+        CLI_Write("\r\n");
 
-        if(!moreFlag)
+        if(!moreFlag || len == 0)
         {
             break;
         }
     }
 }
 
-/**********************************************************************************************
- * Function name: ParseJSONData
- * Inputs: _i8 *ptr
- * Outputs: retVal
- * Description: This function parse JSON data
- * Copyright: Copyright (C) 2014 Texas Instruments Incorporated - http://www.ti.com/
- **********************************************************************************************/
-
-static _i32 ParseJSONData(_i8 *ptr)
-{
-    _i32            retVal = 0;
-    _i32            noOfToken;
-    jsmn_parser     parser;
-    jsmntok_t       tokenList[3];
-    _i8             printBuffer[4];
-
-    jsmn_init(&parser);
-    noOfToken = jsmn_parse(&parser, (const char *)ptr, strlen((const char *)ptr), NULL, 10);
-    if(noOfToken <= 0)
-    {
-        CLI_Write(" Failed to initialize JSON parser\n\r");
-        return -1;
-
-    }
-    if(tokenList == NULL)
-    {
-        CLI_Write(" Failed to allocate memory\n\r");
-        return -1;
-    }
-    jsmn_init(&parser);
-    noOfToken = jsmn_parse(&parser, (const char *)ptr, strlen((const char *)ptr), tokenList, noOfToken);
-    if(noOfToken < 0)
-    {
-        CLI_Write(" Failed to parse JSON tokens\n\r");
-        retVal = noOfToken;
-    }
-    else
-    {
-        CLI_Write(" Successfully parsed ");
-        sprintf((char *)printBuffer, "%ld", noOfToken);
-        CLI_Write((_u8 *)printBuffer);
-        CLI_Write(" JSON tokens\n\r");
-    }
-
-    free(tokenList);
-
-    return retVal;
-}
-
 /**********************************************************************************************
  * Function name: configureSimpleLinkToDefaultState
  * Outputs: retVal
@@ -776,7 +982,8 @@ static _i32 configureSimpleLinkToDefaultState()
 /**********************************************************************************************
  * Function name: establishConnectionWithAP
  * Outputs: SUCCESS
- * Description: This function connects to the required AP (SSID_NAME).
+ * Description: This function starts the connection to the required AP (SSID_NAME). The
+ * connection manager waits for the connection and IP acquired events.
  * Copyright: Copyright (C) 2014 Texas Instruments Incorporated - http://www.ti.com/
  **********************************************************************************************/
 
@@ -792,9 +999,6 @@ static _i32 establishConnectionWithAP()
     retVal = sl_WlanConnect(SSID_NAME, pal_Strlen(SSID_NAME), 0, &secParams, 0);
     ASSERT_ON_ERROR(retVal);
 
-    /* Wait */
-    while((!IS_CONNECTED(g_Status)) || (!IS_IP_ACQUIRED(g_Status))) { _SlNonOsMainLoopTask(); }
-
     return SUCCESS;
 }
 
@@ -832,10 +1036,12 @@ static void displayBanner()
 
 
 /**********************************************************************************************
- * Function name: ADC0InitAndTrigger
+ * Function name: ADC0Init
  * Description: This function configures the ADC0 module by enabling it and providing clock to
  * the module. It configures Pin PE3 as ADC analog input which is channel 0. Sample sequencer 1
- * is configured and digital value is stored to the variable ui32ADC0DigitalValue.
+ * is configured with one step that ends the sequence and sets the interrupt status, so that
+ * SysTickIntHandler() can see when the conversion it started is done. The conversions are
+ * started and read by SysTickIntHandler(), the digital value is stored to ui32ADC0DigitalValue.
  * Equation to convert the analog value to digital value[8] :
  * digital value =          [Vin - Vref(-)]*[2^N - 1]
  *                      { ---------------------------- + 1/2 }int
@@ -847,22 +1053,19 @@ static void displayBanner()
  * Reference for APIs:TivaWare Peripheral Driver Library User guide
  **********************************************************************************************/
 
-void ADC0InitAndTrigger()
+void ADC0Init()
 {
     /*Enables ADC0 and GPIO port E*/
     SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
 
     /*Configures Pin PE3 as ADC analog input, ADC is triggered from processor trigger, channel 0 is
-     * configured as ADC input, ADC sample sequencer 1 is configured and enabled, starts the
-     * conversion and stores the value to ui32ADC0DigitalValue*/
+     * configured as ADC input, ADC sample sequencer 1 is configured and enabled*/
     GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_3);
     ADCSequenceConfigure(ADC0_BASE, 1, ADC_TRIGGER_PROCESSOR, 0);
-    ADCSequenceStepConfigure(ADC0_BASE, 1, 0, ADC_CTL_CH0);
+    ADCSequenceStepConfigure(ADC0_BASE, 1, 0, ADC_CTL_CH0 | ADC_CTL_IE | ADC_CTL_END);
     ADCSequenceEnable(ADC0_BASE, 1);
-    ADCProcessorTrigger(ADC0_BASE, 1);
-    ADCSequenceDataGet(ADC0_BASE, 1, ui32ADC0DigitalValue);
-    ui32ADCValueStore = ui32ADC0DigitalValue[1];
+    ADCIntClear(ADC0_BASE, 1);
 }
 
 /**********************************************************************************************
@@ -910,3 +1113,156 @@ void TimerInitAndStart(void)
     IntMasterEnable();
     TimerEnable( TIMER0_BASE, TIMER_A );
 }
+
+/**********************************************************************************************
+ * Function name: SysTickIntHandler
+ * Description: This is the interrupt handler for SysTick, registered by SysTickInit(). It counts
+ * the milliseconds since start up in ui32TickCount and samples the pot every
+ * POT_SAMPLE_PERIOD_MS. A sample reads the conversion started by the sample before, which is
+ * done long before the next tick, and starts the next one, so the handler never waits for the
+ * ADC. The value is stored in sPotRing with the tick at which its conversion was started.
+ **********************************************************************************************/
+
+void SysTickIntHandler(void)
+{
+    ui32TickCount++;
+
+    if(ui32TickCount - ui32SampleTick < POT_SAMPLE_PERIOD_MS)
+    {
+        return;
+    }
+    ui32SampleTick += POT_SAMPLE_PERIOD_MS;
+
+    if(bConversionStarted && ADCIntStatus(ADC0_BASE, 1, false))
+    {
+        ADCSequenceDataGet(ADC0_BASE, 1, ui32ADC0DigitalValue);
+        ADCIntClear(ADC0_BASE, 1);
+        PotRingPut(&sPotRing, ui32ConversionTick, ui32ADC0DigitalValue[0]);
+    }
+    ADCProcessorTrigger(ADC0_BASE, 1);
+    ui32ConversionTick = ui32TickCount;
+    bConversionStarted = true;
+}
+
+/**********************************************************************************************
+ * Function name: SysTickInit
+ * Description: SysTick is configured to interrupt TICK_RATE_HZ times per second from the system
+ * clock.
+ * Reference for APIs:TivaWare Peripheral Driver Library User guide
+ **********************************************************************************************/
+
+void SysTickInit(void)
+{
+    SysTickPeriodSet(SysCtlClockGet()/TICK_RATE_HZ);
+    SysTickIntRegister(SysTickIntHandler);
+    SysTickIntEnable();
+    SysTickEnable();
+}
+
+/**********************************************************************************************
+ * Function name: ConnectionClose
+ * Inputs: HTTPCli_Handle httpClient, bool bFailed
+ * Description: This function closes the connection to the server after a failed request or a
+ * response with "Connection: close". The connection manager opens it again at once, or after the
+ * backoff time if bFailed is true. The backoff time doubles with every failure, from
+ * RECONNECT_BACKOFF_MIN_MS to RECONNECT_BACKOFF_MAX_MS.
+ **********************************************************************************************/
+
+void ConnectionClose(HTTPCli_Handle httpClient, bool bFailed)
+{
+    if(eConnectionState == CONNECTION_READY)
+    {
+        HTTPCli_disconnect(httpClient);
+        HTTPCli_destruct(httpClient);
+        eConnectionState = CONNECTION_SERVER;
+    }
+    if(bFailed)
+    {
+        ui32BackoffMs = (ui32BackoffMs == 0) ? RECONNECT_BACKOFF_MIN_MS :
+                        (ui32BackoffMs >= RECONNECT_BACKOFF_MAX_MS/2) ? RECONNECT_BACKOFF_MAX_MS : 2*ui32BackoffMs;
+    }
+    ui32ConnectionTick = ui32TickCount;
+}
+
+/**********************************************************************************************
+ * Function name: ConnectionManagerService
+ * Inputs: HTTPCli_Handle httpClient
+ * Description: This function is called on every pass of the main loop and opens the connections
+ * the uploads need, one step at a time.
+ * CONNECTION_WLAN_IDLE  : after the backoff time sl_WlanConnect() is called.
+ * CONNECTION_WLAN_WAIT  : when the connection and IP acquired events have arrived the server is
+ *                         connected next. Without them after WLAN_CONNECT_TIMEOUT_MS the attempt
+ *                         has failed.
+ * CONNECTION_SERVER     : after the backoff time the HTTP client is connected to the server.
+ * CONNECTION_READY      : nothing to do, the requests use the connection.
+ * A disconnection from the AP (SimpleLinkWlanEventHandler()) in the last two states closes the
+ * HTTP connection and counts as a failure, so the AP is connected again after the backoff time.
+ **********************************************************************************************/
+
+void ConnectionManagerService(HTTPCli_Handle httpClient)
+{
+    uint32_t ui32Now = ui32TickCount;
+    bool bWlanUp = IS_CONNECTED(g_Status) && IS_IP_ACQUIRED(g_Status);
+
+    if((eConnectionState == CONNECTION_SERVER || eConnectionState == CONNECTION_READY) && !bWlanUp)
+    {
+        CLI_Write(" Connection to the AP lost\n\r");
+        ConnectionClose(httpClient, true);
+        g_DestinationIP = 0;
+        eConnectionState = CONNECTION_WLAN_IDLE;
+        return;
+    }
+
+    switch(eConnectionState)
+    {
+    case CONNECTION_WLAN_IDLE:
+        if(ui32Now - ui32ConnectionTick >= ui32BackoffMs)
+        {
+            if(establishConnectionWithAP() < 0)
+            {
+                CLI_Write(" Failed to establish connection w/ an AP \n\r");
+                ConnectionClose(httpClient, true);
+            }
+            else
+            {
+                eConnectionState = CONNECTION_WLAN_WAIT;
+                ui32ConnectionTick = ui32Now;
+            }
+        }
+        break;
+
+    case CONNECTION_WLAN_WAIT:
+        if(bWlanUp)
+        {
+            CLI_Write(" Connection established w/ AP and IP is acquired \n\r");
+            /*the server is connected at once*/
+            eConnectionState = CONNECTION_SERVER;
+            ui32ConnectionTick = ui32Now - ui32BackoffMs;
+        }
+        else if(ui32Now - ui32ConnectionTick >= WLAN_CONNECT_TIMEOUT_MS)
+        {
+            CLI_Write(" Failed to establish connection w/ an AP \n\r");
+            sl_WlanDisconnect();
+            eConnectionState = CONNECTION_WLAN_IDLE;
+            ConnectionClose(httpClient, true);
+        }
+        break;
+
+    case CONNECTION_SERVER:
+        if(ui32Now - ui32ConnectionTick >= ui32BackoffMs)
+        {
+            if(ConnectToHTTPServer(httpClient) < 0)
+            {
+                ConnectionClose(httpClient, true);
+            }
+            else
+            {
+                eConnectionState = CONNECTION_READY;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,176 @@
+/******************************************************************************************************************
+ * File name: potbatch.c
+ * Description : Sample ring and batch request body described in potbatch.h. The functions do not use any peripheral,
+ * so they can also be built on a host computer.
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "potbatch.h"
+
+static bool PotBatchAppend(tPotBatch *psBatch, const char *pcText);
+static bool PotBatchAppendNumber(tPotBatch *psBatch, uint32_t ui32Value);
+
+/***************************************************************************************************************************
+ * Function name : PotRingPut()
+ * Inputs : psRing, ui32Time, ui16Value
+ * Outputs : true if the sample was stored, false if the ring is full
+ * Description : This function is called by the interrupt handler that takes the samples. A sample that does not fit is
+ * counted in ui32Lost, so the oldest samples waiting for the upload are kept.
+ ***************************************************************************************************************************/
+
+bool PotRingPut(tPotRing *psRing, uint32_t ui32Time, uint16_t ui16Value)
+{
+    uint32_t ui32Head = psRing->ui32Head;
+    tPotSample *psSample;
+
+    if(ui32Head - psRing->ui32Tail >= POT_RING_SIZE)
+    {
+        psRing->ui32Lost++;
+        return false;
+    }
+    psSample = &psRing->psSamples[ui32Head & (POT_RING_SIZE - 1)];
+    psSample->ui32Time = ui32Time;
+    psSample->ui16Value = ui16Value;
+    psRing->ui32Head = ui32Head + 1;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotRingCount()
+ * Inputs : psRing
+ * Outputs : number of samples in the ring
+ ***************************************************************************************************************************/
+
+uint32_t PotRingCount(const tPotRing *psRing)
+{
+    return psRing->ui32Head - psRing->ui32Tail;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotRingPeek()
+ * Inputs : psRing, ui32Index
+ * Outputs : sample ui32Index from the oldest one, which must be less than PotRingCount()
+ * Description : The sample stays in the ring until PotRingRemove() removes it.
+ ***************************************************************************************************************************/
+
+const tPotSample *PotRingPeek(const tPotRing *psRing, uint32_t ui32Index)
+{
+    return &psRing->psSamples[(psRing->ui32Tail + ui32Index) & (POT_RING_SIZE - 1)];
+}
+
+/***************************************************************************************************************************
+ * Function name : PotRingRemove()
+ * Inputs : psRing, ui32Count
+ * Outputs : none
+ * Description : This function removes the ui32Count oldest samples, at most PotRingCount(), after they were uploaded.
+ ***************************************************************************************************************************/
+
+void PotRingRemove(tPotRing *psRing, uint32_t ui32Count)
+{
+    psRing->ui32Tail += ui32Count;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotBatchBegin()
+ * Inputs : psBatch, pcBuffer, ui32Size, pcID, ui32Now
+ * Outputs : true if the start of the body fits in pcBuffer
+ * Description : This function starts the body of a request in pcBuffer, which has room for ui32Size characters including
+ * a terminating 0, with the ID of the board and the time ui32Now. The samples are added with PotBatchAdd().
+ ***************************************************************************************************************************/
+
+bool PotBatchBegin(tPotBatch *psBatch, char *pcBuffer, uint32_t ui32Size, const char *pcID, uint32_t ui32Now)
+{
+    psBatch->pcBuffer = pcBuffer;
+    psBatch->ui32Size = ui32Size;
+    psBatch->ui32Length = 0;
+    psBatch->ui32Samples = 0;
+    psBatch->ui32LastTime = 0;
+
+    return PotBatchAppend(psBatch, "func=save&ID=") && PotBatchAppend(psBatch, pcID) &&
+           PotBatchAppend(psBatch, "&NOW=") && PotBatchAppendNumber(psBatch, ui32Now) &&
+           PotBatchAppend(psBatch, "&POT=");
+}
+
+/***************************************************************************************************************************
+ * Function name : PotBatchAdd()
+ * Inputs : psBatch, ui32Time, ui16Value
+ * Outputs : true if the sample was added, false if it does not fit
+ * Description : This function appends the time and the value of a sample, scaled from 12 to 8 bits, to the body. A sample
+ * that does not fit leaves the body unchanged.
+ ***************************************************************************************************************************/
+
+bool PotBatchAdd(tPotBatch *psBatch, uint32_t ui32Time, uint16_t ui16Value)
+{
+    uint32_t ui32Length = psBatch->ui32Length;
+    uint32_t ui32Delta = (psBatch->ui32Samples == 0) ? ui32Time : ui32Time - psBatch->ui32LastTime;
+
+    if(!((psBatch->ui32Samples == 0 || PotBatchAppend(psBatch, ",")) && PotBatchAppendNumber(psBatch, ui32Delta) &&
+         PotBatchAppend(psBatch, ":") && PotBatchAppendNumber(psBatch, ui16Value/16)))
+    {
+        psBatch->ui32Length = ui32Length;
+        psBatch->pcBuffer[ui32Length] = 0;
+        return false;
+    }
+    psBatch->ui32Samples++;
+    psBatch->ui32LastTime = ui32Time;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotBatchEnd()
+ * Inputs : psBatch
+ * Outputs : length of the body without the terminating 0
+ ***************************************************************************************************************************/
+
+uint32_t PotBatchEnd(tPotBatch *psBatch)
+{
+    psBatch->pcBuffer[psBatch->ui32Length] = 0;
+    return psBatch->ui32Length;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotBatchAppend()
+ * Inputs : psBatch, pcText
+ * Outputs : true if pcText fits
+ * Description : This function appends pcText to the body if there is room for it and a terminating 0.
+ ***************************************************************************************************************************/
+
+static bool PotBatchAppend(tPotBatch *psBatch, const char *pcText)
+{
+    uint32_t ui32Length = psBatch->ui32Length;
+
+    while(*pcText != 0)
+    {
+        if(ui32Length + 1 >= psBatch->ui32Size)
+        {
+            return false;
+        }
+        psBatch->pcBuffer[ui32Length++] = *pcText++;
+    }
+    psBatch->ui32Length = ui32Length;
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotBatchAppendNumber()
+ * Inputs : psBatch, ui32Value
+ * Outputs : true if the number fits
+ * Description : This function appends ui32Value in decimal digits like PotBatchAppend().
+ ***************************************************************************************************************************/
+
+static bool PotBatchAppendNumber(tPotBatch *psBatch, uint32_t ui32Value)
+{
+    /*digits of the value from the last one, at most 10 digits and the terminating 0*/
+    char pcDigits[11];
+    uint32_t ui32Digit = sizeof(pcDigits) - 1;
+
+    pcDigits[ui32Digit] = 0;
+    do
+    {
+        pcDigits[--ui32Digit] = '0' + ui32Value%10;
+        ui32Value /= 10;
+    } while(ui32Value != 0);
+
+    return PotBatchAppend(psBatch, &pcDigits[ui32Digit]);
+}
@@ -0,0 +1,64 @@
+/******************************************************************************************************************
+ * File name: potbatch.h
+ * Description : Ring of time stamped POT samples and the body of the request that uploads many of them at once.
+ *
+ * The samples are taken by an interrupt handler at POT_SAMPLE_PERIOD_MS (main.c) and stored in a tPotRing with the
+ * time of the sample in milliseconds since start up. The main loop takes the oldest samples of the ring, writes them to
+ * the body of one POST request and removes them from the ring only when the server has answered, so no sample is lost
+ * when a request fails.
+ *
+ * Body of the request (application/x-www-form-urlencoded):
+ *   func=save&ID=<id>&NOW=<ms>&POT=<ms>:<value>,<ms>:<value>,...
+ * NOW is the time the body was written. The first <ms> of POT is the time of the first sample and every further <ms>
+ * the time since the sample before it. The values are the POT value scaled to 0-255, like the single value of the GET
+ * request used before. The server gets the wall clock time of a sample as its own time minus (NOW - time of sample).
+ * At a sample period of 100ms a sample takes 8 bytes ("100:201,"), so the 1460 bytes of g_buff hold more than 170
+ * samples. PotBatchAdd() refuses a sample that does not fit, and the sample stays in the ring for the next request.
+ *********************************************************************************************************************/
+
+#ifndef POTBATCH_H_
+#define POTBATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Number of samples the ring holds. Must be a power of two*/
+#define POT_RING_SIZE       256
+
+/*One sample: time in ms since start up and 12 bit digital value*/
+typedef struct
+{
+    uint32_t ui32Time;
+    uint16_t ui16Value;
+} tPotSample;
+
+/*Single producer, single consumer ring. ui32Head and ui32Tail count the samples written and removed since start up and
+ * wrap around at 2^32, the index into psSamples is the count modulo POT_RING_SIZE. ui32Lost counts the samples that did
+ * not fit*/
+typedef struct
+{
+    tPotSample psSamples[POT_RING_SIZE];
+    volatile uint32_t ui32Head;
+    volatile uint32_t ui32Tail;
+    uint32_t ui32Lost;
+} tPotRing;
+
+/*Body of a request being written*/
+typedef struct
+{
+    char *pcBuffer;
+    uint32_t ui32Size;
+    uint32_t ui32Length;
+    uint32_t ui32Samples;
+    uint32_t ui32LastTime;
+} tPotBatch;
+
+bool PotRingPut(tPotRing *psRing, uint32_t ui32Time, uint16_t ui16Value);
+uint32_t PotRingCount(const tPotRing *psRing);
+const tPotSample *PotRingPeek(const tPotRing *psRing, uint32_t ui32Index);
+void PotRingRemove(tPotRing *psRing, uint32_t ui32Count);
+bool PotBatchBegin(tPotBatch *psBatch, char *pcBuffer, uint32_t ui32Size, const char *pcID, uint32_t ui32Now);
+bool PotBatchAdd(tPotBatch *psBatch, uint32_t ui32Time, uint16_t ui16Value);
+uint32_t PotBatchEnd(tPotBatch *psBatch);
+
+#endif /* POTBATCH_H_ */
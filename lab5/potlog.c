@@ -0,0 +1,411 @@
+/******************************************************************************************************************
+ * File name: potlog.c
+ * Description : Log of POT samples on the serial flash of the CC3100 described in potlog.h. The functions only use the
+ * sl_Fs functions of the SimpleLink host driver, so with host/sl_fs_host.c they can also be built on a host computer.
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "simplelink.h"
+#include "potbatch.h"
+#include "potlog.h"
+
+static void PotLogResume(tPotLog *psLog);
+static int32_t PotLogOpenSegment(tPotLog *psLog);
+static int32_t PotLogCloseSegment(tPotLog *psLog);
+static void PotLogDropOldest(tPotLog *psLog);
+static bool PotLogRead(tPotLog *psLog, tPotBatch *psBatch, uint32_t *pui32Added);
+static const _u8 *PotLogName(uint32_t ui32Slot);
+
+/*Records of one sl_FsRead() or sl_FsWrite()*/
+static _u8 pui8PotLogChunk[POT_LOG_CHUNK_SAMPLES*POT_LOG_RECORD_BYTES];
+
+/***************************************************************************************************************************
+ * Function name : PotLogInit()
+ * Inputs : psLog
+ * Outputs : none
+ * Description : This function empties the log. The segment files are not touched until they are needed, so it can be
+ * called before sl_Start().
+ ***************************************************************************************************************************/
+
+void PotLogInit(tPotLog *psLog)
+{
+    uint32_t ui32Slot;
+
+    for(ui32Slot = 0; ui32Slot < POT_LOG_SEGMENTS; ui32Slot++)
+    {
+        psLog->pui32Count[ui32Slot] = 0;
+        psLog->pui32Erases[ui32Slot] = 0;
+    }
+    psLog->ui32First = 0;
+    psLog->ui32Segments = 0;
+    psLog->ui32ReadIndex = 0;
+    psLog->ui32Samples = 0;
+    psLog->i32WriteHandle = -1;
+    psLog->ui32WriteSlot = 0;
+    psLog->ui32Sequence = 0;
+    psLog->bResumed = false;
+    psLog->ui32Lost = 0;
+    psLog->ui32Errors = 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogCount()
+ * Inputs : psLog
+ * Outputs : number of samples in the log
+ ***************************************************************************************************************************/
+
+uint32_t PotLogCount(const tPotLog *psLog)
+{
+    return psLog->ui32Samples;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogAppend()
+ * Inputs : psLog, psRing, ui32Count
+ * Outputs : number of samples moved, negative error code of the sl_Fs function that failed
+ * Description : This function moves the ui32Count oldest samples of psRing, at most all of them, to the end of the log.
+ * A sample is only removed from the ring when it has been written. After a failed write the segment is closed, so the
+ * next call starts a new one.
+ ***************************************************************************************************************************/
+
+int32_t PotLogAppend(tPotLog *psLog, tPotRing *psRing, uint32_t ui32Count)
+{
+    const tPotSample *psSample;
+    uint32_t ui32Moved = 0, ui32Chunk, ui32Index, ui32Slot;
+    _u8 *pui8Record;
+    int32_t i32Result;
+
+    if(ui32Count > PotRingCount(psRing))
+    {
+        ui32Count = PotRingCount(psRing);
+    }
+
+    while(ui32Moved < ui32Count)
+    {
+        if(psLog->i32WriteHandle < 0)
+        {
+            i32Result = PotLogOpenSegment(psLog);
+            if(i32Result < 0)
+            {
+                return i32Result;
+            }
+        }
+        ui32Slot = psLog->ui32WriteSlot;
+
+        /*as many samples as fit in the chunk and in the segment*/
+        ui32Chunk = ui32Count - ui32Moved;
+        if(ui32Chunk > POT_LOG_CHUNK_SAMPLES)
+        {
+            ui32Chunk = POT_LOG_CHUNK_SAMPLES;
+        }
+        if(ui32Chunk > POT_LOG_SEGMENT_SAMPLES - psLog->pui32Count[ui32Slot])
+        {
+            ui32Chunk = POT_LOG_SEGMENT_SAMPLES - psLog->pui32Count[ui32Slot];
+        }
+
+        pui8Record = pui8PotLogChunk;
+        for(ui32Index = 0; ui32Index < ui32Chunk; ui32Index++)
+        {
+            psSample = PotRingPeek(psRing, ui32Index);
+            *pui8Record++ = psSample->ui32Time;
+            *pui8Record++ = psSample->ui32Time >> 8;
+            *pui8Record++ = psSample->ui32Time >> 16;
+            *pui8Record++ = psSample->ui32Time >> 24;
+            *pui8Record++ = psSample->ui16Value;
+            *pui8Record++ = psSample->ui16Value >> 8;
+        }
+
+        i32Result = sl_FsWrite(psLog->i32WriteHandle,
+                               POT_LOG_HEADER_BYTES + psLog->pui32Count[ui32Slot]*POT_LOG_RECORD_BYTES,
+                               pui8PotLogChunk, ui32Chunk*POT_LOG_RECORD_BYTES);
+        if(i32Result != (int32_t)(ui32Chunk*POT_LOG_RECORD_BYTES))
+        {
+            psLog->ui32Errors++;
+            PotLogCloseSegment(psLog);
+            return (i32Result < 0) ? i32Result : -1;
+        }
+
+        PotRingRemove(psRing, ui32Chunk);
+        psLog->pui32Count[ui32Slot] += ui32Chunk;
+        psLog->ui32Samples += ui32Chunk;
+        ui32Moved += ui32Chunk;
+
+        if(psLog->pui32Count[ui32Slot] == POT_LOG_SEGMENT_SAMPLES)
+        {
+            PotLogCloseSegment(psLog);
+        }
+    }
+    return ui32Moved;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogFill()
+ * Inputs : psLog, psBatch
+ * Outputs : number of samples added to psBatch
+ * Description : This function adds the oldest samples of the log to psBatch until the batch is full or the log has no
+ * more samples. An open segment is closed first, so that it can be read. The samples stay in the log until
+ * PotLogRemove() removes them. The samples of a segment that cannot be read are counted as lost and dropped.
+ ***************************************************************************************************************************/
+
+uint32_t PotLogFill(tPotLog *psLog, tPotBatch *psBatch)
+{
+    uint32_t ui32Added;
+
+    if(psLog->i32WriteHandle >= 0)
+    {
+        PotLogCloseSegment(psLog);
+    }
+
+    while(!PotLogRead(psLog, psBatch, &ui32Added))
+    {
+        /*samples of the segments before the one that failed are sent first, the next call fails at the start of it*/
+        if(ui32Added != 0)
+        {
+            break;
+        }
+        PotLogDropOldest(psLog);
+    }
+    return ui32Added;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogRemove()
+ * Inputs : psLog, ui32Count
+ * Outputs : none
+ * Description : This function removes the ui32Count oldest samples, at most the ones PotLogFill() added to the last
+ * batch, after they were uploaded. A segment whose samples are all removed is free for new samples.
+ ***************************************************************************************************************************/
+
+void PotLogRemove(tPotLog *psLog, uint32_t ui32Count)
+{
+    psLog->ui32Samples -= ui32Count;
+    psLog->ui32ReadIndex += ui32Count;
+    while(psLog->ui32Segments != 0 && psLog->ui32ReadIndex >= psLog->pui32Count[psLog->ui32First])
+    {
+        psLog->ui32ReadIndex -= psLog->pui32Count[psLog->ui32First];
+        psLog->pui32Count[psLog->ui32First] = 0;
+        psLog->ui32First = (psLog->ui32First + 1) % POT_LOG_SEGMENTS;
+        psLog->ui32Segments--;
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogResume()
+ * Inputs : psLog
+ * Outputs : none
+ * Description : This function reads the sequence numbers of the segments written before the last reset and makes the
+ * segment after the one with the highest number the first one to be written. It is called before the first segment is
+ * opened for writing after start up, when the log is still empty. Segments that do not exist or cannot be read are
+ * skipped.
+ ***************************************************************************************************************************/
+
+static void PotLogResume(tPotLog *psLog)
+{
+    uint32_t ui32Slot, ui32Sequence;
+    _i32 i32Handle;
+
+    psLog->bResumed = true;
+    for(ui32Slot = 0; ui32Slot < POT_LOG_SEGMENTS; ui32Slot++)
+    {
+        if(sl_FsOpen(PotLogName(ui32Slot), FS_MODE_OPEN_READ, NULL, &i32Handle) < 0)
+        {
+            continue;
+        }
+        if(sl_FsRead(i32Handle, 0, pui8PotLogChunk, POT_LOG_HEADER_BYTES) == POT_LOG_HEADER_BYTES)
+        {
+            ui32Sequence = (uint32_t)pui8PotLogChunk[0] | ((uint32_t)pui8PotLogChunk[1] << 8) |
+                           ((uint32_t)pui8PotLogChunk[2] << 16) | ((uint32_t)pui8PotLogChunk[3] << 24);
+            if(ui32Sequence > psLog->ui32Sequence)
+            {
+                psLog->ui32Sequence = ui32Sequence;
+                psLog->ui32First = (ui32Slot + 1) % POT_LOG_SEGMENTS;
+            }
+        }
+        sl_FsClose(i32Handle, NULL, NULL, 0);
+    }
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogOpenSegment()
+ * Inputs : psLog
+ * Outputs : 0, negative error code of sl_FsOpen() or sl_FsWrite()
+ * Description : This function opens the segment after the last closed one for writing, which erases it, and writes the
+ * next sequence number to its start. If all segments are in use the oldest one is dropped first. A segment file that
+ * does not exist yet is created.
+ ***************************************************************************************************************************/
+
+static int32_t PotLogOpenSegment(tPotLog *psLog)
+{
+    const _u8 *pui8Name;
+    _u8 pui8Header[POT_LOG_HEADER_BYTES];
+    _i32 i32Handle;
+    _i32 i32Result;
+
+    if(!psLog->bResumed)
+    {
+        PotLogResume(psLog);
+    }
+    if(psLog->ui32Segments == POT_LOG_SEGMENTS)
+    {
+        PotLogDropOldest(psLog);
+    }
+    psLog->ui32WriteSlot = (psLog->ui32First + psLog->ui32Segments) % POT_LOG_SEGMENTS;
+    psLog->pui32Count[psLog->ui32WriteSlot] = 0;
+    pui8Name = PotLogName(psLog->ui32WriteSlot);
+
+    i32Result = sl_FsOpen(pui8Name, FS_MODE_OPEN_WRITE, NULL, &i32Handle);
+    if(i32Result < 0)
+    {
+        i32Result = sl_FsOpen(pui8Name, FS_MODE_OPEN_CREATE(POT_LOG_SEGMENT_BYTES, 0), NULL, &i32Handle);
+    }
+    if(i32Result < 0)
+    {
+        psLog->ui32Errors++;
+        return i32Result;
+    }
+    psLog->pui32Erases[psLog->ui32WriteSlot]++;
+
+    pui8Header[0] = psLog->ui32Sequence + 1;
+    pui8Header[1] = (psLog->ui32Sequence + 1) >> 8;
+    pui8Header[2] = (psLog->ui32Sequence + 1) >> 16;
+    pui8Header[3] = (psLog->ui32Sequence + 1) >> 24;
+    i32Result = sl_FsWrite(i32Handle, 0, pui8Header, POT_LOG_HEADER_BYTES);
+    if(i32Result != POT_LOG_HEADER_BYTES)
+    {
+        psLog->ui32Errors++;
+        sl_FsClose(i32Handle, NULL, NULL, 0);
+        return (i32Result < 0) ? i32Result : -1;
+    }
+    psLog->ui32Sequence++;
+    psLog->i32WriteHandle = i32Handle;
+    return 0;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogCloseSegment()
+ * Inputs : psLog
+ * Outputs : 0, negative error code of sl_FsClose()
+ * Description : This function closes the open segment, which makes its samples readable. A segment without samples is
+ * not added to the log.
+ ***************************************************************************************************************************/
+
+static int32_t PotLogCloseSegment(tPotLog *psLog)
+{
+    int32_t i32Result;
+
+    i32Result = sl_FsClose(psLog->i32WriteHandle, NULL, NULL, 0);
+    psLog->i32WriteHandle = -1;
+    if(i32Result < 0)
+    {
+        psLog->ui32Errors++;
+    }
+    if(psLog->pui32Count[psLog->ui32WriteSlot] != 0)
+    {
+        psLog->ui32Segments++;
+    }
+    return i32Result;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogDropOldest()
+ * Inputs : psLog
+ * Outputs : none
+ * Description : This function drops the samples of the oldest closed segment that have not been uploaded and counts
+ * them as lost.
+ ***************************************************************************************************************************/
+
+static void PotLogDropOldest(tPotLog *psLog)
+{
+    uint32_t ui32Dropped;
+
+    if(psLog->ui32Segments == 0)
+    {
+        return;
+    }
+    ui32Dropped = psLog->pui32Count[psLog->ui32First] - psLog->ui32ReadIndex;
+    psLog->ui32Lost += ui32Dropped;
+    PotLogRemove(psLog, ui32Dropped);
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogRead()
+ * Inputs : psLog, psBatch, pui32Added
+ * Outputs : false if a segment could not be read, *pui32Added the number of samples added to psBatch
+ * Description : This function reads the closed segments from the oldest sample that has not been uploaded on, a chunk
+ * at a time, and adds the samples to psBatch until it is full.
+ ***************************************************************************************************************************/
+
+static bool PotLogRead(tPotLog *psLog, tPotBatch *psBatch, uint32_t *pui32Added)
+{
+    const _u8 *pui8Record;
+    uint32_t ui32Segment, ui32Slot, ui32Index, ui32Chunk, ui32Sample, ui32Time;
+    uint16_t ui16Value;
+    _i32 i32Handle;
+    _i32 i32Result;
+    bool bFull = false;
+
+    *pui32Added = 0;
+    ui32Index = psLog->ui32ReadIndex;
+    for(ui32Segment = 0; ui32Segment < psLog->ui32Segments && !bFull; ui32Segment++)
+    {
+        ui32Slot = (psLog->ui32First + ui32Segment) % POT_LOG_SEGMENTS;
+        if(sl_FsOpen(PotLogName(ui32Slot), FS_MODE_OPEN_READ, NULL, &i32Handle) < 0)
+        {
+            psLog->ui32Errors++;
+            return false;
+        }
+
+        while(ui32Index < psLog->pui32Count[ui32Slot] && !bFull)
+        {
+            ui32Chunk = psLog->pui32Count[ui32Slot] - ui32Index;
+            if(ui32Chunk > POT_LOG_CHUNK_SAMPLES)
+            {
+                ui32Chunk = POT_LOG_CHUNK_SAMPLES;
+            }
+            i32Result = sl_FsRead(i32Handle, POT_LOG_HEADER_BYTES + ui32Index*POT_LOG_RECORD_BYTES, pui8PotLogChunk,
+                                  ui32Chunk*POT_LOG_RECORD_BYTES);
+            if(i32Result != (_i32)(ui32Chunk*POT_LOG_RECORD_BYTES))
+            {
+                psLog->ui32Errors++;
+                sl_FsClose(i32Handle, NULL, NULL, 0);
+                return false;
+            }
+
+            pui8Record = pui8PotLogChunk;
+            for(ui32Sample = 0; ui32Sample < ui32Chunk; ui32Sample++)
+            {
+                ui32Time = (uint32_t)pui8Record[0] | ((uint32_t)pui8Record[1] << 8) |
+                           ((uint32_t)pui8Record[2] << 16) | ((uint32_t)pui8Record[3] << 24);
+                ui16Value = (uint16_t)(pui8Record[4] | (pui8Record[5] << 8));
+                pui8Record += POT_LOG_RECORD_BYTES;
+                if(!PotBatchAdd(psBatch, ui32Time, ui16Value))
+                {
+                    bFull = true;
+                    break;
+                }
+                (*pui32Added)++;
+            }
+            ui32Index += ui32Sample;
+        }
+        sl_FsClose(i32Handle, NULL, NULL, 0);
+        ui32Index = 0;
+    }
+    return true;
+}
+
+/***************************************************************************************************************************
+ * Function name : PotLogName()
+ * Inputs : ui32Slot
+ * Outputs : name of the segment file ui32Slot
+ * Description : The name is kept in a static buffer until the next call.
+ ***************************************************************************************************************************/
+
+static const _u8 *PotLogName(uint32_t ui32Slot)
+{
+    static _u8 pui8Name[] = "/potlog/00";
+
+    pui8Name[8] = '0' + ui32Slot/10;
+    pui8Name[9] = '0' + ui32Slot%10;
+    return pui8Name;
+}
@@ -0,0 +1,69 @@
+/******************************************************************************************************************
+ * File name: potlog.h
+ * Description : Log of POT samples on the serial flash of the CC3100, used while the samples cannot be uploaded.
+ *
+ * The ring of potbatch.h holds 256 samples, 25.6 seconds at a sample period of 100ms. When the AP or the server is down
+ * for longer, main.c moves the samples of the ring to this log, which holds POT_LOG_SEGMENTS*POT_LOG_SEGMENT_SAMPLES
+ * samples, more than half an hour. When the connection is back the log is sent first, in batches that fill g_buff, and
+ * the samples of the ring follow, so the server gets the samples in the order they were taken.
+ *
+ * The log is a ring of POT_LOG_SEGMENTS files "/potlog/00", "/potlog/01", ... of POT_LOG_SEGMENT_BYTES, written and
+ * read with the sl_Fs functions of the SimpleLink host driver. A segment starts with a sequence number of
+ * POT_LOG_HEADER_BYTES, low byte first, that counts the segments written, and a sample takes POT_LOG_RECORD_BYTES:
+ * time, low byte first, and value. The CC3100 erases a file when it is opened for writing, so a segment is opened for
+ * writing once, filled by as many PotLogAppend() calls as it takes and closed when it is full or when it has to be read.
+ * The segments are used in turn, and the flash is only written while the samples cannot be uploaded. When all segments
+ * are full the oldest one is reused and its samples are counted as lost. The files are created the first time they are
+ * used and never deleted.
+ *
+ * The turn is kept over a reset without writing anything else to the flash: before the first segment is written after
+ * a reset, the sequence numbers of all segments are read and writing goes on with the segment after the one with the
+ * highest number. So the segments are erased in turn also when the board is reset between short outages, instead of
+ * /potlog/00 first after every reset.
+ *
+ * The times of the samples count from start up, because the board has no clock that keeps the time over a reset, so
+ * the log starts empty after a reset. It adds capacity to the ring, it does not keep samples over a reset.
+ *********************************************************************************************************************/
+
+#ifndef POTLOG_H_
+#define POTLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "potbatch.h"
+
+/*Number of segment files and size of a file. A segment holds POT_LOG_SEGMENT_SAMPLES samples*/
+#define POT_LOG_SEGMENTS            32
+#define POT_LOG_SEGMENT_BYTES       4096
+#define POT_LOG_HEADER_BYTES        4
+#define POT_LOG_RECORD_BYTES        6
+#define POT_LOG_SEGMENT_SAMPLES     ((POT_LOG_SEGMENT_BYTES - POT_LOG_HEADER_BYTES)/POT_LOG_RECORD_BYTES)
+
+/*Samples read or written with one sl_FsRead() or sl_FsWrite()*/
+#define POT_LOG_CHUNK_SAMPLES       32
+
+/*State of the log. The segments in use are the ui32Segments closed ones from ui32First on and the open one,
+ * ui32WriteSlot, if i32WriteHandle is not negative*/
+typedef struct
+{
+    uint32_t pui32Count[POT_LOG_SEGMENTS];  /*samples in each segment*/
+    uint32_t pui32Erases[POT_LOG_SEGMENTS]; /*times each segment was opened for writing since start up, for statistics*/
+    uint32_t ui32First;                     /*oldest closed segment*/
+    uint32_t ui32Segments;                  /*closed segments*/
+    uint32_t ui32ReadIndex;                 /*samples of the oldest segment already uploaded*/
+    uint32_t ui32Samples;                   /*samples in the log*/
+    int32_t i32WriteHandle;                 /*open segment, negative if none*/
+    uint32_t ui32WriteSlot;
+    uint32_t ui32Sequence;                  /*sequence number of the last segment opened for writing*/
+    bool bResumed;                          /*true once the sequence numbers have been read after start up*/
+    uint32_t ui32Lost;                      /*samples lost because all segments were full or could not be read*/
+    uint32_t ui32Errors;                    /*sl_Fs calls that failed*/
+} tPotLog;
+
+void PotLogInit(tPotLog *psLog);
+uint32_t PotLogCount(const tPotLog *psLog);
+int32_t PotLogAppend(tPotLog *psLog, tPotRing *psRing, uint32_t ui32Count);
+uint32_t PotLogFill(tPotLog *psLog, tPotBatch *psBatch);
+void PotLogRemove(tPotLog *psLog, uint32_t ui32Count);
+
+#endif /* POTLOG_H_ */